@@ -0,0 +1,60 @@
+# Precompressed, fingerprinted static resources
+#
+# This is part of the XGL software project.
+#
+# Copyright (C) 2021  IO Industrial Holdings, LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# The resources/ tree is copied to ${CMAKE_BINARY_DIR}/assets/<version>/,
+# where <version> is a hash of the whole tree, with gzip (and brotli, when
+# the tool is installed) variants of the text files next to each one.  The
+# web UI serves them from /assets/<version>/ with immutable cache headers
+# (see StaticAssetResource).  The fingerprint is on the directory rather
+# than each file name so the relative url()s inside the stylesheets keep
+# working.
+#
+# wt_config.xml is generated alongside, pointing Wt's resourcesURL at the
+# fingerprinted tree:
+#
+# usage: source/webui/XGL.wt -c wt_config.xml --docroot .. ...
+#
+find_program(GZIP_EXECUTABLE gzip)
+find_program(BROTLI_EXECUTABLE brotli)
+
+if (NOT GZIP_EXECUTABLE)
+    message(WARNING "No gzip found. Static resources will be served uncompressed.")
+endif()
+
+file(GLOB_RECURSE ASSET_SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/resources/*)
+set(ASSET_OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/assets)
+set(ASSET_MANIFEST ${ASSET_OUTPUT_DIR}/assets.manifest)
+
+add_custom_command(
+    OUTPUT ${ASSET_MANIFEST} ${CMAKE_CURRENT_BINARY_DIR}/wt_config.xml
+    COMMAND ${CMAKE_COMMAND}
+        -DSOURCE_DIR=${CMAKE_CURRENT_SOURCE_DIR}/resources
+        -DOUTPUT_DIR=${ASSET_OUTPUT_DIR}
+        -DGZIP_EXECUTABLE=${GZIP_EXECUTABLE}
+        -DBROTLI_EXECUTABLE=${BROTLI_EXECUTABLE}
+        -DCONFIG_IN=${CMAKE_CURRENT_SOURCE_DIR}/templates/wt_config.xml.in
+        -DCONFIG_OUT=${CMAKE_CURRENT_BINARY_DIR}/wt_config.xml
+        -P ${CMAKE_CURRENT_SOURCE_DIR}/cmake/precompress.cmake
+    DEPENDS ${ASSET_SOURCES}
+        ${CMAKE_CURRENT_SOURCE_DIR}/cmake/precompress.cmake
+        ${CMAKE_CURRENT_SOURCE_DIR}/templates/wt_config.xml.in
+    COMMENT "Precompressing static resources"
+    VERBATIM)
+
+add_custom_target(assets ALL DEPENDS ${ASSET_MANIFEST})
@@ -0,0 +1,95 @@
+# Precompress and fingerprint static resources
+#
+# This is part of the XGL software project.
+#
+# Copyright (C) 2021  IO Industrial Holdings, LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Script mode; see assets.cmake.
+#
+# usage: cmake -DSOURCE_DIR=<resources> -DOUTPUT_DIR=<assets>
+#              [-DGZIP_EXECUTABLE=<gzip>] [-DBROTLI_EXECUTABLE=<brotli>]
+#              [-DCONFIG_IN=<wt_config.xml.in> -DCONFIG_OUT=<wt_config.xml>]
+#              -P precompress.cmake
+#
+# Writes OUTPUT_DIR/assets.manifest:
+#
+#   version <version>
+#   <path> <sha1> <gzip 0|1> <brotli 0|1>
+#   ...
+
+# Already compressed formats gain nothing from another pass.
+set(COMPRESSIBLE_EXTENSIONS .css .js .svg .ttf .otf .eot .map .less .html .txt .swf)
+
+file(GLOB_RECURSE FILES RELATIVE ${SOURCE_DIR} ${SOURCE_DIR}/*)
+list(SORT FILES)
+
+# The version is a hash over every file's path and content hash.
+set(ENTRIES "")
+set(ALL_HASHES "")
+foreach(FILE ${FILES})
+    file(SHA1 ${SOURCE_DIR}/${FILE} HASH)
+    list(APPEND ENTRIES "${FILE}|${HASH}")
+    string(APPEND ALL_HASHES "${FILE}${HASH}")
+endforeach()
+string(SHA1 VERSION "${ALL_HASHES}")
+string(SUBSTRING ${VERSION} 0 12 VERSION)
+
+file(REMOVE_RECURSE ${OUTPUT_DIR})
+set(TARGET_DIR ${OUTPUT_DIR}/${VERSION})
+set(MANIFEST "version ${VERSION}\n")
+
+foreach(ENTRY ${ENTRIES})
+    string(REPLACE "|" ";" ENTRY ${ENTRY})
+    list(GET ENTRY 0 FILE)
+    list(GET ENTRY 1 HASH)
+
+    get_filename_component(DIR ${TARGET_DIR}/${FILE} DIRECTORY)
+    file(COPY ${SOURCE_DIR}/${FILE} DESTINATION ${DIR})
+
+    set(HAS_GZIP 0)
+    set(HAS_BROTLI 0)
+    get_filename_component(EXT ${FILE} EXT)
+    string(REGEX REPLACE "^.*(\\.[^.]*)$" "\\1" EXT "${EXT}")
+    string(TOLOWER "${EXT}" EXT)
+    list(FIND COMPRESSIBLE_EXTENSIONS "${EXT}" COMPRESSIBLE)
+
+    if (NOT COMPRESSIBLE EQUAL -1)
+        if (GZIP_EXECUTABLE)
+            execute_process(COMMAND ${GZIP_EXECUTABLE} -9 -n -c ${SOURCE_DIR}/${FILE}
+                            OUTPUT_FILE ${TARGET_DIR}/${FILE}.gz
+                            RESULT_VARIABLE RESULT)
+            if (RESULT EQUAL 0)
+                set(HAS_GZIP 1)
+            endif()
+        endif()
+        if (BROTLI_EXECUTABLE)
+            execute_process(COMMAND ${BROTLI_EXECUTABLE} -q 11 -f -o ${TARGET_DIR}/${FILE}.br ${SOURCE_DIR}/${FILE}
+                            RESULT_VARIABLE RESULT)
+            if (RESULT EQUAL 0)
+                set(HAS_BROTLI 1)
+            endif()
+        endif()
+    endif()
+
+    string(APPEND MANIFEST "${FILE} ${HASH} ${HAS_GZIP} ${HAS_BROTLI}\n")
+endforeach()
+
+file(WRITE ${OUTPUT_DIR}/assets.manifest "${MANIFEST}")
+
+if (CONFIG_IN AND CONFIG_OUT)
+    set(ASSET_VERSION ${VERSION})
+    configure_file(${CONFIG_IN} ${CONFIG_OUT} @ONLY)
+endif()
@@ -16,11 +16,653 @@
 //! You should have received a copy of the GNU General Public License
 //! along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <Wt/Dbo/Transaction.h>
+
 #include "XGLVersion.h"
+#include "accounting/ChangeFeed.h"
+#include "accounting/Date.h"
+#include "accounting/ledger/ChartOfAccounts.h"
+#include "accounting/ledger/Reconciliation.h"
+#include "accounting/ledger/Revaluation.h"
+#include "accounting/payroll/TaxReport.h"
+#include "db/Account.h"
+#include "db/ChangeLog.h"
+#include "db/ExchangeRate.h"
+#include "db/JournalEntry.h"
+#include "db/Paycheck.h"
+#include "db/PeriodClose.h"
+#include "db/ShardRouter.h"
 
-int main(int argc, char **argv)
+using namespace accounting::payroll;
+
+static void usage()
+{
+    printf("usage: xgl [command] [options]\n"
+           "\n"
+           "commands:\n"
+           "  report --data <dir> --company <id> --year <yyyy> [--form 941|940] [--threads <n>]\n"
+           "      Print the quarterly 941 and annual 940 payroll tax totals.\n"
+           "  reconcile --data <dir> --company <id> --account <id> --statement <csv>\n"
+           "            [--days <n>] [--threads <n>]\n"
+           "      Match a bank statement (yyyy-mm-dd,amount,reference lines) against\n"
+           "      the account's journal lines, allowing <n> days (default 3) of\n"
+           "      clearing delay, and list what is left unmatched.  Exits with 2 if\n"
+           "      anything is.\n"
+           "  rates --data <dir> --company <id> --file <csv>\n"
+           "      Load daily exchange rates (currency,yyyy-mm-dd,USD per unit lines).\n"
+           "  revalue --data <dir> --company <id> --date <yyyy-mm-dd> --account <id> [--dry-run]\n"
+           "      Restate foreign currency balances at the rates for <date> and post\n"
+           "      the unrealized exchange gain or loss against <account>.\n"
+           "  accounts --data <dir> --company <id> --file <csv>\n"
+           "      Load the chart of accounts (id,parent id or 0,number,name lines).\n"
+           "  balances --data <dir> --company <id> --date <yyyy-mm-dd> [--depth <n>]\n"
+           "      Print every account's balance as of <date>, rolled up the chart of\n"
+           "      accounts, down to <n> levels.\n"
+           "  close --data <dir> --company <id> --year <yyyy>\n"
+           "      Close the books through the end of <yyyy>: move its journal and\n"
+           "      payroll history out of the database into a compressed archive.\n"
+           "      Reports still read it; nothing more can be posted to it.\n"
+           "  export --data <dir> --company <id> [--since <seq>] [--format ndjson|binary]\n"
+           "         [--out <file>]\n"
+           "      Write the changes to the books after sequence number <seq> (default\n"
+           "      0, everything) to <file> or standard output, one JSON object per\n"
+           "      line or in the compact binary format.  Resume from the last \"seq\".\n");
+}
+
+static void print941(const Form941Summary &f)
+{
+    printf("Form 941, Q%d\n", f.quarter);
+    printf("  1  Employees receiving pay        %12zu\n", f.employees);
+    printf("  2  Wages, tips, compensation      %12.2f\n", f.wages);
+    printf("  5a Taxable social security wages  %12.2f\n", f.social_security_wages);
+    printf("  5a Social security tax            %12.2f\n", f.social_security_tax);
+}
+
+static void print940(const Form940Summary &f)
+{
+    printf("Form 940\n");
+    printf("     Employees paid                 %12zu\n", f.employees);
+    printf("  3  Total payments                 %12.2f\n", f.total_payments);
+    printf("  5  Payments in excess of cap      %12.2f\n", f.excess_payments);
+    printf("  7  Taxable FUTA wages             %12.2f\n", f.taxable_futa_wages);
+    printf("  8  FUTA tax before adjustments    %12.2f\n", f.futa_tax);
+    for (int q = 0; q < 4; ++q)
+        printf("  16 Q%d liability                  %12.2f\n", q + 1, f.quarterly_liability[q]);
+}
+
+static int report(int argc, char **argv)
+{
+    std::string dataDir;
+    std::string form;
+    long long companyId = -1;
+    int year = 0;
+    unsigned threads = 0;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--year") && i + 1 < argc)
+            year = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--form") && i + 1 < argc)
+            form = argv[++i];
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || year <= 0 || (!form.empty() && form != "941" && form != "940"))
+    {
+        usage();
+        return 1;
+    }
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+    TaxReport taxReport(year);
+    taxReport.generate(db::loadPayrollHistory(*ledger, year), threads);
+
+    if (form.empty() || form == "941")
+    {
+        for (int q = 1; q <= 4; ++q)
+            print941(taxReport.form941(q));
+    }
+    if (form.empty() || form == "940")
+        print940(taxReport.form940());
+
+    return 0;
+}
+
+static void printLine(const accounting::ledger::CashLine &line)
+{
+    int year, month, day;
+    accounting::fromDays(line.date, year, month, day);
+    printf("  %8lld  %04d-%02d-%02d %14.2f  %s\n", line.id, year, month, day, line.amount, line.reference.c_str());
+}
+
+static int reconcile(int argc, char **argv)
+{
+    using namespace accounting::ledger;
+
+    std::string dataDir;
+    std::string statementFile;
+    long long companyId = -1;
+    long long accountId = -1;
+    ReconciliationOptions options;
+    unsigned threads = 0;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--account") && i + 1 < argc)
+            accountId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--statement") && i + 1 < argc)
+            statementFile = argv[++i];
+        else if (!strcmp(argv[i], "--days") && i + 1 < argc)
+            options.date_tolerance = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || accountId < 0 || statementFile.empty() || options.date_tolerance < 0)
+    {
+        usage();
+        return 1;
+    }
+
+    std::ifstream in(statementFile);
+    if (!in)
+    {
+        fprintf(stderr, "cannot open %s\n", statementFile.c_str());
+        return 1;
+    }
+    std::vector<CashLine> statement = readStatement(in);
+    if (statement.empty())
+    {
+        fprintf(stderr, "%s: no statement lines\n", statementFile.c_str());
+        return 1;
+    }
+
+    auto range = std::minmax_element(statement.begin(), statement.end(),
+                                     [](const CashLine &a, const CashLine &b) { return a.date < b.date; });
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+    std::vector<CashLine> lines = db::loadAccountLines(*ledger, accountId,
+                                                       range.first->date - options.date_tolerance,
+                                                       range.second->date + options.date_tolerance);
+
+    auto start = std::chrono::steady_clock::now();
+    Reconciliation reconciliation(options);
+    reconciliation.reconcile(statement, lines, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Reconciliation of account %lld, %zu statement lines, %zu ledger lines (%.3f s)\n",
+           accountId, statement.size(), lines.size(), seconds);
+    printf("  Exact matches                    %10zu\n", reconciliation.count(ReconciliationMatch::eMatchExact));
+    printf("  Amount and date matches          %10zu\n", reconciliation.count(ReconciliationMatch::eMatchAmountDate));
+    printf("  Date window matches              %10zu\n", reconciliation.count(ReconciliationMatch::eMatchDateWindow));
+    printf("  Split matches                    %10zu\n", reconciliation.count(ReconciliationMatch::eMatchSplit));
+
+    std::map<long long, const CashLine *> byId;
+    for (const CashLine &line : statement)
+        byId[line.id] = &line;
+    printf("Unmatched statement lines          %10zu\n", reconciliation.unmatchedStatement().size());
+    for (long long id : reconciliation.unmatchedStatement())
+        printLine(*byId[id]);
+
+    // Lines in the margins either side of the statement were only loaded
+    // in case they cleared late or early; they belong to other statements.
+    byId.clear();
+    for (const CashLine &line : lines)
+    {
+        if (line.date >= range.first->date && line.date <= range.second->date)
+            byId[line.id] = &line;
+    }
+    std::vector<const CashLine *> unmatched;
+    for (long long id : reconciliation.unmatchedLedger())
+    {
+        auto found = byId.find(id);
+        if (found != byId.end())
+            unmatched.push_back(found->second);
+    }
+    printf("Unmatched ledger lines             %10zu\n", unmatched.size());
+    for (const CashLine *line : unmatched)
+        printLine(*line);
+
+    return reconciliation.unmatchedStatement().empty() && unmatched.empty() ? 0 : 2;
+}
+
+static bool parseDate(const char *text, int &date)
+{
+    int year, month, day;
+    if (sscanf(text, "%d-%d-%d", &year, &month, &day) != 3 || month < 1 || month > 12 || day < 1 || day > 31)
+        return false;
+    date = accounting::toDays(year, month, day);
+    return true;
+}
+
+static int rates(int argc, char **argv)
+{
+    std::string dataDir;
+    std::string file;
+    long long companyId = -1;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--file") && i + 1 < argc)
+            file = argv[++i];
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || file.empty())
+    {
+        usage();
+        return 1;
+    }
+
+    std::ifstream in(file);
+    if (!in)
+    {
+        fprintf(stderr, "cannot open %s\n", file.c_str());
+        return 1;
+    }
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+    Wt::Dbo::Transaction transaction(*ledger);
+
+    std::string text;
+    std::size_t loaded = 0;
+    for (int number = 1; std::getline(in, text); ++number)
+    {
+        char code[8];
+        char date[16];
+        double rate;
+        int day;
+        if (sscanf(text.c_str(), " %7[^,],%15[^,],%lf", code, date, &rate) != 3 || !parseDate(date, day) || rate <= 0)
+        {
+            if (number == 1)
+                continue;
+            fprintf(stderr, "%s:%d: expected currency,yyyy-mm-dd,rate\n", file.c_str(), number);
+            transaction.rollback();
+            return 1;
+        }
+        db::setExchangeRate(*ledger, accounting::Currency(code), day, rate);
+        ++loaded;
+    }
+    transaction.commit();
+
+    printf("Loaded %zu exchange rates\n", loaded);
+    return 0;
+}
+
+static int revalue(int argc, char **argv)
+{
+    using namespace accounting::ledger;
+
+    std::string dataDir;
+    long long companyId = -1;
+    long long accountId = -1;
+    int date = 0;
+    bool haveDate = false;
+    bool dryRun = false;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--date") && i + 1 < argc)
+            haveDate = parseDate(argv[++i], date);
+        else if (!strcmp(argv[i], "--account") && i + 1 < argc)
+            accountId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--dry-run"))
+            dryRun = true;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || accountId < 0 || !haveDate)
+    {
+        usage();
+        return 1;
+    }
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+
+    // Hold the books lock from reading the balances to posting, so no
+    // posting (or other revaluation) can come in between and make the
+    // adjustment stale.
+    Wt::Dbo::Transaction transaction(*ledger);
+    if (!dryRun)
+        ledger->lockBooks();
+
+    Revaluation revaluation(accountId);
+    std::vector<ForeignBalance> balances = db::loadForeignBalances(*ledger, date);
+    revaluation.reserve(balances.size());
+    for (const ForeignBalance &balance : balances)
+        revaluation.add(balance);
+
+    JournalEntry entry = revaluation.revalue(db::loadExchangeRates(*ledger), date);
+
+    printf("Revaluation of %zu foreign currency balances\n", revaluation.size());
+    for (std::size_t i = 0; i < balances.size(); ++i)
+    {
+        printf("  %8lld %s %16.2f  book %14.2f  adjustment %12.2f\n",
+               balances[i].account_id, balances[i].currency.code().c_str(), balances[i].currency_balance,
+               balances[i].book_balance, revaluation.adjustment(i));
+    }
+    printf("Unrealized exchange %s %12.2f\n", revaluation.gain() < 0 ? "loss" : "gain", std::fabs(revaluation.gain()));
+
+    if (!dryRun && !entry.lines.empty())
+    {
+        Wt::Dbo::ptr<db::JournalEntry> posted = db::addJournalEntry(*ledger, entry);
+        transaction.commit();
+        printf("Posted journal entry %lld\n", posted.id());
+    }
+
+    return 0;
+}
+
+static int accounts(int argc, char **argv)
+{
+    std::string dataDir;
+    std::string file;
+    long long companyId = -1;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--file") && i + 1 < argc)
+            file = argv[++i];
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || file.empty())
+    {
+        usage();
+        return 1;
+    }
+
+    std::ifstream in(file);
+    if (!in)
+    {
+        fprintf(stderr, "cannot open %s\n", file.c_str());
+        return 1;
+    }
+
+    std::vector<accounting::ledger::Account> chart;
+    std::string text;
+    for (int number = 1; std::getline(in, text); ++number)
+    {
+        if (!text.empty() && text.back() == '\r')
+            text.pop_back();
+
+        accounting::ledger::Account account;
+        char accountNumber[64];
+        int consumed = 0;
+        if (sscanf(text.c_str(), "%lld,%lld,%63[^,],%n", &account.id, &account.parent_id, accountNumber, &consumed) < 3 ||
+            consumed == 0)
+        {
+            if (number == 1)
+                continue;
+            fprintf(stderr, "%s:%d: expected id,parent,number,name\n", file.c_str(), number);
+            return 1;
+        }
+        account.number = accountNumber;
+        account.name = text.substr(consumed);
+        chart.push_back(account);
+    }
+
+    // Check the hierarchy before writing any of it.
+    accounting::ledger::ChartOfAccounts checked(chart);
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+    Wt::Dbo::Transaction transaction(*ledger);
+    for (const accounting::ledger::Account &account : chart)
+        db::saveAccount(*ledger, account);
+    transaction.commit();
+
+    printf("Loaded %zu accounts\n", checked.size());
+    return 0;
+}
+
+static int balances(int argc, char **argv)
+{
+    using namespace accounting::ledger;
+
+    std::string dataDir;
+    long long companyId = -1;
+    int date = 0;
+    bool haveDate = false;
+    int maxDepth = -1;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--date") && i + 1 < argc)
+            haveDate = parseDate(argv[++i], date);
+        else if (!strcmp(argv[i], "--depth") && i + 1 < argc)
+            maxDepth = atoi(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || !haveDate)
+    {
+        usage();
+        return 1;
+    }
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+    ChartOfAccounts chart = db::loadChartOfAccounts(*ledger);
+    Rollup rollup(chart, db::loadBalances(*ledger, date));
+
+    // One walk down the flattened chart; a collapsed subtree is skipped
+    // whole by jumping to the end of its interval.
+    for (std::size_t p = 0; p < chart.size();)
+    {
+        const Account &account = chart.at(p);
+        const int depth = chart.depth(p);
+        printf("%*s%-*s %-*s %14.2f\n", depth * 2, "", 10, account.number.c_str(),
+               std::max(1, 40 - depth * 2), account.name.c_str(), rollup.totalAt(p));
+        p = depth == maxDepth ? chart.end(p) : p + 1;
+    }
+
+    return 0;
+}
+
+static int closeBooks(int argc, char **argv)
 {
-    printf("%s %s\n", PROJECT_NAME, PROJECT_VER);
+    std::string dataDir;
+    long long companyId = -1;
+    int year = 0;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--year") && i + 1 < argc)
+            year = atoi(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || year <= 0)
+    {
+        usage();
+        return 1;
+    }
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+    const accounting::PeriodArchive archive = db::closeYear(*ledger, year);
+
+    const std::string file = ledger->archives()->file(year);
+    std::ifstream written(file, std::ios::binary | std::ios::ate);
+    printf("Closed %d: %zu journal entries, %zu lines, %zu paychecks\n", year, archive.entries(), archive.lines(),
+           archive.paychecks());
+    printf("  %s, %lld bytes\n", file.c_str(), static_cast<long long>(written.tellg()));
     return 0;
 }
 
+static int exportChanges(int argc, char **argv)
+{
+    std::string dataDir;
+    long long companyId = -1;
+    long long since = 0;
+    std::string format = "ndjson";
+    std::string out;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--data") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "--company") && i + 1 < argc)
+            companyId = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--since") && i + 1 < argc)
+            since = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc)
+            format = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc)
+            out = argv[++i];
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (dataDir.empty() || companyId < 0 || since < 0 || (format != "ndjson" && format != "binary"))
+    {
+        usage();
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!out.empty())
+    {
+        file.open(out, std::ios::binary);
+        if (!file)
+        {
+            fprintf(stderr, "Can't write %s\n", out.c_str());
+            return 1;
+        }
+    }
+    std::ostream &stream = out.empty() ? std::cout : file;
+
+    db::ShardRouter router(dataDir, 1);
+    std::unique_ptr<db::LedgerSession> ledger = router.session(companyId);
+
+    // A page at a time, so memory stays flat however far behind <seq> is.
+    db::ChangeCursor cursor(*ledger, since);
+    accounting::ChangeWriter writer(stream, format == "binary" ? accounting::ChangeWriter::eBinary
+                                                               : accounting::ChangeWriter::eNdjson);
+    for (std::vector<accounting::Change> changes; !(changes = cursor.next()).empty();)
+    {
+        for (const accounting::Change &change : changes)
+            writer.write(change);
+    }
+    stream.flush();
+
+    fprintf(stderr, "Exported %zu changes, through %lld\n", writer.written(), cursor.position());
+    return stream ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    // export may stream to standard output; keep it clean.
+    if (argc < 2 || strcmp(argv[1], "export"))
+        printf("%s %s\n", PROJECT_NAME, PROJECT_VER);
+
+    if (argc < 2)
+        return 0;
+
+    try
+    {
+        if (!strcmp(argv[1], "report"))
+            return report(argc - 2, argv + 2);
+        if (!strcmp(argv[1], "reconcile"))
+            return reconcile(argc - 2, argv + 2);
+        if (!strcmp(argv[1], "rates"))
+            return rates(argc - 2, argv + 2);
+        if (!strcmp(argv[1], "revalue"))
+            return revalue(argc - 2, argv + 2);
+        if (!strcmp(argv[1], "accounts"))
+            return accounts(argc - 2, argv + 2);
+        if (!strcmp(argv[1], "balances"))
+            return balances(argc - 2, argv + 2);
+        if (!strcmp(argv[1], "close"))
+            return closeBooks(argc - 2, argv + 2);
+        if (!strcmp(argv[1], "export"))
+            return exportChanges(argc - 2, argv + 2);
+    }
+    catch (std::exception &e)
+    {
+        fprintf(stderr, "exception: %s\n", e.what());
+        return 1;
+    }
+
+    usage();
+    return 1;
+}
+
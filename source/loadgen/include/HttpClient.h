@@ -0,0 +1,79 @@
+//! \file HttpClient.h
+//! \brief Minimal blocking HTTP/1.1 client
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _LOADGEN_HTTP_CLIENT_H_
+#define _LOADGEN_HTTP_CLIENT_H_
+
+#include <map>
+#include <string>
+
+namespace loadgen
+{
+
+//! \brief A response as read off the wire
+struct HttpResponse
+{
+  int status = 0;
+  std::map<std::string, std::string> headers; //!< Names lower cased
+  std::string body;                           //!< Chunked encoding removed
+};
+
+//! \brief One keep-alive connection, with its own cookies
+//!
+//! Just enough HTTP for driving XGL.wt on localhost: Content-Length and
+//! chunked bodies, cookies and reconnecting when the server closes an
+//! idle connection.  Each simulated browser session owns one, so the
+//! server sees one connection per session as it would from real users.
+class HttpClient
+{
+public:
+  HttpClient(const std::string& host, int port);
+  ~HttpClient();
+
+  HttpClient(const HttpClient&) = delete;
+  HttpClient& operator=(const HttpClient&) = delete;
+
+  //! \brief Send a request and wait for the whole response
+  //!
+  //! \throws std::runtime_error on connection failure or a malformed
+  //!         response.
+  HttpResponse request(const std::string& method, const std::string& target,
+                       const std::string& body = std::string());
+
+  //! \brief Number of TCP connections opened so far
+  unsigned connects() const { return connects_; }
+
+private:
+  void open();
+  void close();
+  bool send(const std::string& data);
+  bool fill();
+  HttpResponse read(const std::string& method);
+  std::string line();
+  void store(const std::string& setCookie);
+
+  std::string host_;
+  int port_;
+  int fd_ = -1;
+  unsigned connects_ = 0;
+  std::string buffer_;
+  std::map<std::string, std::string> cookies_;
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+//! \file ReplayScript.h
+//! \brief Scripted browser session
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _LOADGEN_REPLAY_SCRIPT_H_
+#define _LOADGEN_REPLAY_SCRIPT_H_
+
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace loadgen
+{
+
+class HttpClient;
+
+//! \brief One request of a session
+struct Step
+{
+  std::string name;
+  std::string method;
+  std::string target;
+  std::string body;
+  int expect = 0; //!< Required status, 0 for any
+  std::vector<std::pair<std::string, std::regex>> captures;
+};
+
+//! \brief Per step timings of one session
+struct SessionResult
+{
+  bool ok = true;
+  std::string error;            //!< Why the session failed
+  std::string body;             //!< Response of the failing step
+  std::vector<double> latency;  //!< Milliseconds, by step; short on failure
+};
+
+//! \brief A browser session, as a list of requests
+//!
+//! The script format is line based:
+//!
+//!     step <name> <GET|POST> <target>
+//!     body <form encoded body>
+//!     expect <status>
+//!     capture <variable> <regex>
+//!
+//! A capture binds the first group of the regex's first match in the
+//! response body to a variable for later steps; a capture that doesn't
+//! match fails the session, which makes it an assertion as well.  In the
+//! target and body ${variable} is replaced as is and %{variable} form
+//! encoded.  Blank lines and lines starting with # are ignored.
+class ReplayScript
+{
+public:
+  //! \throws std::runtime_error naming the line of a syntax error
+  static ReplayScript load(const std::string& path);
+
+  const std::vector<Step>& steps() const { return steps_; }
+
+  //! \brief Run every step in order over \p client
+  //!
+  //! \param variables    Predefined variables; captures are added.
+  SessionResult run(HttpClient& client, std::map<std::string, std::string> variables) const;
+
+private:
+  std::vector<Step> steps_;
+};
+
+//! \brief Replace ${name} and %{name} in \p text
+std::string substitute(const std::string& text, const std::map<std::string, std::string>& variables);
+
+//! \brief application/x-www-form-urlencoded encoding of \p text
+std::string formEncode(const std::string& text);
+
+}
+
+#endif
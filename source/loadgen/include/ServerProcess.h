@@ -0,0 +1,66 @@
+//! \file ServerProcess.h
+//! \brief XGL.wt child process
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _LOADGEN_SERVER_PROCESS_H_
+#define _LOADGEN_SERVER_PROCESS_H_
+
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace loadgen
+{
+
+//! \brief Runs XGL.wt against a throwaway application root
+//!
+//! The server gets a fresh temporary directory as --approot, so auth.db
+//! and the company databases start empty and are removed afterwards.
+//! Its output goes to server.log there, which is kept if the server
+//! fails to start.
+class ServerProcess
+{
+public:
+  //! \param executable   Path of XGL.wt
+  //! \param arguments    Extra arguments, e.g. --docroot
+  //! \param port         Port to listen on, on 127.0.0.1
+  ServerProcess(const std::string& executable, const std::vector<std::string>& arguments, int port);
+  ~ServerProcess();
+
+  ServerProcess(const ServerProcess&) = delete;
+  ServerProcess& operator=(const ServerProcess&) = delete;
+
+  //! \brief Wait until the server accepts connections
+  //!
+  //! \throws std::runtime_error if it exits or \p seconds pass first.
+  void waitReady(int seconds);
+
+  pid_t pid() const { return pid_; }
+  const std::string& appRoot() const { return appRoot_; }
+
+private:
+  std::string appRoot_;
+  pid_t pid_ = -1;
+  int port_;
+  bool keep_ = false;
+};
+
+//! \brief Resident set size of \p pid in bytes, 0 if unknown
+std::size_t residentSetSize(pid_t pid);
+
+}
+
+#endif
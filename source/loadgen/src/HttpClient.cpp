@@ -0,0 +1,266 @@
+//! \file HttpClient.cpp
+//! \brief Minimal blocking HTTP/1.1 client
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "HttpClient.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace loadgen
+{
+
+namespace
+{
+
+std::string lower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+}
+
+HttpClient::HttpClient(const std::string &host, int port)
+    : host_(host),
+      port_(port)
+{
+}
+
+HttpClient::~HttpClient()
+{
+    close();
+}
+
+void HttpClient::open()
+{
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(host_.c_str(), std::to_string(port_).c_str(), &hints, &addresses) != 0)
+        throw std::runtime_error("cannot resolve " + host_);
+
+    for (addrinfo *address = addresses; address; address = address->ai_next)
+    {
+        fd_ = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd_ < 0)
+            continue;
+        if (::connect(fd_, address->ai_addr, address->ai_addrlen) == 0)
+            break;
+        ::close(fd_);
+        fd_ = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd_ < 0)
+        throw std::runtime_error("cannot connect to " + host_ + ":" + std::to_string(port_) + ": " + strerror(errno));
+
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    // A wedged server shouldn't hang the run.
+    timeval timeout = {60, 0};
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    buffer_.clear();
+    ++connects_;
+}
+
+void HttpClient::close()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+}
+
+bool HttpClient::send(const std::string &data)
+{
+    std::size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+bool HttpClient::fill()
+{
+    char chunk[16384];
+    for (;;)
+    {
+        ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        buffer_.append(chunk, n);
+        return true;
+    }
+}
+
+std::string HttpClient::line()
+{
+    std::string::size_type end;
+    while ((end = buffer_.find("\r\n")) == std::string::npos)
+    {
+        if (!fill())
+            throw std::runtime_error("connection closed mid response");
+    }
+    std::string result = buffer_.substr(0, end);
+    buffer_.erase(0, end + 2);
+    return result;
+}
+
+void HttpClient::store(const std::string &setCookie)
+{
+    // Only name=value matters here; attributes are ignored.
+    std::string pair = setCookie.substr(0, setCookie.find(';'));
+    std::string::size_type equals = pair.find('=');
+    if (equals != std::string::npos)
+        cookies_[pair.substr(0, equals)] = pair.substr(equals + 1);
+}
+
+HttpResponse HttpClient::request(const std::string &method, const std::string &target, const std::string &body)
+{
+    std::string request = method + " " + target + " HTTP/1.1\r\n"
+                          "Host: " + host_ + ":" + std::to_string(port_) + "\r\n"
+                          "User-Agent: xgl_loadgen\r\n"
+                          "Accept: text/html,*/*\r\n"
+                          "Accept-Encoding: identity\r\n";
+    if (!cookies_.empty())
+    {
+        request += "Cookie: ";
+        for (auto i = cookies_.begin(); i != cookies_.end(); ++i)
+            request += (i == cookies_.begin() ? "" : "; ") + i->first + "=" + i->second;
+        request += "\r\n";
+    }
+    if (method == "POST")
+        request += "Content-Type: application/x-www-form-urlencoded\r\n"
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    request += "\r\n" + body;
+
+    // The server may have dropped a kept-alive connection while it sat
+    // idle; that is worth one retry on a new one.
+    bool reused = fd_ >= 0;
+    if (!reused)
+        open();
+    if (!send(request) || (buffer_.empty() && !fill()))
+    {
+        if (!reused)
+            throw std::runtime_error("connection closed before response");
+        close();
+        open();
+        if (!send(request))
+            throw std::runtime_error("send failed: " + std::string(strerror(errno)));
+    }
+
+    HttpResponse response = read(method);
+    auto connection = response.headers.find("connection");
+    if (connection != response.headers.end() && lower(connection->second) == "close")
+        close();
+    return response;
+}
+
+HttpResponse HttpClient::read(const std::string &method)
+{
+    HttpResponse response;
+
+    std::string status = line();
+    if (status.compare(0, 5, "HTTP/") != 0 || status.size() < 12)
+        throw std::runtime_error("malformed status line: " + status);
+    response.status = std::atoi(status.c_str() + 9);
+
+    for (std::string header = line(); !header.empty(); header = line())
+    {
+        std::string::size_type colon = header.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string name = lower(header.substr(0, colon));
+        std::string::size_type start = header.find_first_not_of(' ', colon + 1);
+        std::string value = start == std::string::npos ? std::string() : header.substr(start);
+        if (name == "set-cookie")
+            store(value);
+        response.headers[name] = value;
+    }
+
+    if (method == "HEAD" || response.status == 204 || response.status == 304 || response.status / 100 == 1)
+        return response;
+
+    auto encoding = response.headers.find("transfer-encoding");
+    auto length = response.headers.find("content-length");
+    if (encoding != response.headers.end() && lower(encoding->second).find("chunked") != std::string::npos)
+    {
+        for (;;)
+        {
+            std::size_t size = std::strtoul(line().c_str(), nullptr, 16);
+            if (size == 0)
+                break;
+            while (buffer_.size() < size + 2)
+            {
+                if (!fill())
+                    throw std::runtime_error("connection closed mid chunk");
+            }
+            response.body.append(buffer_, 0, size);
+            buffer_.erase(0, size + 2);
+        }
+        // Trailers, up to the closing blank line.
+        while (!line().empty())
+        {
+        }
+    }
+    else if (length != response.headers.end())
+    {
+        std::size_t size = std::strtoul(length->second.c_str(), nullptr, 10);
+        while (buffer_.size() < size)
+        {
+            if (!fill())
+                throw std::runtime_error("connection closed mid body");
+        }
+        response.body = buffer_.substr(0, size);
+        buffer_.erase(0, size);
+    }
+    else
+    {
+        // Delimited by the server closing the connection.
+        while (fill())
+        {
+        }
+        response.body.swap(buffer_);
+        close();
+    }
+
+    return response;
+}
+
+}
@@ -0,0 +1,199 @@
+//! \file ReplayScript.cpp
+//! \brief Scripted browser session
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "ReplayScript.h"
+#include "HttpClient.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace loadgen
+{
+
+ReplayScript ReplayScript::load(const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open " + path);
+
+    ReplayScript script;
+    std::string text;
+    for (int number = 1; std::getline(in, text); ++number)
+    {
+        std::istringstream fields(text);
+        std::string keyword;
+        fields >> keyword;
+        if (keyword.empty() || keyword[0] == '#')
+            continue;
+
+        auto error = [&](const std::string &what) {
+            return std::runtime_error(path + ":" + std::to_string(number) + ": " + what);
+        };
+
+        // Everything after the keyword (and a variable name) verbatim.
+        auto rest = [&fields]() {
+            std::string value;
+            std::getline(fields >> std::ws, value);
+            return value;
+        };
+
+        if (keyword == "step")
+        {
+            Step step;
+            fields >> step.name >> step.method >> step.target;
+            if (step.target.empty() || (step.method != "GET" && step.method != "POST"))
+                throw error("expected: step <name> <GET|POST> <target>");
+            script.steps_.push_back(step);
+            continue;
+        }
+
+        if (script.steps_.empty())
+            throw error("'" + keyword + "' before the first step");
+        Step &step = script.steps_.back();
+
+        if (keyword == "body")
+            step.body = rest();
+        else if (keyword == "expect")
+        {
+            if (!(fields >> step.expect))
+                throw error("expected: expect <status>");
+        }
+        else if (keyword == "capture")
+        {
+            std::string variable;
+            fields >> variable;
+            std::string pattern = rest();
+            if (pattern.empty())
+                throw error("expected: capture <variable> <regex>");
+            try
+            {
+                step.captures.emplace_back(variable, std::regex(pattern));
+            }
+            catch (std::regex_error &e)
+            {
+                throw error(std::string("bad regex: ") + e.what());
+            }
+        }
+        else
+            throw error("unknown keyword '" + keyword + "'");
+    }
+
+    if (script.steps_.empty())
+        throw std::runtime_error(path + ": no steps");
+    return script;
+}
+
+SessionResult ReplayScript::run(HttpClient &client, std::map<std::string, std::string> variables) const
+{
+    typedef std::chrono::steady_clock Clock;
+
+    SessionResult result;
+    for (const Step &step : steps_)
+    {
+        HttpResponse response;
+        Clock::time_point start = Clock::now();
+        try
+        {
+            response = client.request(step.method, substitute(step.target, variables), substitute(step.body, variables));
+        }
+        catch (std::exception &e)
+        {
+            result.ok = false;
+            result.error = step.name + ": " + e.what();
+            return result;
+        }
+        result.latency.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+        if (step.expect && response.status != step.expect)
+        {
+            result.ok = false;
+            result.error = step.name + ": status " + std::to_string(response.status);
+            result.body = response.body;
+            return result;
+        }
+
+        for (const auto &capture : step.captures)
+        {
+            std::smatch match;
+            if (!std::regex_search(response.body, match, capture.second) || match.size() < 2)
+            {
+                result.ok = false;
+                result.error = step.name + ": nothing to capture for " + capture.first;
+                result.body = response.body;
+                return result;
+            }
+            variables[capture.first] = match[1];
+        }
+    }
+    return result;
+}
+
+std::string substitute(const std::string &text, const std::map<std::string, std::string> &variables)
+{
+    std::string result;
+    std::string::size_type position = 0;
+    for (;;)
+    {
+        std::string::size_type open = text.find('{', position);
+        if (open == std::string::npos)
+            break;
+        char sigil = open > 0 ? text[open - 1] : 0;
+        std::string::size_type close = text.find('}', open);
+        if ((sigil != '$' && sigil != '%') || close == std::string::npos)
+        {
+            result.append(text, position, open + 1 - position);
+            position = open + 1;
+            continue;
+        }
+
+        std::string name = text.substr(open + 1, close - open - 1);
+        auto found = variables.find(name);
+        if (found == variables.end())
+            throw std::runtime_error("undefined variable " + name);
+
+        result.append(text, position, open - 1 - position);
+        result += sigil == '%' ? formEncode(found->second) : found->second;
+        position = close + 1;
+    }
+    result.append(text, position, std::string::npos);
+    return result;
+}
+
+std::string formEncode(const std::string &text)
+{
+    std::string result;
+    for (unsigned char c : text)
+    {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '*')
+            result += c;
+        else if (c == ' ')
+            result += '+';
+        else
+        {
+            char escaped[4];
+            snprintf(escaped, sizeof(escaped), "%%%02X", c);
+            result += escaped;
+        }
+    }
+    return result;
+}
+
+}
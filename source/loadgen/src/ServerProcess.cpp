@@ -0,0 +1,142 @@
+//! \file ServerProcess.cpp
+//! \brief XGL.wt child process
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "ServerProcess.h"
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace loadgen
+{
+
+ServerProcess::ServerProcess(const std::string &executable, const std::vector<std::string> &arguments, int port)
+    : port_(port)
+{
+    char root[] = "/tmp/xgl_loadgen.XXXXXX";
+    if (!mkdtemp(root))
+        throw std::runtime_error("cannot create a temporary directory");
+    appRoot_ = std::string(root) + "/";
+
+    std::vector<std::string> argv = {executable};
+    argv.insert(argv.end(), arguments.begin(), arguments.end());
+    argv.insert(argv.end(), {"--approot", appRoot_,
+                             "--http-address", "127.0.0.1",
+                             "--http-port", std::to_string(port)});
+
+    std::vector<char *> args;
+    for (std::string &arg : argv)
+        args.push_back(&arg[0]);
+    args.push_back(nullptr);
+
+    const std::string log = appRoot_ + "server.log";
+
+    pid_ = fork();
+    if (pid_ < 0)
+        throw std::runtime_error("fork failed");
+    if (pid_ == 0)
+    {
+        int fd = ::open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            ::close(fd);
+        }
+        execv(args[0], args.data());
+        perror(args[0]);
+        _exit(127);
+    }
+}
+
+ServerProcess::~ServerProcess()
+{
+    if (pid_ > 0)
+    {
+        kill(pid_, SIGTERM);
+        waitpid(pid_, nullptr, 0);
+    }
+
+    std::error_code ignored;
+    if (keep_)
+        std::cerr << "server output kept in " << appRoot_ << "server.log" << std::endl;
+    else
+        std::filesystem::remove_all(appRoot_, ignored);
+}
+
+void ServerProcess::waitReady(int seconds)
+{
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port_);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        int status;
+        if (waitpid(pid_, &status, WNOHANG) == pid_)
+        {
+            pid_ = -1;
+            keep_ = true;
+            throw std::runtime_error("server exited during startup");
+        }
+
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        bool connected = ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+        ::close(fd);
+        if (connected)
+            return;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    keep_ = true;
+    throw std::runtime_error("server not listening after " + std::to_string(seconds) + "s");
+}
+
+std::size_t residentSetSize(pid_t pid)
+{
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+    std::string key;
+    while (status >> key)
+    {
+        if (key == "VmRSS:")
+        {
+            std::size_t kilobytes = 0;
+            status >> kilobytes;
+            return kilobytes * 1024;
+        }
+        status.ignore(4096, '\n');
+    }
+    return 0;
+}
+
+}
@@ -0,0 +1,238 @@
+//! \file xgl_loadgen.cpp
+//! \brief Load generator for XGL.wt
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HttpClient.h"
+#include "ReplayScript.h"
+#include "ServerProcess.h"
+
+using namespace loadgen;
+
+static void usage()
+{
+    printf("usage: xgl_loadgen [options]\n"
+           "\n"
+           "Runs scripted browser sessions against XGL.wt, many at once, and reports\n"
+           "throughput, latency per step and server memory per session.\n"
+           "\n"
+           "options:\n"
+           "  --server <XGL.wt>     Server to start on a temporary database\n"
+           "                        (default %s)\n"
+           "  --docroot <dir>       Its document root (default %s)\n"
+           "  --config <file>       Its wt_config.xml\n"
+           "  --port <n>            Port to start it on (default 9191)\n"
+           "  --attach <port>       Use a server that is already running instead\n"
+           "  --pid <pid>           Process id of that server, for memory figures\n"
+           "  --script <file>       Session script (default %s)\n"
+           "  --sessions <n>        Sessions to run (default 200)\n"
+           "  --concurrency <n>     Sessions at once (default 16)\n"
+           "  --dump <file>         Write the response that failed the first failing\n"
+           "                        session to <file>\n",
+           XGL_LOADGEN_SERVER, XGL_LOADGEN_DOCROOT, XGL_LOADGEN_SCRIPT);
+}
+
+//! \brief The \p p quantile of \p samples, in place
+static double percentile(std::vector<double> &samples, double p)
+{
+    if (samples.empty())
+        return 0;
+    std::size_t rank = std::max<std::size_t>(1, std::ceil(p * samples.size())) - 1;
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+int main(int argc, char **argv)
+{
+    std::string server = XGL_LOADGEN_SERVER;
+    std::string docroot = XGL_LOADGEN_DOCROOT;
+    std::string config;
+    std::string scriptFile = XGL_LOADGEN_SCRIPT;
+    std::string dump;
+    int port = 9191;
+    int attach = 0;
+    long pid = 0;
+    int sessions = 200;
+    int concurrency = 16;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--server") && i + 1 < argc)
+            server = argv[++i];
+        else if (!strcmp(argv[i], "--docroot") && i + 1 < argc)
+            docroot = argv[++i];
+        else if (!strcmp(argv[i], "--config") && i + 1 < argc)
+            config = argv[++i];
+        else if (!strcmp(argv[i], "--port") && i + 1 < argc)
+            port = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--attach") && i + 1 < argc)
+            attach = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--pid") && i + 1 < argc)
+            pid = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--script") && i + 1 < argc)
+            scriptFile = argv[++i];
+        else if (!strcmp(argv[i], "--sessions") && i + 1 < argc)
+            sessions = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--concurrency") && i + 1 < argc)
+            concurrency = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--dump") && i + 1 < argc)
+            dump = argv[++i];
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (sessions <= 0 || concurrency <= 0 || port <= 0)
+    {
+        usage();
+        return 1;
+    }
+
+    try
+    {
+        const ReplayScript script = ReplayScript::load(scriptFile);
+
+        std::unique_ptr<ServerProcess> process;
+        if (attach)
+            port = attach;
+        else
+        {
+            std::vector<std::string> arguments = {"--docroot", docroot};
+            if (!config.empty())
+                arguments.insert(arguments.begin(), {"-c", config});
+            process = std::make_unique<ServerProcess>(server, arguments, port);
+            process->waitReady(30);
+            pid = process->pid();
+        }
+
+        // Unique user names even when attached to a server that has seen
+        // earlier runs.
+        const std::string run = std::to_string(std::chrono::system_clock::now().time_since_epoch().count() % 100000000);
+
+        const std::size_t rssBefore = pid ? residentSetSize(pid) : 0;
+
+        std::atomic<int> next(0);
+        std::atomic<unsigned> connections(0);
+        std::mutex mutex;
+        std::vector<SessionResult> results;
+        std::vector<double> sessionTimes;
+        results.reserve(sessions);
+        sessionTimes.reserve(sessions);
+
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < std::min(concurrency, sessions); ++t)
+        {
+            workers.emplace_back([&]() {
+                for (int n = next++; n < sessions; n = next++)
+                {
+                    Clock::time_point begin = Clock::now();
+                    HttpClient client("127.0.0.1", port);
+                    SessionResult result = script.run(client, {{"n", std::to_string(n)}, {"run", run}});
+                    double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+                    connections += client.connects();
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (result.ok)
+                        sessionTimes.push_back(elapsed);
+                    results.push_back(std::move(result));
+                }
+            });
+        }
+        for (std::thread &worker : workers)
+            worker.join();
+
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const std::size_t rssAfter = pid ? residentSetSize(pid) : 0;
+
+        const SessionResult *failed = nullptr;
+        std::size_t ok = 0;
+        for (const SessionResult &result : results)
+        {
+            if (result.ok)
+                ++ok;
+            else if (!failed)
+                failed = &result;
+        }
+
+        printf("sessions        %zu ok, %zu failed in %.2f s, %.1f sessions/s\n",
+               ok, results.size() - ok, seconds, ok / seconds);
+        printf("connections     %u\n", connections.load());
+        printf("session time    p50 %9.2f ms  p99 %9.2f ms\n",
+               percentile(sessionTimes, 0.50), percentile(sessionTimes, 0.99));
+
+        printf("\n%-16s %8s %12s %12s\n", "step", "count", "p50 ms", "p99 ms");
+        std::vector<double> all;
+        for (std::size_t s = 0; s < script.steps().size(); ++s)
+        {
+            std::vector<double> samples;
+            for (const SessionResult &result : results)
+            {
+                if (s < result.latency.size())
+                    samples.push_back(result.latency[s]);
+            }
+            all.insert(all.end(), samples.begin(), samples.end());
+            printf("%-16s %8zu %12.2f %12.2f\n", script.steps()[s].name.c_str(), samples.size(),
+                   percentile(samples, 0.50), percentile(samples, 0.99));
+        }
+        printf("%-16s %8zu %12.2f %12.2f\n", "(all requests)", all.size(),
+               percentile(all, 0.50), percentile(all, 0.99));
+
+        if (pid)
+        {
+            // Wt keeps each session, and its database connection, until it
+            // times out, so the growth over the run is what they cost.
+            printf("\nserver RSS      %.1f MB before, %.1f MB after", rssBefore / 1048576.0, rssAfter / 1048576.0);
+            if (ok && rssAfter > rssBefore)
+                printf(", %.1f KB per session", (rssAfter - rssBefore) / 1024.0 / ok);
+            printf("\n");
+        }
+
+        if (failed)
+        {
+            fprintf(stderr, "first failure: %s\n", failed->error.c_str());
+            if (!dump.empty())
+                std::ofstream(dump) << failed->body;
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        fprintf(stderr, "exception: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
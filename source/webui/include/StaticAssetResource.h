@@ -0,0 +1,66 @@
+//! \file StaticAssetResource.h
+//! \brief Precompressed static resource server
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _STATIC_ASSET_RESOURCE_H_
+#define _STATIC_ASSET_RESOURCE_H_
+#include <Wt/WResource.h>
+
+#include <string>
+#include <unordered_map>
+
+//! \brief Static asset resource
+//!
+//! Serves the fingerprinted copy of resources/ produced by the build (see
+//! cmake/assets.cmake) at /assets/<version>/.  Since a changed file means
+//! a new version, and so a new URL, everything is sent with a year long
+//! immutable Cache-Control and an ETag.  When the client accepts it, the
+//! brotli or gzip variant made at build time is sent instead of the
+//! original, so no compression happens per request.
+class StaticAssetResource : public Wt::WResource
+{
+public:
+  //! \brief Constructor
+  //!
+  //! \param directory    The build's assets directory, holding
+  //!                     assets.manifest.
+  StaticAssetResource(const std::string& directory);
+  ~StaticAssetResource();
+
+  //! \brief The URL prefix assets are served under
+  //!
+  //! For example "/assets/0e4cce07c53f/".
+  std::string baseUrl() const;
+
+  //! \brief Check the manifest was found and read
+  bool loaded() const { return !version_.empty(); }
+
+  void handleRequest(const Wt::Http::Request& request, Wt::Http::Response& response) override;
+
+private:
+  struct Asset
+  {
+    std::string etag;
+    bool gzip;
+    bool brotli;
+  };
+
+  std::string directory_;
+  std::string version_;
+  std::unordered_map<std::string, Asset> assets_;
+};
+
+#endif
@@ -21,16 +21,53 @@
 #include <Wt/Auth/AuthWidget.h>
 #include <Wt/Auth/PasswordService.h>
 #include "db/DBSession.h"
+#include "db/PostingService.h"
+#include "db/ShardRouter.h"
+#include "accounting/ledger/BalanceNotifier.h"
+
+#include <functional>
+#include <vector>
 
 class XGLApplication : public Wt::WApplication
 {
 public:
-  XGLApplication(const Wt::WEnvironment& env);
+  XGLApplication(const Wt::WEnvironment& env, Wt::Dbo::SqlConnectionPool& authPool, db::ShardRouter& router,
+                 db::PostingService& posting, accounting::ledger::BalanceNotifier& notifier);
+  ~XGLApplication();
 
   void authEvent();
 
+  //! \brief The company of the logged in user; 0 if nobody is logged in,
+  //! or the user has no company
+  long long companyId();
+
+  //! \brief Session on the logged in user's company database
+  //!
+  //! \throws std::runtime_error if there's no company, \see companyId()
+  db::LedgerSession& ledger();
+
+  //! \brief The process-wide journal posting service
+  db::PostingService& posting() { return posting_; }
+
+  //! \brief Keep a view of account balances up to date
+  //!
+  //! \p update is run in this session, and the changes pushed to the
+  //! browser, whenever any of \p accounts is posted to.  The watch ends
+  //! when the user logs out.
+  //!
+  //! \throws std::runtime_error if there's no company, \see companyId()
+  void watchBalances(const std::vector<long long>& accounts,
+                     std::function<void(const accounting::ledger::Balances&)> update);
+
 private:
+  long long requireCompany();
+
   db::DBSession session_;
+  db::ShardRouter& router_;
+  std::unique_ptr<db::LedgerSession> ledger_;
+  db::PostingService& posting_;
+  accounting::ledger::BalanceNotifier& notifier_;
+  std::vector<std::size_t> subscriptions_;
 };
 
 
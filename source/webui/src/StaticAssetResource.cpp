@@ -0,0 +1,186 @@
+//! \file StaticAssetResource.cpp
+//! \brief Precompressed static resource server
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "StaticAssetResource.h"
+
+#include <Wt/Http/Request.h>
+#include <Wt/Http/Response.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+const char *mimeType(const std::string &path)
+{
+    static const std::unordered_map<std::string, const char *> types = {
+        { "css", "text/css" },
+        { "js", "application/javascript" },
+        { "svg", "image/svg+xml" },
+        { "gif", "image/gif" },
+        { "png", "image/png" },
+        { "jpg", "image/jpeg" },
+        { "ttf", "font/ttf" },
+        { "otf", "font/otf" },
+        { "woff", "font/woff" },
+        { "woff2", "font/woff2" },
+        { "eot", "application/vnd.ms-fontobject" },
+        { "swf", "application/x-shockwave-flash" },
+        { "map", "application/json" },
+        { "html", "text/html" },
+        { "txt", "text/plain" },
+    };
+
+    std::string::size_type dot = path.rfind('.');
+    if (dot != std::string::npos)
+    {
+        auto found = types.find(path.substr(dot + 1));
+        if (found != types.end())
+            return found->second;
+    }
+    return "application/octet-stream";
+}
+
+bool accepts(const std::string &acceptEncoding, const std::string &encoding)
+{
+    // Accept-Encoding is a comma separated list of "coding[;q=weight]";
+    // a coding given a weight of zero is explicitly refused.
+    std::istringstream codings(acceptEncoding);
+    std::string coding;
+    while (std::getline(codings, coding, ','))
+    {
+        std::string::size_type first = coding.find_first_not_of(' ');
+        if (first == std::string::npos)
+            continue;
+        std::string::size_type semicolon = coding.find(';', first);
+        std::string name = coding.substr(first, semicolon == std::string::npos ? std::string::npos : semicolon - first);
+        name.erase(name.find_last_not_of(' ') + 1);
+        if (name != encoding)
+            continue;
+
+        std::string::size_type q = coding.find("q=", first);
+        return q == std::string::npos || std::atof(coding.c_str() + q + 2) > 0;
+    }
+    return false;
+}
+
+}
+
+StaticAssetResource::StaticAssetResource(const std::string &directory)
+    : directory_(directory)
+{
+    if (!directory_.empty() && directory_.back() != '/')
+        directory_ += '/';
+
+    std::ifstream manifest(directory_ + "assets.manifest");
+    std::string line;
+    while (std::getline(manifest, line))
+    {
+        std::istringstream fields(line);
+        std::string path;
+        fields >> path;
+        if (path == "version")
+        {
+            fields >> version_;
+            continue;
+        }
+
+        Asset asset;
+        int gzip = 0, brotli = 0;
+        fields >> asset.etag >> gzip >> brotli;
+        asset.gzip = gzip;
+        asset.brotli = brotli;
+        assets_[path] = asset;
+    }
+}
+
+StaticAssetResource::~StaticAssetResource()
+{
+    beingDeleted();
+}
+
+std::string StaticAssetResource::baseUrl() const
+{
+    return "/assets/" + version_ + "/";
+}
+
+void StaticAssetResource::handleRequest(const Wt::Http::Request &request, Wt::Http::Response &response)
+{
+    // pathInfo() is "/<version>/<path>".
+    const std::string &pathInfo = request.pathInfo();
+    const std::string prefix = "/" + version_ + "/";
+    if (version_.empty() || pathInfo.compare(0, prefix.size(), prefix) != 0)
+    {
+        response.setStatus(404);
+        return;
+    }
+
+    const std::string path = pathInfo.substr(prefix.size());
+    auto found = assets_.find(path);
+    if (found == assets_.end())
+    {
+        response.setStatus(404);
+        return;
+    }
+    const Asset &asset = found->second;
+
+    const std::string acceptEncoding = request.headerValue("Accept-Encoding");
+    std::string encoding;
+    std::string suffix;
+    if (asset.brotli && accepts(acceptEncoding, "br"))
+    {
+        encoding = "br";
+        suffix = ".br";
+    }
+    else if (asset.gzip && accepts(acceptEncoding, "gzip"))
+    {
+        encoding = "gzip";
+        suffix = ".gz";
+    }
+
+    const std::string etag = "\"" + asset.etag + (encoding.empty() ? "" : "-" + encoding) + "\"";
+
+    response.addHeader("Cache-Control", "public, max-age=31536000, immutable");
+    response.addHeader("ETag", etag);
+    if (asset.gzip || asset.brotli)
+        response.addHeader("Vary", "Accept-Encoding");
+
+    if (request.headerValue("If-None-Match") == etag)
+    {
+        response.setStatus(304);
+        return;
+    }
+
+    std::ifstream file(directory_ + version_ + "/" + path + suffix, std::ios::binary);
+    if (!file)
+    {
+        response.setStatus(404);
+        return;
+    }
+
+    response.setMimeType(mimeType(path));
+    if (!encoding.empty())
+        response.addHeader("Content-Encoding", encoding);
+
+    file.seekg(0, std::ios::end);
+    response.setContentLength(file.tellg());
+    file.seekg(0);
+
+    response.out() << file.rdbuf();
+}
@@ -25,12 +25,16 @@
 #include <Wt/WNavigationBar.h>
 #include <Wt/WPopupMenu.h>
 #include <Wt/WPopupMenuItem.h>
+#include <Wt/WServer.h>
 #include <Wt/WStackedWidget.h>
 #include <Wt/WText.h>
 
 #include "db/DBSession.h"
 
-using namespace db; 
+#include <stdexcept>
+
+using namespace db;
+using namespace accounting::ledger;
 
 /*
  * The env argument contains information about the new session, and
@@ -39,9 +43,13 @@ using namespace db;
  * application constructor.
 */
 
-XGLApplication::XGLApplication(const Wt::WEnvironment &env)
+XGLApplication::XGLApplication(const Wt::WEnvironment &env, Wt::Dbo::SqlConnectionPool &authPool,
+                               ShardRouter &router, PostingService &posting, BalanceNotifier &notifier)
     : WApplication(env),
-      session_(appRoot() + "auth.db")
+      session_(authPool),
+      router_(router),
+      posting_(posting),
+      notifier_(notifier)
 {
 
     session_.login().changed().connect(this, &XGLApplication::authEvent);
@@ -78,6 +86,12 @@ XGLApplication::XGLApplication(const Wt::WEnvironment &env)
 
 void XGLApplication::authEvent()
 {
+    // Whoever is logged in now may keep a different company's books.
+    ledger_.reset();
+    for (std::size_t subscription : subscriptions_)
+        notifier_.unsubscribe(subscription);
+    subscriptions_.clear();
+
     if (session_.login().loggedIn())
     {
         const Wt::Auth::User &u = session_.login().user();
@@ -88,4 +102,49 @@ void XGLApplication::authEvent()
     }
     else
         log("notice") << "User logged out.";
-}
\ No newline at end of file
+}
+
+long long XGLApplication::companyId()
+{
+    Wt::Dbo::Transaction transaction(session_);
+    Wt::Dbo::ptr<User> user = session_.user();
+    return user ? user->companyId : 0;
+}
+
+long long XGLApplication::requireCompany()
+{
+    const long long company = companyId();
+    if (!company)
+        throw std::runtime_error("not logged in to a company");
+    return company;
+}
+
+LedgerSession &XGLApplication::ledger()
+{
+    if (!ledger_)
+        ledger_ = router_.session(requireCompany());
+    return *ledger_;
+}
+
+XGLApplication::~XGLApplication()
+{
+    for (std::size_t subscription : subscriptions_)
+        notifier_.unsubscribe(subscription);
+}
+
+void XGLApplication::watchBalances(const std::vector<long long> &accounts,
+                                   std::function<void(const Balances &)> update)
+{
+    const long long company = requireCompany();
+
+    enableUpdates(true);
+
+    // The notifier calls back on its own thread; hop onto this session's.
+    const std::string id = sessionId();
+    subscriptions_.push_back(notifier_.subscribe(company, accounts, [id, update](const Balances &balances) {
+        Wt::WServer::instance()->post(id, [update, balances]() {
+            update(balances);
+            Wt::WApplication::instance()->triggerUpdate();
+        });
+    }));
+}
@@ -19,14 +19,40 @@
 #include <Wt/WBootstrapTheme.h>
 #include <Wt/WContainerWidget.h>
 #include <Wt/WServer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "StaticAssetResource.h"
 #include "XGLApplication.h"
+#include "db/Checkpointer.h"
 #include "db/DBSession.h"
+#include "db/PostingService.h"
+#include "db/ShardRouter.h"
+#include "accounting/ledger/BalanceNotifier.h"
 
 using namespace db;
+using namespace accounting::ledger;
 
-std::unique_ptr<Wt::WApplication> createApplication(const Wt::WEnvironment& env)
+// The database backend, from the wt_config.xml properties; SQLite files
+// in the approot unless configured otherwise.
+static DatabaseConfig databaseConfig(const Wt::WServer &server)
 {
-  return std::make_unique<XGLApplication>(env);
+    DatabaseConfig config;
+    config.directory = server.appRoot();
+
+    std::string value;
+    if (server.readConfigurationProperty("database-backend", value))
+        config.backend = DatabaseConfig::parseBackend(value);
+    if (server.readConfigurationProperty("database-connection", value))
+        config.connection = value;
+    if (server.readConfigurationProperty("database-pool-size", value))
+        config.poolSize = std::max(1, std::stoi(value));
+    if (server.readConfigurationProperty("database-writers", value))
+        config.writers = std::max(1, std::stoi(value));
+
+    return config;
 }
 
 int main(int argc, char **argv)
@@ -35,7 +61,50 @@ int main(int argc, char **argv)
     {
         Wt::WServer server{argc, argv, WTHTTP_CONFIGURATION};
 
-        server.addEntryPoint(Wt::EntryPointType::Application, createApplication);
+        // Authentication has a database of its own, shared by every
+        // session through one pool; each company's books are in their
+        // own database beside it.
+        const DatabaseConfig config = databaseConfig(server);
+        std::unique_ptr<Wt::Dbo::SqlConnectionPool> authPool = DBSession::createPool(config);
+        ShardRouter router(config);
+
+        // Balances are served from memory.  Pick up where the last
+        // checkpoints left off, so only the journal since them is read,
+        // and keep checkpointing.
+        const std::size_t restored = router.restore();
+        server.log("info") << "Restored the ledger state of " << restored << " companies";
+
+        std::string interval = "300";
+        server.readConfigurationProperty("checkpoint-interval", interval);
+        Checkpointer checkpointer(router, std::chrono::seconds(std::max(1, std::stoi(interval))));
+
+        BalanceNotifier notifier([&router](long long companyId, const std::vector<long long> &accounts) {
+            std::unique_ptr<LedgerSession> ledger = router.session(companyId);
+            return router.cache(companyId).balances(*ledger, accounts);
+        });
+
+        // One posting service for the whole process; every session posts
+        // through it.  More than one writer only helps with PostgreSQL, or
+        // with many companies posting at once.
+        PostingService posting(router, 4096, config.writers);
+        posting.setCommitListener([&notifier](long long companyId, const std::vector<long long> &accounts) {
+            notifier.changed(companyId, accounts);
+        });
+
+        server.addEntryPoint(Wt::EntryPointType::Application,
+                             [&authPool, &router, &posting, &notifier](const Wt::WEnvironment &env) {
+                                 return std::make_unique<XGLApplication>(env, *authPool, router, posting,
+                                                                         notifier);
+                             });
+
+        // The build's fingerprinted, precompressed copy of resources/; see
+        // cmake/assets.cmake.  Without a manifest Wt serves resources/ from
+        // the docroot as before.
+        StaticAssetResource assets(server.appRoot() + "assets");
+        if (assets.loaded())
+            server.addResource(&assets, "/assets");
+        else
+            server.log("warning") << "No assets.manifest in " << server.appRoot() << "assets";
 
         DBSession::configureAuth();
 
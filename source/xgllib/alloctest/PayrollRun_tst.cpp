@@ -0,0 +1,104 @@
+/**
+ * \file PayrollRun_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/payroll/EmployeeStore.h"
+#include "accounting/payroll/PayrollRun.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace accounting::payroll;
+
+// Count every heap allocation made by the test binary.
+static std::atomic<std::size_t> allocations(0);
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned forms.
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    ++allocations;
+    const std::size_t a = static_cast<std::size_t>(align);
+    if (void *p = std::aligned_alloc(a, (size + a - 1) / a * a))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    const std::size_t EMPLOYEES = 100000;
+
+    Employee employee(std::size_t i)
+    {
+        return Employee{ (long long)i, 30000.0 + i, PayPeriod::ePayPeriodBiweekly };
+    }
+}
+
+// Test case: once the run is set up, paying a roster never touches the heap.
+TEST(PayrollRun_tests, no_allocations_paying_roster)
+{
+    Roster r;
+    for (std::size_t i = 0; i < EMPLOYEES; ++i)
+        r.push_back(employee(i));
+    std::vector<YearToDate> ytd(r.size());
+
+    PayrollRun run(2020, 1, 0, r.size());
+
+    const std::size_t before = allocations;
+    run.pay(r, ytd);
+    const std::size_t after = allocations;
+
+    ASSERT_EQ(before, after);
+    ASSERT_EQ(r.size(), run.paychecks().size());
+}
+
+// Test case: nor does paying from an employee store.
+TEST(PayrollRun_tests, no_allocations_paying_store)
+{
+    EmployeeStore store;
+    store.reserve(EMPLOYEES);
+    for (std::size_t i = 0; i < EMPLOYEES; ++i)
+        store.add(employee(i));
+
+    PayrollRun run(2020, 1, 0, store.size());
+
+    const std::size_t before = allocations;
+    run.pay(store);
+    const std::size_t after = allocations;
+
+    ASSERT_EQ(before, after);
+    ASSERT_EQ(store.size(), run.paychecks().size());
+}
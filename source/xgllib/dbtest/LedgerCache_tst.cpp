@@ -0,0 +1,79 @@
+/**
+ * \file LedgerCache_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "db/Employee.h"
+#include "db/LedgerCache.h"
+#include "db/LedgerSession.h"
+#include "db/Paycheck.h"
+#include "db/ShardRouter.h"
+#include <gtest/gtest.h>
+
+#include <Wt/Dbo/Transaction.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+
+using namespace accounting;
+
+TEST(LedgerCache_tests, employee_store)
+{
+    const long long companyId = 42;
+    db::ShardRouter router(::testing::TempDir());
+    std::remove(router.databaseFile(companyId).c_str());
+    std::remove(router.checkpointFile(companyId).c_str());
+    std::filesystem::remove_all(router.archiveDirectory(companyId));
+
+    std::unique_ptr<db::LedgerSession> session = router.session(companyId);
+    {
+        Wt::Dbo::Transaction transaction(*session);
+        session->lockBooks();
+        for (int i = 1; i <= 3; ++i)
+        {
+            auto employee = std::make_unique<db::Employee>();
+            employee->annualWage = 52000 * i;
+            employee->payPeriod = payroll::PayPeriod::ePayPeriodWeekly;
+            session->add(std::move(employee));
+        }
+
+        payroll::Paycheck check = {};
+        check.employee_id = 1;
+        check.oasdi_wages = 1000;
+        check.oasdi_employee = 62;
+        check.futa_wages = 1000;
+        db::addPaycheck(*session, toDays(2020, 12, 31), check);
+        db::addPaycheck(*session, toDays(2021, 1, 8), check);
+        db::addPaycheck(*session, toDays(2021, 1, 15), check);
+        check.employee_id = 3;
+        db::addPaycheck(*session, toDays(2021, 1, 15), check);
+    }
+
+    // The year to date totals come from the in-memory state.
+    db::LedgerCache &cache = router.cache(companyId);
+    payroll::EmployeeStore store = db::loadEmployeeStore(*session, cache, 2021);
+    ASSERT_EQ(3u, store.size());
+    ASSERT_EQ(1, store.id()[0]);
+    ASSERT_DOUBLE_EQ(2000, store.ytdOasdiWages()[0]);
+    ASSERT_DOUBLE_EQ(124, store.ytdOasdi()[0]);
+    ASSERT_DOUBLE_EQ(2000, store.ytdFutaWages()[0]);
+    ASSERT_DOUBLE_EQ(0, store.ytdOasdi()[1]);
+    ASSERT_DOUBLE_EQ(62, store.ytdOasdi()[2]);
+
+    // Paid since are taken in on the next load.
+    {
+        Wt::Dbo::Transaction transaction(*session);
+        session->lockBooks();
+        payroll::Paycheck check = {};
+        check.employee_id = 2;
+        check.oasdi_employee = 124;
+        db::addPaycheck(*session, toDays(2021, 1, 22), check);
+    }
+    store = db::loadEmployeeStore(*session, cache, 2021);
+    ASSERT_DOUBLE_EQ(124, store.ytdOasdi()[1]);
+}
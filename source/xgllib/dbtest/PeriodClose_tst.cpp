@@ -0,0 +1,83 @@
+/**
+ * \file PeriodClose_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "db/JournalEntry.h"
+#include "db/LedgerSession.h"
+#include "db/Paycheck.h"
+#include "db/PeriodClose.h"
+#include "db/ShardRouter.h"
+#include <gtest/gtest.h>
+
+#include <Wt/Dbo/Transaction.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+namespace
+{
+    JournalEntry sale(int date, double amount)
+    {
+        JournalEntry e;
+        e.date = date;
+        e.memo = "Sale";
+        e.lines.push_back(JournalLine{ 1000, amount, "" });
+        e.lines.push_back(JournalLine{ 4000, -amount, "" });
+        return e;
+    }
+}
+
+TEST(PeriodClose_tests, close_year)
+{
+    const long long companyId = 40;
+    db::ShardRouter router(::testing::TempDir());
+    std::remove(router.databaseFile(companyId).c_str());
+    std::filesystem::remove_all(router.archiveDirectory(companyId));
+
+    std::unique_ptr<db::LedgerSession> session = router.session(companyId);
+    {
+        Wt::Dbo::Transaction transaction(*session);
+        session->lockBooks();
+        db::addJournalEntry(*session, sale(toDays(2020, 3, 1), 10));
+        db::addJournalEntry(*session, sale(toDays(2020, 12, 31), 20));
+        db::addJournalEntry(*session, sale(toDays(2021, 1, 1), 40));
+
+        payroll::Paycheck check = {};
+        check.employee_id = 7;
+        check.gross_wages = 1000;
+        db::addPaycheck(*session, toDays(2020, 6, 30), check);
+        db::addPaycheck(*session, toDays(2021, 1, 15), check);
+    }
+
+    const PeriodArchive archive = db::closeYear(*session, 2020);
+    ASSERT_EQ(2u, archive.entries());
+    ASSERT_EQ(4u, archive.lines());
+    ASSERT_EQ(1u, archive.paychecks());
+    ASSERT_THROW(db::closeYear(*session, 2020), std::invalid_argument);
+
+    {
+        Wt::Dbo::Transaction transaction(*session);
+
+        // Only what was archived is gone.
+        ASSERT_EQ(1, session->query<int>("select count(1) from journal_entry"));
+        ASSERT_EQ(2, session->query<int>("select count(1) from journal_line"));
+        ASSERT_EQ(1, session->query<int>("select count(1) from paycheck"));
+
+        // The database knows the year is closed, whatever the archives say.
+        ASSERT_EQ(toDays(2020, 12, 31), session->query<int>("select closed_through from ledger_lock"));
+        session->lockBooks();
+        ASSERT_THROW(db::addJournalEntry(*session, sale(toDays(2020, 12, 31), 1)), std::invalid_argument);
+    }
+
+    Balances balances = db::loadBalances(*session, toDays(2021, 12, 31));
+    ASSERT_DOUBLE_EQ(70, balances[1000]);
+}
@@ -0,0 +1,105 @@
+/**
+ * \file Posting_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "db/ChangeLog.h"
+#include "db/JournalEntry.h"
+#include "db/LedgerSession.h"
+#include "db/PeriodClose.h"
+#include "db/PostingService.h"
+#include "db/ShardRouter.h"
+#include <gtest/gtest.h>
+
+#include <Wt/Dbo/Transaction.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+namespace
+{
+    //! Start a company from nothing
+    void dropCompany(const db::ShardRouter &router, long long companyId)
+    {
+        std::remove(router.databaseFile(companyId).c_str());
+        std::remove(router.checkpointFile(companyId).c_str());
+        std::filesystem::remove_all(router.archiveDirectory(companyId));
+    }
+
+    JournalEntry sale(int date, double amount)
+    {
+        JournalEntry e;
+        e.date = date;
+        e.memo = "Sale";
+        e.lines.push_back(JournalLine{ 1000, amount, "" });
+        e.lines.push_back(JournalLine{ 4000, -amount, "" });
+        return e;
+    }
+}
+
+TEST(Posting_tests, bad_entry_in_batch)
+{
+    const long long companyId = 31;
+    db::ShardRouter router(::testing::TempDir());
+    dropCompany(router, companyId);
+
+    {
+        std::unique_ptr<db::LedgerSession> session = router.session(companyId);
+        {
+            Wt::Dbo::Transaction transaction(*session);
+            session->lockBooks();
+            db::addJournalEntry(*session, sale(toDays(2020, 6, 1), 1));
+        }
+        db::closeYear(*session, 2020);
+    }
+
+    // One entry dated in the closed year fails the group commit; the
+    // others are retried alone and must each post exactly once.
+    std::vector<std::future<long long>> good;
+    std::future<long long> bad;
+    {
+        db::PostingService posting(router, 64);
+        for (int i = 0; i < 10; ++i)
+        {
+            good.push_back(posting.post(companyId, sale(toDays(2021, 1, 1) + i, 10)));
+            if (i == 4)
+                bad = posting.post(companyId, sale(toDays(2020, 12, 31), 1000));
+        }
+    }
+
+    std::set<long long> ids;
+    for (std::future<long long> &id : good)
+        ids.insert(id.get());
+    ASSERT_EQ(good.size(), ids.size());
+    ASSERT_THROW(bad.get(), std::invalid_argument);
+
+    std::unique_ptr<db::LedgerSession> session = router.session(companyId);
+    {
+        Wt::Dbo::Transaction transaction(*session);
+        ASSERT_EQ(10, session->query<int>("select count(1) from journal_entry"));
+        ASSERT_EQ(20, session->query<int>("select count(1) from journal_line"));
+    }
+
+    Balances balances = db::loadBalances(*session, toDays(2021, 12, 31));
+    ASSERT_DOUBLE_EQ(101, balances[1000]);
+    ASSERT_DOUBLE_EQ(-101, balances[4000]);
+
+    db::ChangeCursor cursor(*session);
+    std::size_t posted = 0;
+    for (std::vector<Change> changes; !(changes = cursor.next()).empty();)
+        posted += std::count_if(changes.begin(), changes.end(),
+                                [](const Change &change) { return change.kind == Change::eJournalEntry; });
+    ASSERT_EQ(11u, posted);
+}
@@ -0,0 +1,145 @@
+/**
+ * \file Schema_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "db/DBSession.h"
+#include "db/LedgerSession.h"
+#include "db/Schema.h"
+#include <gtest/gtest.h>
+
+#include <Wt/Auth/Dbo/AuthInfo.h>
+#include <Wt/Dbo/FixedSqlConnectionPool.h>
+#include <Wt/Dbo/Transaction.h>
+#include <Wt/Dbo/backend/Sqlite3.h>
+
+#include <climits>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace
+{
+    //! A pool on a new SQLite database
+    std::unique_ptr<Wt::Dbo::SqlConnectionPool> newDatabase(const char *name)
+    {
+        const std::string file = ::testing::TempDir() + name;
+        std::remove(file.c_str());
+        return std::make_unique<Wt::Dbo::FixedSqlConnectionPool>(
+            std::make_unique<Wt::Dbo::backend::Sqlite3>(file), 1);
+    }
+
+    int schemaVersion(Wt::Dbo::Session &session)
+    {
+        Wt::Dbo::Transaction transaction(session);
+        return session.query<int>("select version from schema_version");
+    }
+
+    //! The version a new company database is created at
+    int latestLedger()
+    {
+        std::unique_ptr<Wt::Dbo::SqlConnectionPool> pool = newDatabase("schema_latest.db");
+        db::migrateLedger(*pool);
+        db::LedgerSession session(*pool);
+        return schemaVersion(session);
+    }
+
+    //! A company database as the first sharded ones were created
+    std::unique_ptr<Wt::Dbo::SqlConnectionPool> firstLedger(const char *name)
+    {
+        std::unique_ptr<Wt::Dbo::SqlConnectionPool> pool = newDatabase(name);
+
+        Wt::Dbo::Session old;
+        old.setConnectionPool(*pool);
+        Wt::Dbo::Transaction transaction(old);
+        old.execute("create table employee (id integer primary key autoincrement, version integer not null)");
+        old.execute("create table paycheck (id integer primary key autoincrement, version integer not null)");
+        old.execute("create table journal_entry (id integer primary key autoincrement, version integer not null, "
+                    "date date, memo text not null)");
+        old.execute("create table journal_line (id integer primary key autoincrement, version integer not null, "
+                    "entry_id bigint, account_id bigint not null, amount real not null, reference text not null)");
+        old.execute("insert into journal_entry (version, date, memo) values (0, '2021-03-09', 'Rent')");
+        old.execute("insert into journal_line (version, entry_id, account_id, amount, reference) "
+                    "values (0, 1, 1000, 12.5, '')");
+        return pool;
+    }
+}
+
+TEST(Schema_tests, new_database)
+{
+    std::unique_ptr<Wt::Dbo::SqlConnectionPool> pool = newDatabase("schema_new.db");
+    ASSERT_TRUE(db::migrateLedger(*pool));
+    ASSERT_FALSE(db::migrateLedger(*pool));
+
+    db::LedgerSession session(*pool);
+    const int version = schemaVersion(session);
+    ASSERT_GE(version, 0);
+
+    // Opening it again runs nothing.
+    ASSERT_FALSE(db::migrateLedger(*pool));
+    ASSERT_EQ(version, schemaVersion(session));
+}
+
+TEST(Schema_tests, currencies)
+{
+    std::unique_ptr<Wt::Dbo::SqlConnectionPool> pool = firstLedger("schema_currencies.db");
+    ASSERT_FALSE(db::migrateLedger(*pool));
+
+    db::LedgerSession session(*pool);
+    ASSERT_EQ(latestLedger(), schemaVersion(session));
+
+    Wt::Dbo::Transaction transaction(session);
+    Wt::Dbo::ptr<db::JournalLine> line = session.find<db::JournalLine>();
+    ASSERT_EQ("USD", line->currency);
+    ASSERT_DOUBLE_EQ(12.5, line->currencyAmount);
+    ASSERT_EQ(0, session.query<int>("select count(1) from exchange_rate"));
+    ASSERT_EQ(0, session.query<int>("select count(1) from account"));
+    ASSERT_EQ(0, session.query<int>("select count(1) from change_log"));
+    ASSERT_EQ(INT_MIN, session.closedThrough());
+}
+
+TEST(Schema_tests, user_company)
+{
+    // An authentication database from before users had a company
+    std::unique_ptr<Wt::Dbo::SqlConnectionPool> pool = newDatabase("schema_auth.db");
+    {
+        Wt::Dbo::Session old;
+        old.setConnectionPool(*pool);
+        Wt::Dbo::Transaction transaction(old);
+        old.execute("create table \"user\" (id integer primary key autoincrement, version integer not null)");
+        old.execute("create table auth_info (id integer primary key autoincrement, version integer not null)");
+        old.execute("insert into \"user\" (version) values (0)");
+    }
+
+    ASSERT_FALSE(db::migrateAuth(*pool));
+
+    db::DBSession session(*pool);
+    ASSERT_EQ(1, schemaVersion(session));
+    {
+        Wt::Dbo::Transaction transaction(session);
+        ASSERT_EQ(0, session.query<long long>("select company_id from \"user\""));
+    }
+}
+
+TEST(Schema_tests, registration)
+{
+    std::unique_ptr<Wt::Dbo::SqlConnectionPool> pool = newDatabase("schema_users.db");
+    ASSERT_TRUE(db::migrateAuth(*pool));
+
+    db::DBSession session(*pool);
+    Wt::Dbo::Transaction transaction(session);
+
+    // Each user registered starts a company of their own.
+    for (int i = 0; i < 2; ++i)
+    {
+        const Wt::Auth::User user = session.users().registerNew();
+        Wt::Dbo::ptr<db::User> record = static_cast<db::UserDatabase &>(session.users()).find(user)->user();
+        ASSERT_TRUE(record);
+        ASSERT_EQ(record.id(), record->companyId);
+        ASSERT_NE(0, record->companyId);
+    }
+    ASSERT_EQ(2, session.query<int>("select count(distinct company_id) from \"user\""));
+}
@@ -0,0 +1,153 @@
+//! \file ChangeFeed.h
+//! \brief Sequenced changes to a company's books, and their export formats
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _ACCOUNTING_CHANGE_FEED_H_
+#define _ACCOUNTING_CHANGE_FEED_H_
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "accounting/ledger/JournalEntry.h"
+#include "accounting/payroll/Paycheck.h"
+
+namespace accounting {
+
+    //! \brief A change to a company's books
+    //!
+    //! One entry in the change feed: a journal entry posted, the change it
+    //! made to an account's balance, a paycheck recorded, or a period
+    //! closed.  Changes are numbered in the order they were committed;
+    //! the sequence number is the consumer's position in the feed.
+    //!
+    //! A change is stored (and exported in binary) as a compact payload:
+    //! zigzag varints, amounts in whole cents, strings length prefixed.
+    struct Change {
+
+        //! \brief What changed
+        enum eKIND {
+            eJournalEntry = 1,  //!< A journal entry was posted
+            eBalance = 2,       //!< An account's balance moved by \p amount
+            ePaycheck = 3,      //!< A paycheck was recorded
+            ePeriodClosed = 4   //!< The books were closed through \p date
+        };
+
+        //! \brief Position in the feed; assigned when recorded
+        long long sequence = 0;
+
+        eKIND kind = eJournalEntry;
+
+        //! \brief Day number the change is dated: the entry's posting date,
+        //! the pay date, or the last day closed
+        int date = 0;
+
+        //! \brief journal_entry id, for eJournalEntry and eBalance
+        long long id = 0;
+
+        //! \brief The entry, for eJournalEntry
+        ledger::JournalEntry entry = {};
+
+        //! \brief The account and the change to its balance, for eBalance
+        long long account_id = 0;
+        double amount = 0;
+
+        //! \brief The paycheck, for ePaycheck
+        payroll::Paycheck paycheck = {};
+
+        //! \brief Get the changes made by posting a journal entry
+        //!
+        //! The entry, then one eBalance per account it posts to, in account
+        //! order.
+        static std::vector<Change> posted(long long entryId, const ledger::JournalEntry& entry);
+
+        //! \brief Get the change made by recording a paycheck
+        static Change paid(int payDate, const payroll::Paycheck& check);
+
+        //! \brief Get the change made by closing the books
+        static Change closed(int lastDay);
+
+        //! \brief Encode the change, less its sequence number
+        std::string encode() const;
+
+        //! \brief Decode a change
+        //!
+        //! \throws std::runtime_error if \p data isn't an encoded change.
+        static Change decode(long long sequence, const std::string& data);
+    };
+
+    //! \brief Change feed writer
+    //!
+    //! Streams changes in one of two formats:
+    //!
+    //! - NDJSON: one JSON object per line, with "seq" and "kind" first;
+    //!   dates are "yyyy-mm-dd" and amounts are numbers.
+    //! - Binary: the bytes "XGLF" and a version byte, then per change the
+    //!   varint difference from the previous sequence number, the varint
+    //!   payload size, and the payload \see Change::encode().  Read it with
+    //!   ChangeReader.
+    class ChangeWriter {
+    public:
+
+        //! \brief Format
+        enum eFORMAT {
+            eNdjson,
+            eBinary
+        };
+
+        //! \brief Constructor; writes the binary header
+        ChangeWriter(std::ostream& out, eFORMAT format);
+
+        //! \brief Write a change
+        void write(const Change& change);
+
+        //! \brief Get the number of changes written
+        std::size_t written() const { return _written; }
+
+    private:
+        std::ostream& _out;
+        eFORMAT _format;
+        long long _sequence;
+        std::size_t _written;
+        std::string _buffer;
+    };
+
+    //! \brief Reads the binary change feed format
+    class ChangeReader {
+    public:
+
+        //! \brief Constructor; reads the header
+        //!
+        //! \throws std::runtime_error if it isn't a change feed.
+        explicit ChangeReader(std::istream& in);
+
+        //! \brief Read the next change
+        //!
+        //! \returns
+        //! false at the end of the feed.
+        //!
+        //! \throws std::runtime_error if the feed is damaged or cut short.
+        bool read(Change& change);
+
+    private:
+        std::istream& _in;
+        long long _sequence;
+    };
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+//! \file Currency.h
+//! \brief Currencies and currency tagged amounts
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _ACCOUNTING_CURRENCY_H_
+#define _ACCOUNTING_CURRENCY_H_
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace accounting {
+
+    //! \brief ISO 4217 currency
+    //!
+    //! The three letter code packed in an integer, so currencies compare
+    //! and hash as cheaply as an int.
+    class Currency {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param code     ISO 4217 code, e.g. "EUR".
+        //!
+        //! \throws std::invalid_argument unless \p code is three upper
+        //!         case letters.
+        explicit Currency(const std::string& code)
+            : _code(0)
+        {
+            if (code.size() != 3)
+                throw std::invalid_argument("bad currency code '" + code + "'");
+            for (char c : code)
+            {
+                if (c < 'A' || c > 'Z')
+                    throw std::invalid_argument("bad currency code '" + code + "'");
+                _code = (_code << 8) | static_cast<std::uint8_t>(c);
+            }
+        }
+
+        //! \brief Get the ISO 4217 code
+        std::string code() const
+        {
+            return std::string{ static_cast<char>(_code >> 16), static_cast<char>(_code >> 8), static_cast<char>(_code) };
+        }
+
+        //! \brief Get the packed code, for hashing
+        std::uint32_t packed() const { return _code; }
+
+        bool operator==(const Currency& other) const { return _code == other._code; }
+        bool operator!=(const Currency& other) const { return _code != other._code; }
+        bool operator<(const Currency& other) const { return _code < other._code; }
+
+    private:
+        std::uint32_t _code;
+    };
+
+    //! \brief US dollar, the currency ledger amounts are kept in
+    inline const Currency USD("USD");
+
+    //! \brief An amount tagged with its currency
+    struct Money {
+
+        //! \brief Amount, in \p currency
+        double amount;
+
+        //! \brief Currency of the amount
+        Currency currency;
+    };
+
+}
+
+namespace std {
+
+    template<>
+    struct hash<accounting::Currency> {
+        std::size_t operator()(const accounting::Currency& currency) const
+        {
+            return std::hash<std::uint32_t>()(currency.packed());
+        }
+    };
+
+}
+
+#endif
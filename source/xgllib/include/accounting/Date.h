@@ -0,0 +1,57 @@
+//! \file Date.h
+//! \brief Calendar dates as day numbers
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _ACCOUNTING_DATE_H_
+#define _ACCOUNTING_DATE_H_
+
+namespace accounting {
+
+    //! \brief Convert a calendar date to a day number
+    //!
+    //! Dates in the accounting code are held as the number of days since
+    //! 1970-01-01, so date ranges and windows are plain integer arithmetic.
+    //!
+    //! \param year     Year
+    //! \param month    Month (1 - 12)
+    //! \param day      Day of the month (1 - 31)
+    inline int toDays(int year, int month, int day)
+    {
+        year -= month <= 2;
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int yoe = year - era * 400;
+        const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    //! \brief Convert a day number back to a calendar date
+    inline void fromDays(int days, int& year, int& month, int& day)
+    {
+        days += 719468;
+        const int era = (days >= 0 ? days : days - 146096) / 146097;
+        const int doe = days - era * 146097;
+        const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int mp = (5 * doy + 2) / 153;
+        day = doy - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = yoe + era * 400 + (month <= 2);
+    }
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+//! \file LedgerState.h
+//! \brief In-memory ledger state and its checkpoint file
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _ACCOUNTING_LEDGER_STATE_H_
+#define _ACCOUNTING_LEDGER_STATE_H_
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "accounting/ledger/BalanceNotifier.h"
+#include "accounting/payroll/Paycheck.h"
+
+namespace accounting {
+
+    //! \brief An employee's year to date payroll totals, as recorded
+    //!
+    //! \see payroll::YearToDate for the totals a payroll run carries.
+    struct PayrollTotals {
+
+        //! \brief Social security taxable wages paid
+        double oasdi_wages;
+
+        //! \brief Social security tax withheld
+        double oasdi_employee;
+
+        //! \brief FUTA taxable wages paid
+        double futa_wages;
+    };
+
+    //! \brief In-memory ledger state
+    //!
+    //! A company's running totals: every account's balance and every
+    //! employee's year to date payroll, kept in memory so they can be
+    //! answered without reading the journal.  The state remembers the last
+    //! journal line and paycheck (by id) that it has taken in, so it can be
+    //! brought up to date by applying only the rows recorded after them.
+    //!
+    //! checkpoint() saves the state to a file, and the file constructor
+    //! reads it back; a server restart then costs the rows recorded since
+    //! the checkpoint rather than the whole history.
+    //!
+    //! The checkpoint is a fixed header followed by two arrays of fixed
+    //! size records, sorted by key: balances by account, year to date
+    //! totals by employee and year.  Amounts are whole cents.  It is read
+    //! by mapping it into memory, and a checksum of the whole file (header
+    //! included) guards against damage.
+    //! Like an archive, it's written to a temporary name, synced, and
+    //! renamed into place.
+    //!
+    //! Not synchronized; the owner serializes access.
+    class LedgerState {
+    public:
+
+        //! \brief Constructor, for an empty state
+        LedgerState();
+
+        //! \brief Constructor; reads a checkpoint file
+        //!
+        //! \throws std::runtime_error if the file can't be read or is damaged.
+        explicit LedgerState(const std::string& file);
+
+        //! \brief Write a checkpoint file
+        //!
+        //! \throws std::runtime_error if the file can't be written.
+        void checkpoint(const std::string& file) const;
+
+        //! \brief Take in a journal line
+        //!
+        //! \param lineId   journal_line id; the last line becomes the
+        //!                 highest id taken in.
+        void post(long long lineId, long long accountId, double amount);
+
+        //! \brief Take in a paycheck
+        //!
+        //! \param paycheckId   paycheck id; the last paycheck becomes the
+        //!                     highest id taken in.
+        void pay(long long paycheckId, const payroll::Paycheck& check);
+
+        //! \brief Forget a year's payroll totals, to take them in again
+        void clearYear(int year);
+
+        //! \brief Get the highest journal_line id taken in; 0 if none
+        long long lastLine() const { return _last_line; }
+
+        //! \brief Get the highest paycheck id taken in; 0 if none
+        long long lastPaycheck() const { return _last_paycheck; }
+
+        //! \brief Get the last day of the closed periods taken in
+        //!
+        //! INT_MIN if none.
+        int closedThrough() const { return _closed_through; }
+
+        //! \brief Set the last day of the closed periods taken in
+        void closedThrough(int date) { _closed_through = date; }
+
+        //! \brief Get the number of accounts with postings
+        std::size_t accounts() const { return _balances.size(); }
+
+        //! \brief Get an account's balance
+        double balance(long long accountId) const;
+
+        //! \brief Get the balances of a set of accounts
+        //!
+        //! Accounts with no postings have a zero balance.
+        ledger::Balances balances(const std::vector<long long>& accounts) const;
+
+        //! \brief Get an employee's year to date totals
+        PayrollTotals yearToDate(long long employeeId, int year) const;
+
+    private:
+        struct YearKey {
+            long long employee;
+            int year;
+            bool operator==(const YearKey& other) const
+            {
+                return employee == other.employee && year == other.year;
+            }
+        };
+
+        struct YearKeyHash {
+            std::size_t operator()(const YearKey& key) const
+            {
+                return std::hash<long long>()(key.employee * 1000003 ^ key.year);
+            }
+        };
+
+        struct Totals {
+            long long oasdi_wages;
+            long long oasdi_employee;
+            long long futa_wages;
+        };
+
+        long long _last_line;
+        long long _last_paycheck;
+        int _closed_through;
+
+        // In cents
+        std::unordered_map<long long, long long> _balances;
+        std::unordered_map<YearKey, Totals, YearKeyHash> _ytd;
+    };
+
+}
+
+#endif
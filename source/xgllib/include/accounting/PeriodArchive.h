@@ -0,0 +1,199 @@
+//! \file PeriodArchive.h
+//! \brief Compressed columnar archive of a closed accounting period
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _ACCOUNTING_PERIOD_ARCHIVE_H_
+#define _ACCOUNTING_PERIOD_ARCHIVE_H_
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "accounting/Currency.h"
+#include "accounting/ledger/BalanceNotifier.h"
+#include "accounting/ledger/JournalEntry.h"
+#include "accounting/ledger/Reconciliation.h"
+#include "accounting/ledger/Revaluation.h"
+#include "accounting/payroll/Paycheck.h"
+
+namespace accounting {
+
+    //! \brief A journal entry's header, as archived
+    struct ArchivedEntry {
+
+        //! \brief journal_entry id
+        long long id;
+
+        //! \brief Posting date, day number \see toDays()
+        int date;
+
+        //! \brief Description of the entry
+        std::string memo;
+    };
+
+    //! \brief A journal line, as archived
+    struct ArchivedLine {
+
+        //! \brief journal_line id
+        long long id;
+
+        //! \brief Entry the line belongs to
+        long long entry_id;
+
+        //! \brief The entry's posting date, day number
+        int date;
+
+        //! \brief The line
+        ledger::JournalLine line;
+    };
+
+    //! \brief A paycheck, as archived
+    struct ArchivedPaycheck {
+
+        //! \brief Pay date, day number; the check's year and month follow from it
+        int pay_date;
+
+        //! \brief The check
+        payroll::Paycheck check;
+    };
+
+    //! \brief Closed period archive
+    //!
+    //! The journal and payroll history of a closed period, moved out of
+    //! the company database into an immutable file.  The file is column
+    //! oriented: each field of every row is stored together, so that
+    //! similar values sit next to each other and encode small.
+    //!
+    //! - Accounts and currencies are dictionary encoded; a line stores an
+    //!   index into the period's sorted account and currency lists.
+    //! - Rows are sorted by date (paychecks by employee, then date) and
+    //!   dates and ids are stored as deltas from the previous row.
+    //! - Amounts are whole cents.  Paycheck amounts are deltas from the
+    //!   employee's previous check, which is usually the same.
+    //! - Every integer is a zigzag varint, so small deltas take a byte.
+    //!
+    //! A checksum over the whole file guards against damage.  The file is
+    //! written to a temporary name, synced, and renamed into place, so a
+    //! reader never sees half an archive.
+    //!
+    //! Once read, an archive answers the same questions the database does
+    //! (balances, an account's lines, foreign balances, payroll history)
+    //! for its period, so that callers can merge the two.
+    class PeriodArchive {
+    public:
+
+        //! \brief Constructor, for an empty archive to add to
+        //!
+        //! \param first, last  The period covered, day numbers.
+        PeriodArchive(int first, int last);
+
+        //! \brief Constructor; reads an archive file
+        //!
+        //! \throws std::runtime_error if the file can't be read or is damaged.
+        explicit PeriodArchive(const std::string& file);
+
+        //! \brief Add a journal entry's header
+        void add(const ArchivedEntry& entry);
+
+        //! \brief Add a journal line
+        //!
+        //! Amounts are kept to the cent.
+        void add(const ArchivedLine& line);
+
+        //! \brief Add a paycheck
+        void add(const ArchivedPaycheck& paycheck);
+
+        //! \brief Write the archive to a file
+        //!
+        //! \throws std::runtime_error if the file can't be written.
+        void write(const std::string& file) const;
+
+        //! \brief Get the first day of the period
+        int first() const { return _first; }
+
+        //! \brief Get the last day of the period
+        int last() const { return _last; }
+
+        //! \brief Get the number of journal entries
+        std::size_t entries() const { return _entry_id.size(); }
+
+        //! \brief Get the number of journal lines
+        std::size_t lines() const { return _line_id.size(); }
+
+        //! \brief Get the number of paychecks
+        std::size_t paychecks() const { return _paychecks.size(); }
+
+        //! \brief Get a journal entry's header
+        ArchivedEntry entry(std::size_t i) const;
+
+        //! \brief Get a journal line
+        ArchivedLine line(std::size_t i) const;
+
+        //! \brief Get a paycheck
+        const ArchivedPaycheck& paycheck(std::size_t i) const { return _paychecks[i]; }
+
+        //! \brief Add the period's postings, up to and including a day, to
+        //! account balances
+        void addBalances(ledger::Balances& balances, int date) const;
+
+        //! \brief Add the period's postings to the balances of a set of accounts
+        void addBalances(ledger::Balances& balances, const std::vector<long long>& accounts) const;
+
+        //! \brief Add an account's lines over a date range, in date order
+        void addAccountLines(std::vector<ledger::CashLine>& lines, long long accountId, int from, int to) const;
+
+        //! \brief Get the foreign currency balances of the period's
+        //! postings up to and including a day, by account and currency
+        std::vector<ledger::ForeignBalance> foreignBalances(int date) const;
+
+        //! \brief Add the paychecks paid in a calendar year
+        void addPaychecks(std::vector<payroll::Paycheck>& history, int year) const;
+
+    private:
+        std::uint32_t accountIndex(long long accountId);
+        std::uint32_t currencyIndex(Currency currency);
+
+        int _first;
+        int _last;
+
+        // Journal entries
+        std::vector<long long> _entry_id;
+        std::vector<int> _entry_date;
+        std::vector<std::string> _memo;
+
+        // Journal lines; amounts in cents
+        std::vector<long long> _line_id;
+        std::vector<long long> _line_entry;
+        std::vector<int> _line_date;
+        std::vector<std::uint32_t> _line_account;
+        std::vector<long long> _amount;
+        std::vector<std::string> _reference;
+        std::vector<std::uint32_t> _line_currency;
+        std::vector<long long> _currency_amount;
+
+        // Dictionaries, and the total posted to each account in cents
+        std::vector<long long> _accounts;
+        std::unordered_map<long long, std::uint32_t> _account_index;
+        std::vector<long long> _account_total;
+        std::vector<Currency> _currencies;
+
+        std::vector<ArchivedPaycheck> _paychecks;
+    };
+
+}
+
+#endif
@@ -0,0 +1,130 @@
+//! \file BalanceNotifier.h
+//! \brief Account balance change notifications
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _BALANCE_NOTIFIER_H_
+#define _BALANCE_NOTIFIER_H_
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace accounting {
+namespace ledger {
+
+    //! \brief Account balances, by account id
+    using Balances = std::unordered_map<long long, double>;
+
+    //! \brief Account balance notifier
+    //!
+    //! Publish/subscribe for account balances.  Subscribers name the
+    //! company and accounts they show; the posting side reports which
+    //! accounts changed.
+    //! Changes are collected over a short window, then the current balances
+    //! of the changed accounts that anyone is watching are read once, and
+    //! each subscriber is handed the ones it asked for.  However many
+    //! subscribers watch an account, a batch of changes costs one read per
+    //! company.
+    //!
+    //! Loading and delivery happen on the notifier's own thread; listeners
+    //! must hand off to their own thread (e.g. Wt::WServer::post) rather
+    //! than touch UI state directly.  A read that throws is logged and
+    //! tried again after the next window; a listener that throws is logged.
+    class BalanceNotifier {
+    public:
+
+        //! \brief Reads the current balances of a set of one company's accounts
+        using Loader = std::function<Balances(long long company, const std::vector<long long>& accounts)>;
+
+        //! \brief Receives the new balances of the subscribed accounts
+        using Listener = std::function<void(const Balances& balances)>;
+
+        //! \brief Constructor; starts the notifier thread
+        //!
+        //! \param loader   Reads balances; only ever called on the
+        //!                 notifier thread.
+        //! \param window   How long to collect changes before reading.
+        BalanceNotifier(Loader loader, std::chrono::milliseconds window = std::chrono::milliseconds(200));
+
+        //! \brief Destructor; stops the notifier thread
+        ~BalanceNotifier();
+
+        BalanceNotifier(const BalanceNotifier&) = delete;
+        BalanceNotifier& operator=(const BalanceNotifier&) = delete;
+
+        //! \brief Subscribe to a set of a company's accounts
+        //!
+        //! \returns
+        //! The subscription id, for unsubscribe().
+        std::size_t subscribe(long long company, const std::vector<long long>& accounts, Listener listener);
+
+        //! \brief Cancel a subscription
+        void unsubscribe(std::size_t subscription);
+
+        //! \brief Report accounts whose balances changed
+        //!
+        //! Safe to call from any thread; doesn't block on the read.
+        void changed(long long company, const std::vector<long long>& accounts);
+
+    private:
+        struct AccountKey {
+            long long company;
+            long long account;
+            bool operator==(const AccountKey& other) const
+            {
+                return company == other.company && account == other.account;
+            }
+        };
+
+        struct AccountKeyHash {
+            std::size_t operator()(const AccountKey& key) const
+            {
+                return std::hash<long long>()(key.company * 1000003 ^ key.account);
+            }
+        };
+
+        struct Subscription {
+            long long company;
+            std::vector<long long> accounts;
+            Listener listener;
+        };
+
+        void run();
+
+        Loader _loader;
+        std::chrono::milliseconds _window;
+
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        bool _stop;
+        std::unordered_set<AccountKey, AccountKeyHash> _dirty;
+        std::size_t _next_id;
+        std::unordered_map<std::size_t, Subscription> _subscriptions;
+        std::unordered_map<AccountKey, std::vector<std::size_t>, AccountKeyHash> _watchers;
+
+        std::thread _thread;
+    };
+
+}
+}
+
+#endif
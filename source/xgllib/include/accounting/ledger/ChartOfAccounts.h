@@ -0,0 +1,136 @@
+//! \file ChartOfAccounts.h
+//! \brief Chart of accounts hierarchy
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _CHART_OF_ACCOUNTS_H_
+#define _CHART_OF_ACCOUNTS_H_
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "accounting/ledger/BalanceNotifier.h"
+
+namespace accounting {
+namespace ledger {
+
+    //! \brief An account in the chart
+    struct Account {
+
+        //! \brief Account id, as posted to by journal lines
+        long long id;
+
+        //! \brief Parent account id; 0 for a top level account
+        long long parent_id;
+
+        //! \brief Account number, e.g. "1010"; orders siblings
+        std::string number;
+
+        //! \brief Account name
+        std::string name;
+    };
+
+    //! \brief Chart of accounts
+    //!
+    //! The account tree flattened into one array in depth first (pre)order,
+    //! siblings by account number.  Every account's descendants follow it
+    //! directly, so a subtree is the contiguous range [begin, end) of
+    //! positions: the account's nested interval.  "Is A under B" is two
+    //! comparisons, and anything summed over a subtree can be summed over a
+    //! range instead of walking the tree.  \see Rollup
+    class ChartOfAccounts {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param accounts     Every account, in any order.
+        //!
+        //! \throws std::invalid_argument on a duplicate id, an unknown
+        //!         parent, or a cycle.
+        ChartOfAccounts(const std::vector<Account>& accounts);
+
+        //! \brief Get the number of accounts
+        std::size_t size() const { return _accounts.size(); }
+
+        //! \brief Get the account at a position
+        const Account& at(std::size_t position) const { return _accounts[position]; }
+
+        //! \brief Get an account's depth; top level accounts are 0
+        int depth(std::size_t position) const { return _depth[position]; }
+
+        //! \brief Get one past an account's last descendant
+        std::size_t end(std::size_t position) const { return _end[position]; }
+
+        //! \brief Get an account's position
+        //!
+        //! \throws std::out_of_range for an unknown account.
+        std::size_t position(long long id) const { return _position.at(id); }
+
+        //! \brief Check whether one account is in another's subtree
+        //!
+        //! An account is in its own subtree.
+        bool contains(long long ancestor, long long id) const;
+
+    private:
+        std::vector<Account> _accounts;
+        std::vector<int> _depth;
+        std::vector<std::size_t> _end;
+        std::unordered_map<long long, std::size_t> _position;
+    };
+
+    //! \brief Subtree balance rollups
+    //!
+    //! Prefix sums of the account balances in chart order.  The total of
+    //! any account's subtree is the difference of the prefix sums at the
+    //! ends of its interval, so every rollup is O(1) after one O(n) pass,
+    //! and a full balance sheet is one walk down the array.  The sums are
+    //! kept in cents, so the differences are exact.
+    class Rollup {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param chart        The chart of accounts; must outlive the rollup.
+        //! \param balances     Balances by account id; accounts not in the
+        //!                     chart are ignored, missing ones are zero.
+        Rollup(const ChartOfAccounts& chart, const Balances& balances);
+
+        //! \brief Get the total of the account at a position and everything under it
+        double totalAt(std::size_t position) const
+        {
+            return (_prefix[_chart.end(position)] - _prefix[position]) / 100.0;
+        }
+
+        //! \brief Get the total of an account and everything under it
+        //!
+        //! \throws std::out_of_range for an unknown account.
+        double total(long long id) const { return totalAt(_chart.position(id)); }
+
+        //! \brief Get the balance posted to the account at a position itself
+        double balanceAt(std::size_t position) const
+        {
+            return (_prefix[position + 1] - _prefix[position]) / 100.0;
+        }
+
+    private:
+        const ChartOfAccounts& _chart;
+        std::vector<long long> _prefix;
+    };
+
+}
+}
+
+#endif
@@ -0,0 +1,86 @@
+//! \file ExchangeRates.h
+//! \brief Daily exchange rate table
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _EXCHANGE_RATES_H_
+#define _EXCHANGE_RATES_H_
+#include <unordered_map>
+#include <vector>
+
+#include "accounting/Currency.h"
+
+namespace accounting {
+namespace ledger {
+
+    //! \brief Daily exchange rates
+    //!
+    //! Each currency's rates against USD are a dense array indexed by day
+    //! number, so a lookup is a hash on the currency and an array index, and
+    //! a cross rate is two lookups.  Days without a published rate (weekends,
+    //! bank holidays) carry the last rate before them; days after the last
+    //! rate use that rate.
+    class ExchangeRates {
+    public:
+
+        //! \brief Set a day's rate
+        //!
+        //! \param currency     The foreign currency.
+        //! \param date         Day number \see toDays()
+        //! \param rate         USD per unit of \p currency.
+        void set(const Currency& currency, int date, double rate);
+
+        //! \brief Get a currency's rate on a day
+        //!
+        //! \returns
+        //! USD per unit of \p currency; 1 for USD.
+        //!
+        //! \throws std::out_of_range if there is no rate on or before \p date.
+        double rate(const Currency& currency, int date) const;
+
+        //! \brief Get the rate between two currencies on a day
+        //!
+        //! \returns
+        //! Units of \p to per unit of \p from.
+        double rate(const Currency& from, const Currency& to, int date) const
+        {
+            return rate(from, date) / rate(to, date);
+        }
+
+        //! \brief Convert an amount to another currency at a day's rate
+        Money convert(const Money& money, const Currency& to, int date) const
+        {
+            return Money{ money.amount * rate(money.currency, to, date), to };
+        }
+
+        //! \brief Check for any rate for a currency
+        bool has(const Currency& currency) const { return currency == USD || _series.count(currency) != 0; }
+
+    private:
+
+        //! One currency's rates from its first day on.
+        struct Series {
+            int first;
+            std::vector<double> rates;
+            std::vector<bool> published;
+        };
+
+        std::unordered_map<Currency, Series> _series;
+    };
+
+}
+}
+
+#endif
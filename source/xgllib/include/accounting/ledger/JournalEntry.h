@@ -0,0 +1,82 @@
+//! \file JournalEntry.h
+//! \brief General ledger journal entry
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _JOURNAL_ENTRY_H_
+#define _JOURNAL_ENTRY_H_
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "accounting/Currency.h"
+
+namespace accounting {
+
+//! \brief General ledger namespace
+namespace ledger {
+
+    //! \brief One line of a journal entry
+    struct JournalLine {
+
+        //! \brief Account the line posts to
+        long long account_id;
+
+        //! \brief Amount in USD; debits are positive, credits negative
+        double amount;
+
+        //! \brief External reference (check number, bank reference, ...)
+        std::string reference;
+
+        //! \brief Currency the transaction was in
+        Currency currency = USD;
+
+        //! \brief Amount in \p currency, for foreign currency lines
+        //!
+        //! \p amount is this at the day's rate.  Ignored for USD lines.
+        double currency_amount = 0;
+    };
+
+    //! \brief Journal entry
+    //!
+    //! A dated set of lines that together must balance to zero.
+    struct JournalEntry {
+
+        //! \brief Posting date, in days since 1970-01-01 \see toDays()
+        int date;
+
+        //! \brief Description of the entry
+        std::string memo;
+
+        //! \brief The debit and credit lines
+        std::vector<JournalLine> lines;
+
+        //! \brief Check that debits equal credits
+        //!
+        //! \returns
+        //! true if the entry has lines and they sum to zero, to the cent.
+        bool balanced() const
+        {
+            double total = 0;
+            for (const JournalLine &line : lines)
+                total += line.amount;
+            return !lines.empty() && std::fabs(total) < 0.005;
+        }
+    };
+
+}
+}
+
+#endif
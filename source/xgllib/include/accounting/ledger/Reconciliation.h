@@ -0,0 +1,153 @@
+//! \file Reconciliation.h
+//! \brief Bank statement reconciliation
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _RECONCILIATION_H_
+#define _RECONCILIATION_H_
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace accounting {
+namespace ledger {
+
+    //! \brief A dated cash movement
+    //!
+    //! Either a bank statement line or a journal line on the cash account.
+    struct CashLine {
+
+        //! \brief Statement line number, or journal line id
+        long long id;
+
+        //! \brief Date, in days since 1970-01-01 \see toDays()
+        int date;
+
+        //! \brief Amount; deposits positive, withdrawals negative
+        double amount;
+
+        //! \brief Bank reference or check number, may be empty
+        std::string reference;
+    };
+
+    //! \brief Statement lines and ledger lines that reconcile
+    struct ReconciliationMatch {
+
+        //! \brief How the lines were matched, most certain first
+        enum eMATCH_KIND {
+
+            //! \brief Same amount, date and reference
+            eMatchExact,
+
+            //! \brief Same amount and date
+            eMatchAmountDate,
+
+            //! \brief Same amount, dates within the tolerance
+            eMatchDateWindow,
+
+            //! \brief One line against several that sum to it, within the
+            //! date tolerance (a batched deposit, a payment in parts)
+            eMatchSplit
+        };
+
+        eMATCH_KIND kind;
+
+        //! \brief Ids of the statement lines
+        std::vector<long long> statement;
+
+        //! \brief Ids of the ledger lines
+        std::vector<long long> ledger;
+    };
+
+    //! \brief Reconciliation tuning
+    struct ReconciliationOptions {
+
+        //! \brief Days a bank date may differ from the ledger date
+        int date_tolerance = 3;
+
+        //! \brief Most lines one line may be split across
+        unsigned max_split_parts = 3;
+
+        //! \brief Most lines (nearest by date) searched for the parts of a split
+        std::size_t max_split_candidates = 24;
+    };
+
+    //! \brief Bank statement reconciliation
+    //!
+    //! Matches statement lines against the cash account's journal lines in
+    //! passes, each only over what the earlier ones left unmatched:
+    //!
+    //! 1. exact: a hash index on (amount, date, reference),
+    //! 2. amount and date: a hash index on (amount, date),
+    //! 3. date window: lines with the same amount, nearest date within the
+    //!    tolerance,
+    //! 4. splits: one line against two or more on the other side that sum
+    //!    to it, in both directions.
+    //!
+    //! The first two are a single O(n) probe per statement line.  The date
+    //! window pass is partitioned by amount, since only equal amounts can
+    //! match, and the partitions run on worker threads without locking.  The
+    //! split search is bounded by the options; workers propose splits for
+    //! their share of the lines, then the proposals are accepted in statement
+    //! order.  The result doesn't depend on the number of threads.
+    class Reconciliation {
+    public:
+
+        //! \brief Constructor
+        Reconciliation(const ReconciliationOptions& options = ReconciliationOptions());
+
+        //! \brief Match a statement against the ledger
+        //!
+        //! \param statement    Bank statement lines, in statement order.
+        //! \param ledger       Cash account journal lines over the same
+        //!                     period (plus the tolerance either side).
+        //! \param threads      Number of worker threads; 0 uses the
+        //!                     hardware concurrency.
+        void reconcile(const std::vector<CashLine>& statement, const std::vector<CashLine>& ledger,
+                       unsigned threads = 0);
+
+        //! \brief Get the matches, by kind then statement order
+        const std::vector<ReconciliationMatch>& matches() const { return _matches; }
+
+        //! \brief Get the number of matches of one kind
+        std::size_t count(ReconciliationMatch::eMATCH_KIND kind) const;
+
+        //! \brief Get the ids of the statement lines left unmatched
+        const std::vector<long long>& unmatchedStatement() const { return _unmatched_statement; }
+
+        //! \brief Get the ids of the ledger lines left unmatched
+        const std::vector<long long>& unmatchedLedger() const { return _unmatched_ledger; }
+
+    private:
+        ReconciliationOptions _options;
+        std::vector<ReconciliationMatch> _matches;
+        std::vector<long long> _unmatched_statement;
+        std::vector<long long> _unmatched_ledger;
+    };
+
+    //! \brief Read a bank statement export
+    //!
+    //! CSV lines of "yyyy-mm-dd,amount,reference", the reference optional
+    //! and possibly quoted.  A header line is skipped.  Each line's id is
+    //! its line number.
+    //!
+    //! \throws std::invalid_argument naming the first malformed line
+    std::vector<CashLine> readStatement(std::istream& in);
+
+}
+}
+
+#endif
@@ -0,0 +1,107 @@
+//! \file Revaluation.h
+//! \brief Period end foreign currency revaluation
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _REVALUATION_H_
+#define _REVALUATION_H_
+#include <cstddef>
+#include <vector>
+
+#include "accounting/Currency.h"
+#include "accounting/ledger/ExchangeRates.h"
+#include "accounting/ledger/JournalEntry.h"
+
+namespace accounting {
+namespace ledger {
+
+    //! \brief An account's balance in one foreign currency
+    struct ForeignBalance {
+
+        //! \brief The account
+        long long account_id;
+
+        //! \brief The foreign currency
+        Currency currency;
+
+        //! \brief Balance in \p currency
+        double currency_balance;
+
+        //! \brief The balance as carried in USD
+        double book_balance;
+    };
+
+    //! \brief Period end revaluation
+    //!
+    //! Restates foreign currency balances at the period end rate and posts
+    //! the difference from their USD carrying amount as unrealized exchange
+    //! gain or loss.
+    //!
+    //! Balances are held one array per field.  Rates are looked up once per
+    //! currency and spread into a column, so the adjustments are a single
+    //! branch free pass of multiply, subtract and round over contiguous
+    //! columns, which the compiler can vectorize.
+    class Revaluation {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param gain_loss_account    Account for unrealized exchange gains
+        //!                             and losses.
+        Revaluation(long long gain_loss_account);
+
+        //! \brief Reserve room for a number of balances
+        void reserve(std::size_t balances);
+
+        //! \brief Add a balance to revalue
+        void add(const ForeignBalance& balance);
+
+        //! \brief Get the number of balances
+        std::size_t size() const { return _account.size(); }
+
+        //! \brief Revalue every balance
+        //!
+        //! \param rates    Exchange rates.
+        //! \param date     Period end, day number \see toDays()
+        //!
+        //! \returns
+        //! The revaluation entry, dated \p date: a line for each balance that
+        //! moved by a cent or more, and the offset to the gain and loss
+        //! account.  No lines if nothing moved.
+        //!
+        //! \throws std::out_of_range if a currency has no rate for \p date.
+        JournalEntry revalue(const ExchangeRates& rates, int date);
+
+        //! \brief Get a balance's adjustment from the last revalue()
+        double adjustment(std::size_t i) const { return _adjustment[i]; }
+
+        //! \brief Get the net unrealized gain (positive) or loss from the last revalue()
+        double gain() const { return _gain; }
+
+    private:
+        long long _gain_loss_account;
+        std::vector<long long> _account;
+        std::vector<Currency> _currency;
+        std::vector<double> _currency_balance;
+        std::vector<double> _book_balance;
+        std::vector<double> _rate;
+        std::vector<double> _adjustment;
+        double _gain;
+    };
+
+}
+}
+
+#endif
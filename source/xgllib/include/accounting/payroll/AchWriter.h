@@ -0,0 +1,190 @@
+//! \file AchWriter.h
+//! \brief NACHA ACH direct deposit file writer
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _ACH_WRITER_H_
+#define _ACH_WRITER_H_
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "accounting/payroll/Paycheck.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief An employee's direct deposit account
+    //!
+    //! Fixed width, space padded fields, laid out as they go in the entry
+    //! detail record so writing one is a copy.
+    struct DirectDeposit {
+
+        //! \brief Account type
+        enum eACCOUNT_TYPE {
+            eAccountChecking,
+            eAccountSavings
+        };
+
+        //! \brief Routing number of the employee's bank (9 digits, with
+        //! check digit); 0 for no direct deposit
+        std::uint32_t routing;
+
+        //! \brief Account number, left justified
+        char account[17];
+
+        //! \brief Employee's name as the bank should see it, left justified
+        char name[22];
+
+        eACCOUNT_TYPE type;
+
+        //! \brief Make a deposit account, padding and truncating the fields
+        static DirectDeposit make(std::uint32_t routing, const std::string& account, const std::string& name,
+                                  eACCOUNT_TYPE type = eAccountChecking);
+
+        //! \brief Check a routing number's ABA check digit
+        static bool validRouting(std::uint32_t routing);
+    };
+
+    //! \brief The company originating the file
+    struct AchOrigin {
+
+        //! \brief Immediate destination: routing number of the bank (or
+        //! ACH operator) the file is sent to
+        std::uint32_t destination_routing;
+
+        //! \brief Immediate destination name
+        std::string destination_name;
+
+        //! \brief Immediate origin, usually "1" and the EIN
+        std::string origin_id;
+
+        //! \brief Immediate origin name
+        std::string origin_name;
+
+        //! \brief Company name on the employees' statements
+        std::string company_name;
+
+        //! \brief Company identification, usually "1" and the EIN
+        std::string company_id;
+
+        //! \brief Routing number of the originating bank
+        std::uint32_t odfi_routing;
+    };
+
+    //! \brief NACHA ACH file writer
+    //!
+    //! Writes a PPD credit file of 94 character records, blocked in tens.
+    //! Records are formatted straight into a block buffer, digits by hand,
+    //! and the buffer goes to the stream whenever it fills, so the file is
+    //! written in one pass without building a string per employee.  Entry
+    //! counts, entry hashes and totals for the batch and file controls are
+    //! accumulated as the entries go by.
+    //!
+    //! Usage:
+    //!
+    //!     AchWriter ach(out, origin, today, minutes);
+    //!     ach.beginBatch(payDate, "PAYROLL");
+    //!     ach.deposit(run.paychecks(), deposits);
+    //!     ach.endBatch();
+    //!     ach.finish();
+    class AchWriter {
+    public:
+
+        //! \brief Constructor; writes the file header
+        //!
+        //! \param out          Where the file goes.
+        //! \param origin       The originating company and banks.
+        //! \param created      File creation date, day number \see toDays()
+        //! \param minutes      File creation time, minutes after midnight.
+        //! \param modifier     File id modifier (A - Z, 0 - 9), to tell
+        //!                     apart files created on the same day.
+        //!
+        //! \throws std::invalid_argument if a routing number is bad.
+        AchWriter(std::ostream& out, const AchOrigin& origin, int created, int minutes, char modifier = 'A');
+
+        AchWriter(const AchWriter&) = delete;
+        AchWriter& operator=(const AchWriter&) = delete;
+
+        //! \brief Start a batch of credits
+        //!
+        //! \param effective    Settlement date wanted, day number.
+        //! \param description  Entry description, e.g. "PAYROLL".
+        void beginBatch(int effective, const std::string& description);
+
+        //! \brief Add one credit entry
+        //!
+        //! \param id       Individual identification number (employee id).
+        //! \param cents    Amount; must be positive.
+        //! \param account  Where it goes.
+        //!
+        //! \throws std::invalid_argument on a bad routing number or amount.
+        void credit(long long id, long long cents, const DirectDeposit& account);
+
+        //! \brief Add the net pay of a run's paychecks
+        //!
+        //! \param paychecks    A payroll run's paychecks.
+        //! \param accounts     Deposit accounts, parallel to \p paychecks.
+        //!                     Employees with no account (routing 0) or no
+        //!                     net pay are skipped.
+        //!
+        //! \returns
+        //! The number of entries written.
+        std::size_t deposit(const std::pmr::vector<Paycheck>& paychecks, const std::vector<DirectDeposit>& accounts);
+
+        //! \brief End the batch; writes its control record
+        void endBatch();
+
+        //! \brief End the file; writes the file control and block padding
+        //! and flushes
+        void finish();
+
+        //! \brief Get the number of entries in the file so far
+        std::size_t entries() const { return _file_entries; }
+
+        //! \brief Get the total credited in the file so far, in cents
+        long long totalCredit() const { return _file_credit; }
+
+    private:
+
+        //! \brief Start a record; flushes the buffer first if it's full
+        char* record();
+        void flush();
+
+        std::ostream& _out;
+        AchOrigin _origin;
+        std::vector<char> _buffer;
+        std::size_t _used;
+        std::size_t _records;
+
+        bool _in_batch;
+        std::uint32_t _batch_number;
+        std::size_t _batch_entries;
+        unsigned long long _batch_hash;
+        long long _batch_credit;
+
+        std::size_t _file_batches;
+        std::size_t _file_entries;
+        unsigned long long _file_hash;
+        long long _file_credit;
+    };
+
+}
+}
+
+#endif
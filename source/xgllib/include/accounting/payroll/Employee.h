@@ -0,0 +1,48 @@
+//! \file Employee.h
+//! \brief Employee pay terms
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _EMPLOYEE_H_
+#define _EMPLOYEE_H_
+#include <vector>
+
+#include "accounting/payroll/PayPeriods.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief Employee
+    //!
+    //! The terms a salaried employee is paid on.
+    struct Employee {
+
+        //! \brief Employee identifier
+        long long id;
+
+        //! \brief Annual salary
+        double annual_wage;
+
+        //! \brief How often the employee is paid
+        PayPeriod::ePAY_PERIOD pay_period;
+    };
+
+    //! \brief The employees on the payroll
+    using Roster = std::vector<Employee>;
+
+}
+}
+
+#endif
@@ -0,0 +1,105 @@
+//! \file EmployeeStore.h
+//! \brief In-memory employee store
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _EMPLOYEE_STORE_H_
+#define _EMPLOYEE_STORE_H_
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "accounting/payroll/Employee.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief Employee store
+    //!
+    //! The payroll's working copy of the roster, laid out as one array per
+    //! field rather than one object per employee.  The payroll loop touches
+    //! a handful of fields for every employee in order, so each field is
+    //! streamed through the cache sequentially and nothing else is pulled
+    //! in alongside it.  Employee i is at index i of every column.
+    //!
+    //! A million employees take 41 bytes each: the id, annual wage and three
+    //! year to date totals at 8 bytes, and the pay period packed in a byte.
+    class EmployeeStore {
+    public:
+
+        //! \brief Reserve room for a number of employees
+        void reserve(std::size_t employees);
+
+        //! \brief Add an employee
+        //!
+        //! \param employee         The employee's pay terms.
+        //! \param ytd_oasdi_wages  Social security taxable wages paid so far this year.
+        //! \param ytd_oasdi        Social security tax withheld so far this year.
+        //! \param ytd_futa_wages   FUTA taxable wages paid so far this year.
+        //!
+        //! \returns
+        //! The employee's index in the store.
+        std::size_t add(const Employee& employee, double ytd_oasdi_wages = 0, double ytd_oasdi = 0,
+                        double ytd_futa_wages = 0);
+
+        //! \brief Get the number of employees
+        std::size_t size() const { return _id.size(); }
+
+        //! \brief Get an employee's pay terms
+        Employee employee(std::size_t i) const;
+
+        //! \brief Get the pay period of an employee
+        PayPeriod::ePAY_PERIOD payPeriod(std::size_t i) const
+        {
+            return static_cast<PayPeriod::ePAY_PERIOD>(_pay_period[i]);
+        }
+
+        //! \brief Employee id column
+        const std::vector<long long>& id() const { return _id; }
+
+        //! \brief Annual wage column
+        const std::vector<double>& annualWage() const { return _annual_wage; }
+
+        //! \brief Pay period column
+        const std::vector<std::uint8_t>& payPeriod() const { return _pay_period; }
+
+        //! \brief Year to date social security taxable wages column
+        std::vector<double>& ytdOasdiWages() { return _ytd_oasdi_wages; }
+        const std::vector<double>& ytdOasdiWages() const { return _ytd_oasdi_wages; }
+
+        //! \brief Year to date social security tax column
+        std::vector<double>& ytdOasdi() { return _ytd_oasdi; }
+        const std::vector<double>& ytdOasdi() const { return _ytd_oasdi; }
+
+        //! \brief Year to date FUTA taxable wages column
+        std::vector<double>& ytdFutaWages() { return _ytd_futa_wages; }
+        const std::vector<double>& ytdFutaWages() const { return _ytd_futa_wages; }
+
+        //! \brief Get the memory used by the columns, in bytes
+        std::size_t memoryUsage() const;
+
+    private:
+        std::vector<long long> _id;
+        std::vector<double> _annual_wage;
+        std::vector<std::uint8_t> _pay_period;
+        std::vector<double> _ytd_oasdi_wages;
+        std::vector<double> _ytd_oasdi;
+        std::vector<double> _ytd_futa_wages;
+    };
+
+}
+}
+
+#endif
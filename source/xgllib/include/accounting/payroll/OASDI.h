@@ -110,14 +110,9 @@ namespace payroll {
         //!
         //! \returns
         //! This returns the maximum annual contribution.
-        double max_contribution()
+        double max_contribution() const
         {
-            static double max = 0;
-            if (!max)
-            {
-                max = wage_limit * employee_tax_rate;
-            }
-            return max;
+            return wage_limit * employee_tax_rate;
         }
         
         //! \brief Calculate social security contribution for this paycheck
@@ -134,7 +129,7 @@ namespace payroll {
         //! \param a_wages
         //! This is the amount of base wages, used to calculate the tax.
         //
-        double calculate(double a_accumulated_contributions, double a_wages)
+        double calculate(double a_accumulated_contributions, double a_wages) const
         {
             double max = max_contribution();
             double contribution = 0;
@@ -0,0 +1,68 @@
+//! \file Paycheck.h
+//! \brief A single issued paycheck
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _PAYCHECK_H_
+#define _PAYCHECK_H_
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief Paycheck
+    //!
+    //! A paycheck is the result of a payroll run for one employee in one
+    //! pay period.  This is the plain value type the calculators and reports
+    //! work on; the persisted form lives in db::Paycheck.
+    struct Paycheck {
+
+        //! \brief Employee the check was issued to
+        long long employee_id;
+
+        //! \brief Calendar year the check was paid in
+        int year;
+
+        //! \brief Calendar month the check was paid in (1 - 12)
+        int month;
+
+        //! \brief Pay period within the year (0 based)
+        int period;
+
+        //! \brief Gross wages paid on this check
+        double gross_wages;
+
+        //! \brief Wages subject to social security tax
+        double oasdi_wages;
+
+        //! \brief Employee's social security tax withheld
+        double oasdi_employee;
+
+        //! \brief Employer's social security tax
+        double oasdi_employer;
+
+        //! \brief Wages subject to federal unemployment tax
+        double futa_wages;
+
+        //! \brief Net pay: gross wages less the employee's withholding
+        double net_pay() const { return gross_wages - oasdi_employee; }
+
+        //! \brief Calendar quarter the check was paid in (1 - 4)
+        int quarter() const { return (month - 1) / 3 + 1; }
+    };
+
+}
+}
+
+#endif
@@ -0,0 +1,109 @@
+//! \file PayrollRun.h
+//! \brief Payroll run context
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _PAYROLL_RUN_H_
+#define _PAYROLL_RUN_H_
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "accounting/payroll/Employee.h"
+#include "accounting/payroll/EmployeeStore.h"
+#include "accounting/payroll/Paycheck.h"
+#include "accounting/payroll/PayrollTaxes.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief Payroll run
+    //!
+    //! One pay period's run over the roster.  Everything the run produces is
+    //! allocated from a monotonic arena owned by the run, which is sized up
+    //! front for the number of employees.  Paying an employee never goes
+    //! to the arena's upstream resource (by default the heap); all of the
+    //! run's memory is returned in one shot when the run is destroyed.
+    //!
+    //! \note A run is not thread safe; use one run per thread.
+    class PayrollRun {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param year         Calendar year of the pay date.
+        //! \param month        Calendar month of the pay date (1 - 12).
+        //! \param period       Pay period within the year (0 based).
+        //! \param employees    Number of employees to be paid; used to size
+        //!                     the arena.
+        //! \param taxes        Tax rates for the year.
+        //! \param upstream     Where the arena gets its memory.
+        PayrollRun(int year, int month, int period, std::size_t employees,
+                   const PayrollTaxes& taxes = PayrollTaxes(),
+                   std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        PayrollRun(const PayrollRun&) = delete;
+        PayrollRun& operator=(const PayrollRun&) = delete;
+
+        //! \brief Pay one employee
+        //!
+        //! \param employee     The employee's pay terms.
+        //! \param ytd          The employee's year to date totals; updated.
+        //!
+        //! \returns
+        //! The employee's paycheck for this run.
+        const Paycheck& pay(const Employee& employee, YearToDate& ytd);
+
+        //! \brief Pay every employee on the roster
+        //!
+        //! \param roster       The employees.
+        //! \param ytd          Year to date totals, parallel to \p roster.
+        void pay(const Roster& roster, std::vector<YearToDate>& ytd);
+
+        //! \brief Pay every employee in the store
+        //!
+        //! Streams the store's columns in order and updates its year to
+        //! date columns in place.
+        //!
+        //! \param store        The employees.
+        void pay(EmployeeStore& store);
+
+        //! \brief Get the paychecks issued so far in this run
+        const std::pmr::vector<Paycheck>& paychecks() const { return _paychecks; }
+
+        //! \brief Get the run's arena
+        //!
+        //! Intermediate data belonging to the run should be allocated from
+        //! here so it is released along with the run.
+        std::pmr::memory_resource* resource() { return &_arena; }
+
+    private:
+
+        //! \brief Issue one paycheck and add it to the run
+        const Paycheck& issue(long long id, double annual_wage, PayPeriod::ePAY_PERIOD pay_period,
+                              YearToDate& ytd);
+
+        int _year;
+        int _month;
+        int _period;
+        PayrollTaxes _taxes;
+        std::pmr::monotonic_buffer_resource _arena;
+        std::pmr::vector<Paycheck> _paychecks;
+    };
+
+}
+}
+
+#endif
@@ -0,0 +1,75 @@
+//! \file PayrollTaxes.h
+//! \brief Employee and employer taxes on a paycheck
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _PAYROLL_TAXES_H_
+#define _PAYROLL_TAXES_H_
+#include <algorithm>
+
+#include "accounting/payroll/FUTA.h"
+#include "accounting/payroll/OASDI.h"
+#include "accounting/payroll/Paycheck.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief Year to date totals for one employee
+    //!
+    //! Every capped tax on a paycheck depends on what has already been
+    //! paid this year, so these are carried from one paycheck to the next.
+    struct YearToDate {
+        double gross_wages = 0;
+        double oasdi_wages = 0;
+        double oasdi_employee = 0;
+        double futa_wages = 0;
+    };
+
+    //! \brief Payroll tax rates for a year
+    struct PayrollTaxes {
+
+        //! \brief Social security tax rates
+        OASDI_TAX_RATE oasdi;
+
+        //! \brief Federal unemployment tax rates
+        FUTA_RATE futa;
+
+        //! \brief Calculate the taxes on a paycheck
+        //!
+        //! Fills in the taxable wages and taxes for \p check from its gross
+        //! wages, then adds the check to the year to date totals.
+        //!
+        //! \param check    The paycheck; gross_wages must already be set.
+        //! \param ytd      Year to date totals before this check.
+        void calculate(Paycheck& check, YearToDate& ytd) const
+        {
+            const double gross = check.gross_wages;
+
+            check.oasdi_wages = std::max(0.0, std::min(gross, oasdi.wage_limit - ytd.oasdi_wages));
+            check.oasdi_employee = oasdi.calculate(ytd.oasdi_employee, gross);
+            check.oasdi_employer = check.oasdi_wages * oasdi.business_tax_rate;
+            check.futa_wages = std::max(0.0, std::min(gross, futa.wage_cap - ytd.futa_wages));
+
+            ytd.gross_wages += gross;
+            ytd.oasdi_wages += check.oasdi_wages;
+            ytd.oasdi_employee += check.oasdi_employee;
+            ytd.futa_wages += check.futa_wages;
+        }
+    };
+
+}
+}
+
+#endif
@@ -0,0 +1,103 @@
+//! \file RetroAdjustment.h
+//! \brief Retroactive pay adjustments
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _RETRO_ADJUSTMENT_H_
+#define _RETRO_ADJUSTMENT_H_
+#include <unordered_map>
+#include <vector>
+
+#include "accounting/payroll/Paycheck.h"
+#include "accounting/payroll/PayrollTaxes.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief A change to an employee's pay
+    //!
+    //! The employee's gross wages change to \p gross_wages for every pay
+    //! period from \p first_period onwards.
+    struct PayChange {
+        long long employee_id;
+        int first_period;
+        double gross_wages;
+    };
+
+    //! \brief Correction to an issued paycheck
+    //!
+    //! Each amount is the difference between the recomputed paycheck and
+    //! the one that was issued.
+    struct PayrollDelta {
+        long long employee_id;
+        int period;
+        double gross_wages;
+        double oasdi_wages;
+        double oasdi_employee;
+        double oasdi_employer;
+        double futa_wages;
+    };
+
+    //! \brief Retroactive pay adjustment engine
+    //!
+    //! The capped taxes make every paycheck depend on all of the employee's
+    //! earlier paychecks that year.  The engine keeps each employee's
+    //! paychecks as a chain ordered by pay period, along with the year to
+    //! date totals in effect before each one.  A change only dirties the
+    //! suffix of one employee's chain starting at the first affected
+    //! period; that suffix is recomputed from the stored year to date
+    //! totals and nothing else is touched.
+    class RetroAdjustment {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param taxes    Tax rates for the year being adjusted.
+        RetroAdjustment(const PayrollTaxes& taxes = PayrollTaxes());
+
+        //! \brief Load the issued paychecks for the year
+        //!
+        //! \param history  Paycheck history, in any order.
+        void load(const std::vector<Paycheck>& history);
+
+        //! \brief Apply a pay change
+        //!
+        //! Recomputes the affected paychecks, updates the stored chain so
+        //! later changes build on this one, and returns a delta for every
+        //! paycheck that changed.
+        std::vector<PayrollDelta> apply(const PayChange& change);
+
+        //! \brief Get an employee's paychecks, ordered by pay period
+        //!
+        //! \returns
+        //! The chain, or nullptr if the employee has no paychecks.
+        const std::vector<Paycheck>* paychecks(long long employee_id) const;
+
+    private:
+
+        //! One employee's paychecks, and the year to date totals before each.
+        struct Chain {
+            std::vector<Paycheck> checks;
+            std::vector<YearToDate> ytd;
+        };
+
+        PayrollTaxes _taxes;
+        std::unordered_map<long long, Chain> _chains;
+    };
+
+}
+}
+
+#endif
@@ -0,0 +1,115 @@
+//! \file Simulation.h
+//! \brief What-if payroll simulation
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _SIMULATION_H_
+#define _SIMULATION_H_
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "accounting/payroll/Employee.h"
+#include "accounting/payroll/EmployeeStore.h"
+#include "accounting/payroll/PayrollTaxes.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief A what-if scenario
+    //!
+    //! A scenario is an overlay on the shared roster.  It only records what
+    //! differs from the roster; employees it doesn't mention are read
+    //! straight from the shared copy.
+    struct Scenario {
+
+        //! \brief Scenario name, for reporting
+        std::string name;
+
+        //! \brief Raise applied to every employee (0.03 is a 3% raise)
+        double raise = 0;
+
+        //! \brief Pay frequency for every employee
+        //!
+        //! ePayPeriodUndefined keeps each employee's own frequency.
+        PayPeriod::ePAY_PERIOD pay_period = PayPeriod::ePayPeriodUndefined;
+
+        //! \brief Replacement terms for individual employees, by id
+        std::unordered_map<long long, Employee> changes;
+
+        //! \brief Employees removed from the payroll, by id
+        std::unordered_set<long long> terminations;
+
+        //! \brief Employees added to the payroll
+        std::vector<Employee> hires;
+    };
+
+    //! \brief Annual totals for a scenario
+    struct ScenarioResult {
+        std::string name;
+        std::size_t headcount = 0;
+        double gross_wages = 0;
+        double oasdi_employee = 0;
+        double oasdi_employer = 0;
+        double futa_wages = 0;
+        double futa_tax = 0;
+
+        //! \brief Employer's total cost; wages plus employer taxes
+        double employerCost() const { return gross_wages + oasdi_employer + futa_tax; }
+    };
+
+    //! \brief What-if payroll simulation
+    //!
+    //! Evaluates many scenarios against one immutable roster.  The roster is
+    //! shared by every scenario and every worker thread; nothing is copied
+    //! per scenario except the scenario's own overlay.
+    class Simulation {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param roster   The shared roster.
+        //! \param taxes    Tax rates for the simulated year.
+        Simulation(std::shared_ptr<const EmployeeStore> roster, const PayrollTaxes& taxes = PayrollTaxes());
+
+        //! \brief Evaluate a single scenario
+        ScenarioResult evaluate(const Scenario& scenario) const;
+
+        //! \brief Evaluate scenarios in parallel
+        //!
+        //! \param scenarios    The scenarios to evaluate.
+        //! \param threads      Number of worker threads; 0 uses the
+        //!                     hardware concurrency.
+        //!
+        //! \returns
+        //! One result per scenario, in the same order.
+        std::vector<ScenarioResult> run(const std::vector<Scenario>& scenarios, unsigned threads = 0) const;
+
+    private:
+
+        //! \brief Pay one employee for a year, adding to the totals
+        void payYear(const Employee& employee, const Scenario& scenario, ScenarioResult& result) const;
+
+        std::shared_ptr<const EmployeeStore> _roster;
+        PayrollTaxes _taxes;
+    };
+
+}
+}
+
+#endif
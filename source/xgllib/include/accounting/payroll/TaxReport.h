@@ -0,0 +1,116 @@
+//! \file TaxReport.h
+//! \brief Quarterly (Form 941) and annual (Form 940) payroll tax reports
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _TAX_REPORT_H_
+#define _TAX_REPORT_H_
+#include <cstddef>
+#include <vector>
+
+#include "accounting/payroll/FUTA.h"
+#include "accounting/payroll/Paycheck.h"
+
+namespace accounting {
+namespace payroll {
+
+    //! \brief Form 941 (Employer's Quarterly Federal Tax Return) totals
+    struct Form941Summary {
+
+        //! \brief Calendar quarter (1 - 4)
+        int quarter;
+
+        //! \brief Line 1: number of employees who received wages
+        std::size_t employees;
+
+        //! \brief Line 2: wages, tips and other compensation
+        double wages;
+
+        //! \brief Line 5a, column 1: taxable social security wages
+        double social_security_wages;
+
+        //! \brief Line 5a, column 2: social security tax (employee and employer)
+        double social_security_tax;
+    };
+
+    //! \brief Form 940 (Employer's Annual Federal Unemployment Tax Return) totals
+    struct Form940Summary {
+
+        //! \brief Number of employees paid during the year
+        std::size_t employees;
+
+        //! \brief Line 3: total payments to all employees
+        double total_payments;
+
+        //! \brief Line 5: total of payments made to each employee in excess of the wage cap
+        double excess_payments;
+
+        //! \brief Line 7: total taxable FUTA wages
+        double taxable_futa_wages;
+
+        //! \brief Line 8: FUTA tax before adjustments
+        double futa_tax;
+
+        //! \brief Line 16: FUTA tax liability for each quarter
+        double quarterly_liability[4];
+    };
+
+    //! \brief Payroll tax report generator
+    //!
+    //! Aggregates a year of paycheck history into the quarterly 941 and
+    //! annual 940 totals.  The history is split into contiguous chunks, one
+    //! per worker thread.  Each worker sums the per quarter totals for its
+    //! chunk and buckets per employee wages into partitions keyed by employee
+    //! id.  Each partition is then merged and reduced by its own worker, so
+    //! the per employee FUTA wage cap is applied without any locking.
+    class TaxReport {
+    public:
+
+        //! \brief Constructor
+        //!
+        //! \param year     The calendar year to report on.  Paychecks from
+        //!                 other years are ignored.
+        //! \param futa     The FUTA tax rate and wage cap for that year.
+        TaxReport(int year, const FUTA_RATE& futa = FUTA_RATE());
+
+        //! \brief Aggregate the paycheck history
+        //!
+        //! \param history  Paycheck history, in any order.
+        //! \param threads  Number of worker threads; 0 uses the hardware
+        //!                 concurrency.
+        void generate(const std::vector<Paycheck>& history, unsigned threads = 0);
+
+        //! \brief Get the year being reported on
+        int getYear() const { return _year; }
+
+        //! \brief Get the Form 941 totals for a quarter
+        //!
+        //! \param quarter  Calendar quarter (1 - 4)
+        const Form941Summary& form941(int quarter) const { return _form941[quarter - 1]; }
+
+        //! \brief Get the Form 940 totals for the year
+        const Form940Summary& form940() const { return _form940; }
+
+    private:
+        int _year;
+        FUTA_RATE _futa;
+        Form941Summary _form941[4];
+        Form940Summary _form940;
+    };
+
+}
+}
+
+#endif
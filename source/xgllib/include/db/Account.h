@@ -0,0 +1,65 @@
+//! \file Account.h
+//! \brief Account record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_ACCOUNT_H_
+#define _DB_ACCOUNT_H_
+#include <Wt/Dbo/Types.h>
+
+#include <string>
+
+#include "accounting/ledger/ChartOfAccounts.h"
+
+namespace dbo = Wt::Dbo;
+
+namespace db
+{
+
+//! \brief Account record
+//!
+//! One row of the chart of accounts.  \p accountId is the id journal lines
+//! post to; \p parentId is the parent's accountId, 0 at the top level.
+class Account {
+public:
+  long long accountId = 0;
+  long long parentId = 0;
+  std::string number;
+  std::string name;
+
+  template<class Action>
+  void persist(Action& a)
+  {
+    dbo::field(a, accountId, "account_id");
+    dbo::field(a, parentId, "parent_id");
+    dbo::field(a, number, "number");
+    dbo::field(a, name, "name");
+  }
+};
+
+//! \brief Add an account, or update it if its id is already in the chart
+//!
+//! Must be called inside a transaction.
+void saveAccount(dbo::Session& session, const accounting::ledger::Account& account);
+
+//! \brief Load the chart of accounts
+//!
+//! One query for the whole chart; the hierarchy is built in memory.
+accounting::ledger::ChartOfAccounts loadChartOfAccounts(dbo::Session& session);
+
+} // namespace db
+
+DBO_EXTERN_TEMPLATES(db::Account)
+#endif
@@ -0,0 +1,97 @@
+//! \file ArchiveStore.h
+//! \brief A company's closed period archives
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_ARCHIVE_STORE_H_
+#define _DB_ARCHIVE_STORE_H_
+#include <climits>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "accounting/PeriodArchive.h"
+
+namespace db
+{
+
+//! \brief Archive Store
+//!
+//! The closed periods of one company, each in an archive file
+//! (accounting::PeriodArchive) named for the year it closes, in a
+//! directory next to the company's database.  The periods are consecutive:
+//! every journal entry and paycheck dated on or before closedThrough() is
+//! in an archive, and everything after it is in the database.
+//!
+//! Archives are read on first use and kept.  The directory is looked at
+//! again whenever it changes, so periods closed by another process (the
+//! xgl command line) are seen.  Shared by the sessions on the company's
+//! database; thread safe.
+//!
+class ArchiveStore
+{
+public:
+  //! \brief Constructor
+  //!
+  //! \param directory    The company's archive directory; need not exist yet.
+  ArchiveStore(const std::string& directory);
+
+  ArchiveStore(const ArchiveStore&) = delete;
+  ArchiveStore& operator=(const ArchiveStore&) = delete;
+
+  //! \brief The closed periods at one moment
+  struct Closed
+  {
+    //! \brief Last day of the last closed period, \see accounting::toDays(),
+    //! or INT_MIN if no period has been closed
+    int through = INT_MIN;
+
+    //! \brief The archives, oldest first
+    std::vector<std::shared_ptr<const accounting::PeriodArchive>> archives;
+  };
+
+  //! \brief Get the closed periods
+  //!
+  //! The day and the archives agree; read the database after \p through
+  //! and the archives up to it.
+  Closed closed();
+
+  //! \brief Get the last day of the last closed period, or INT_MIN
+  int closedThrough();
+
+  //! \brief Write the archive closing a year
+  //!
+  //! \throws std::invalid_argument if the year already has an archive.
+  //! \throws std::runtime_error if it can't be written.
+  void add(int year, const accounting::PeriodArchive& archive);
+
+  //! \brief Get the archive file of a year
+  std::string file(int year) const;
+
+private:
+  void scan();
+
+  std::string directory_;
+
+  std::mutex mutex_;
+  std::timespec scanned_;
+  std::map<std::string, std::shared_ptr<const accounting::PeriodArchive>> archives_;
+};
+
+} // namespace db
+#endif
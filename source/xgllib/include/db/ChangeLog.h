@@ -0,0 +1,94 @@
+//! \file ChangeLog.h
+//! \brief Change feed of a company's books
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_CHANGE_LOG_H_
+#define _DB_CHANGE_LOG_H_
+#include <Wt/Dbo/Types.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "accounting/ChangeFeed.h"
+
+namespace dbo = Wt::Dbo;
+
+namespace db
+{
+
+class LedgerSession;
+
+//! \brief Change log record
+//!
+//! One change to the company's books (accounting::Change), encoded.  The
+//! row id is the change's sequence number.  Rows are only ever appended,
+//! in the transaction that made the change, under the company's books
+//! lock (\see LedgerSession::lockBooks()).  The lock is held until the
+//! commit, so ids are handed out in commit order and a cursor never
+//! passes a change that commits later with a smaller id.
+class Change {
+public:
+  std::vector<unsigned char> data;
+
+  template<class Action>
+  void persist(Action& a)
+  {
+    dbo::field(a, data, "data");
+  }
+};
+
+//! \brief Record changes in the change log
+//!
+//! Must be called inside the transaction that makes them, holding the
+//! books lock.
+void recordChanges(LedgerSession& session, const std::vector<accounting::Change>& changes);
+
+//! \brief Change Cursor
+//!
+//! A consumer's position in a company's change log.  Each next() returns
+//! the changes after the position, in order, and moves past them; a
+//! consumer that keeps position() can resume from it later, so a sync
+//! costs the changes since the last one rather than a full export.
+//!
+class ChangeCursor
+{
+public:
+  //! \brief Constructor
+  //!
+  //! \param since    Sequence number of the last change already seen; 0
+  //!                 for the beginning.
+  ChangeCursor(LedgerSession& session, long long since = 0);
+
+  //! \brief Read the next changes
+  //!
+  //! \param max  The most to read at once.
+  //!
+  //! \returns
+  //! Up to \p max changes; none once the cursor has caught up.
+  std::vector<accounting::Change> next(std::size_t max = 4096);
+
+  //! \brief Get the sequence number of the last change read
+  long long position() const { return position_; }
+
+private:
+  LedgerSession& session_;
+  long long position_;
+};
+
+} // namespace db
+
+DBO_EXTERN_TEMPLATES(db::Change)
+#endif
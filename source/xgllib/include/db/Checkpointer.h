@@ -0,0 +1,63 @@
+//! \file Checkpointer.h
+//! \brief Periodic ledger state checkpoints
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_CHECKPOINTER_H_
+#define _DB_CHECKPOINTER_H_
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace db
+{
+
+class ShardRouter;
+
+//! \brief Checkpointer
+//!
+//! Checkpoints the in-memory ledger state of every company in use (\see
+//! ShardRouter::checkpoint()) at a fixed interval, on a thread of its
+//! own, and once more when destroyed.  Only companies that changed are
+//! written.
+//!
+class Checkpointer
+{
+public:
+  //! \brief Constructor; starts the thread
+  Checkpointer(ShardRouter& router, std::chrono::seconds interval);
+
+  //! \brief Destructor; takes a last checkpoint and stops the thread
+  ~Checkpointer();
+
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+
+private:
+  void run();
+
+  ShardRouter& router_;
+  std::chrono::seconds interval_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stop_;
+
+  std::thread thread_;
+};
+
+} // namespace db
+#endif
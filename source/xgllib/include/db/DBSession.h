@@ -20,8 +20,10 @@
 #include <Wt/Auth/Login.h>
 #include <Wt/Auth/Dbo/UserDatabase.h>
 #include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/SqlConnectionPool.h>
 #include <Wt/Dbo/ptr.h>
 
+#include "db/Database.h"
 #include "db/User.h"
 
 //! \brief Database namespace
@@ -34,7 +36,22 @@ namespace db
 
 namespace dbo = Wt::Dbo;
 
-using UserDatabase = Wt::Auth::Dbo::UserDatabase<AuthInfo>;
+//! \brief User database
+//!
+//! Every user registered through it gets a User record, and with it a
+//! new company of their own (numbered with the record's id) to keep the
+//! books of.  To have a user keep another company's books, change their
+//! company_id.
+class UserDatabase : public Wt::Auth::Dbo::UserDatabase<AuthInfo>
+{
+public:
+  UserDatabase(dbo::Session& session);
+
+  Wt::Auth::User registerNew() override;
+
+private:
+  dbo::Session& session_;
+};
 
 //! \brief Database Session
 //!
@@ -45,8 +62,18 @@ class DBSession : public dbo::Session
 public:
   static void configureAuth();
 
+  //! \brief Open a connection pool on the authentication database
+  //!
+  //! Creates its tables the first time.  Share the pool between the
+  //! application sessions.
+  static std::unique_ptr<dbo::SqlConnectionPool> createPool(const DatabaseConfig& config);
+
+  //! \brief Constructor, on a connection of its own to a SQLite database
   DBSession(const std::string& sqliteDb);
 
+  //! \brief Constructor, on a pool from createPool()
+  DBSession(dbo::SqlConnectionPool& pool);
+
   dbo::ptr<User> user() const;
 
   Wt::Auth::AbstractUserDatabase& users();
@@ -57,6 +84,8 @@ public:
   static const std::vector<const Wt::Auth::OAuthService *> oAuth();
 
 private:
+  void mapClasses();
+
   std::unique_ptr<UserDatabase> users_;
   Wt::Auth::Login login_;
 };
@@ -0,0 +1,98 @@
+//! \file Database.h
+//! \brief Database backend selection and connection pools
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_DATABASE_H_
+#define _DB_DATABASE_H_
+#include <Wt/Dbo/SqlConnection.h>
+#include <Wt/Dbo/SqlConnectionPool.h>
+
+#include <memory>
+#include <string>
+
+namespace db
+{
+
+namespace dbo = Wt::Dbo;
+
+//! \brief Database configuration
+//!
+//! Which backend holds the databases, and where.  XGL keeps an
+//! authentication database plus one database per company (\see
+//! ShardRouter), each known by a name: "auth", "company_42".
+//!
+//! - SQLite (the default): each is the file <directory>/<name>.db.
+//!   SQLite allows one writer per file at a time.
+//! - PostgreSQL: each is the schema <name> in the one database named by
+//!   \p connection, created on first use.  Any number of writers.
+//!
+//! Closed period archives are kept under \p directory with either backend.
+//!
+//! XGL.wt reads it from the wt_config.xml properties database-backend,
+//! database-connection, database-pool-size and database-writers.
+struct DatabaseConfig
+{
+  //! \brief Backend
+  enum eBACKEND {
+    eSqlite3,
+    ePostgres
+  };
+
+  eBACKEND backend = eSqlite3;
+
+  //! \brief Directory of the SQLite databases and the archives
+  std::string directory;
+
+  //! \brief PostgreSQL connection string (libpq key=value form), e.g.
+  //! "host=localhost dbname=xgl user=xgl"
+  std::string connection;
+
+  //! \brief Connections per database
+  int poolSize = 4;
+
+  //! \brief Journal posting threads \see PostingService
+  int writers = 1;
+
+  //! \brief Parse a backend name, "sqlite3" or "postgres"
+  //!
+  //! \throws std::invalid_argument on any other name.
+  static eBACKEND parseBackend(const std::string& name);
+
+  //! \brief Check whether this build has the PostgreSQL backend
+  static bool postgresAvailable();
+
+  //! \brief Get the SQLite file of a database
+  std::string file(const std::string& name) const;
+
+  //! \brief Get the PostgreSQL connection string of a database
+  //!
+  //! \p connection with the search path set to the database's schema.
+  std::string connectionString(const std::string& name) const;
+};
+
+//! \brief Open a connection to a database
+//!
+//! For PostgreSQL, creates the database's schema if need be.
+//!
+//! \throws std::runtime_error if PostgreSQL is configured but this build
+//!         doesn't have it.
+std::unique_ptr<dbo::SqlConnection> openConnection(const DatabaseConfig& config, const std::string& name);
+
+//! \brief Open a pool of DatabaseConfig::poolSize connections to a database
+std::unique_ptr<dbo::SqlConnectionPool> openPool(const DatabaseConfig& config, const std::string& name);
+
+} // namespace db
+#endif
@@ -0,0 +1,61 @@
+//! \file Employee.h
+//! \brief Employee record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_EMPLOYEE_H_
+#define _DB_EMPLOYEE_H_
+#include <Wt/Dbo/Types.h>
+
+#include "accounting/payroll/EmployeeStore.h"
+
+namespace dbo = Wt::Dbo;
+
+namespace db
+{
+
+class LedgerCache;
+class LedgerSession;
+
+//! \brief Employee record
+//!
+//! An employee's pay terms.  The record id is the employee id used by
+//! the paycheck history.
+class Employee {
+public:
+  double annualWage = 0;
+  int payPeriod = accounting::payroll::PayPeriod::ePayPeriodUndefined;
+
+  template<class Action>
+  void persist(Action& a)
+  {
+    dbo::field(a, annualWage, "annual_wage");
+    dbo::field(a, payPeriod, "pay_period");
+  }
+};
+
+//! \brief Load the employees into an in-memory store
+//!
+//! Reads every employee with one projection query ordered by employee
+//! id, and their year to date totals for \p year from the company's
+//! in-memory state (\see ShardRouter::cache()), which has them without
+//! reading the paycheck history.  This is done once before a payroll run;
+//! the run itself never goes back to the database.
+accounting::payroll::EmployeeStore loadEmployeeStore(LedgerSession& session, LedgerCache& cache, int year);
+
+} // namespace db
+
+DBO_EXTERN_TEMPLATES(db::Employee)
+#endif
@@ -0,0 +1,62 @@
+//! \file ExchangeRate.h
+//! \brief Exchange rate record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_EXCHANGE_RATE_H_
+#define _DB_EXCHANGE_RATE_H_
+#include <Wt/Dbo/Types.h>
+#include <Wt/Dbo/WtSqlTraits.h>
+#include <Wt/WDate.h>
+
+#include <string>
+
+#include "accounting/ledger/ExchangeRates.h"
+
+namespace dbo = Wt::Dbo;
+
+namespace db
+{
+
+//! \brief Exchange rate record
+//!
+//! A currency's published rate for a day, in USD per unit.
+class ExchangeRate {
+public:
+  std::string currency;
+  Wt::WDate date;
+  double rate = 0;
+
+  template<class Action>
+  void persist(Action& a)
+  {
+    dbo::field(a, currency, "currency", 3);
+    dbo::field(a, date, "date");
+    dbo::field(a, rate, "rate");
+  }
+};
+
+//! \brief Set a currency's rate for a day, replacing any already there
+//!
+//! Must be called inside a transaction.
+void setExchangeRate(dbo::Session& session, const accounting::Currency& currency, int date, double rate);
+
+//! \brief Load every rate into the in-memory table
+accounting::ledger::ExchangeRates loadExchangeRates(dbo::Session& session);
+
+} // namespace db
+
+DBO_EXTERN_TEMPLATES(db::ExchangeRate)
+#endif
@@ -0,0 +1,99 @@
+//! \file JournalCopy.h
+//! \brief Bulk journal entry insert over PostgreSQL COPY
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_JOURNAL_COPY_H_
+#define _DB_JOURNAL_COPY_H_
+#include <string>
+#include <vector>
+
+#include "accounting/ledger/JournalEntry.h"
+
+struct pg_conn;
+
+namespace db
+{
+
+//! \brief Journal Copy
+//!
+//! Inserting a group commit's entries one INSERT at a time costs a round
+//! trip per row.  With PostgreSQL, PostingService sends the batch as two
+//! COPY streams instead, journal_entry rows then journal_line rows, then
+//! their change_log rows, on a connection of its own.  Ids are drawn from
+//! the tables' sequences up front, in one query each, so the lines and
+//! changes can refer to their entries.  One transaction per batch, under
+//! the company's books lock (\see LedgerSession::lockBooks()), taken
+//! before the ids are drawn.
+//!
+//! Only built with PostgreSQL (XGL_POSTGRES); the row formatting is
+//! always available.
+//!
+class JournalCopy
+{
+public:
+  //! \brief Constructor; connects
+  //!
+  //! \param connection   libpq connection string, with the search path
+  //!                     set to the company's schema \see DatabaseConfig
+  //!
+  //! \throws std::runtime_error if it can't connect.
+  JournalCopy(const std::string& connection);
+  ~JournalCopy();
+
+  JournalCopy(const JournalCopy&) = delete;
+  JournalCopy& operator=(const JournalCopy&) = delete;
+
+  //! \brief Insert journal entries and their lines
+  //!
+  //! \param closedThrough   Last day the company's archives have closed;
+  //!                         the database may be further on.
+  //!
+  //! \returns
+  //! The entries' ids, in order.
+  //!
+  //! \throws std::invalid_argument if an entry is dated in a closed period.
+  //! \throws std::runtime_error if the batch fails.
+  //! Either way none of it is inserted.
+  std::vector<long long> insert(const std::vector<const accounting::ledger::JournalEntry*>& entries,
+                                int closedThrough);
+
+  //! \brief Append a journal_entry row in COPY text format
+  //!
+  //! Columns id, version, date, memo.
+  static void entryRow(std::string& out, long long id, const accounting::ledger::JournalEntry& entry);
+
+  //! \brief Append a journal_line row in COPY text format
+  //!
+  //! Columns id, version, entry_id, account_id, amount, reference,
+  //! currency, currency_amount.
+  static void lineRow(std::string& out, long long id, long long entryId, const accounting::ledger::JournalLine& line);
+
+  //! \brief Append a change_log row in COPY text format
+  //!
+  //! Columns id, version, data; \see accounting::Change::encode().
+  static void changeRow(std::string& out, long long id, const std::string& data);
+
+private:
+  int lockBooks();
+  std::vector<long long> nextIds(const char* sequence, std::size_t count);
+  void copy(const char* statement, const std::string& rows);
+  void execute(const char* statement);
+
+  pg_conn* connection_;
+};
+
+} // namespace db
+#endif
@@ -0,0 +1,132 @@
+//! \file JournalEntry.h
+//! \brief Journal entry and journal line records
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_JOURNAL_ENTRY_H_
+#define _DB_JOURNAL_ENTRY_H_
+#include <Wt/Dbo/Types.h>
+#include <Wt/Dbo/WtSqlTraits.h>
+#include <Wt/WDate.h>
+
+#include <string>
+#include <vector>
+
+#include "accounting/ledger/BalanceNotifier.h"
+#include "accounting/ledger/JournalEntry.h"
+#include "accounting/ledger/Reconciliation.h"
+#include "accounting/ledger/Revaluation.h"
+
+namespace dbo = Wt::Dbo;
+
+namespace db
+{
+
+class JournalEntry;
+class LedgerSession;
+
+//! \brief Journal line record
+//!
+//! \p amount is in USD.  Foreign currency lines also keep the amount in
+//! the transaction currency; for USD lines \p currencyAmount equals
+//! \p amount.
+class JournalLine {
+public:
+  dbo::ptr<JournalEntry> entry;
+  long long accountId = 0;
+  double amount = 0;
+  std::string reference;
+  std::string currency = "USD";
+  double currencyAmount = 0;
+
+  template<class Action>
+  void persist(Action& a)
+  {
+    dbo::belongsTo(a, entry, "entry", dbo::OnDeleteCascade);
+    dbo::field(a, accountId, "account_id");
+    dbo::field(a, amount, "amount");
+    dbo::field(a, reference, "reference");
+    dbo::field(a, currency, "currency", 3);
+    dbo::field(a, currencyAmount, "currency_amount");
+  }
+};
+
+//! \brief Journal entry record
+class JournalEntry {
+public:
+  Wt::WDate date;
+  std::string memo;
+  dbo::collection<dbo::ptr<JournalLine>> lines;
+
+  template<class Action>
+  void persist(Action& a)
+  {
+    dbo::field(a, date, "date");
+    dbo::field(a, memo, "memo");
+    dbo::hasMany(a, lines, dbo::ManyToOne, "entry");
+  }
+};
+
+//! \brief Check that a day is in an open period
+//!
+//! Closed periods are immutable; corrections go in an open period.
+//! Check inside the transaction that writes, under the books lock
+//! (LedgerSession::lockBooks()), so a close can't come in between.
+//!
+//! \throws std::invalid_argument if \p date is in a closed period.
+void checkOpenPeriod(LedgerSession& session, int date);
+
+//! \brief Add a journal entry and its lines to a session
+//!
+//! Must be called inside a transaction holding the books lock
+//! (LedgerSession::lockBooks()).  Records the entry and the balances it
+//! moves in the change log.
+//!
+//! \throws std::invalid_argument if the entry is dated in a closed period.
+dbo::ptr<JournalEntry> addJournalEntry(LedgerSession& session, const accounting::ledger::JournalEntry& entry);
+
+//! \brief Read the current balances of a set of accounts
+//!
+//! One grouped query for all of the accounts, plus the totals the
+//! archives keep for each account.
+accounting::ledger::Balances loadBalances(LedgerSession& session, const std::vector<long long>& accounts);
+
+//! \brief Read every account's balance as of a day
+//!
+//! One grouped query over the entries up to and including \p date, plus
+//! the archived periods; roll them up with accounting::ledger::Rollup.
+accounting::ledger::Balances loadBalances(LedgerSession& session, int date);
+
+//! \brief Read the lines posted to an account over a date range
+//!
+//! For reconciling the account against a bank statement.  Each line's id
+//! is its journal_line id, archived or not.
+//!
+//! \param from, to    First and last day, \see accounting::toDays()
+std::vector<accounting::ledger::CashLine> loadAccountLines(LedgerSession& session, long long accountId,
+                                                           int from, int to);
+
+//! \brief Read every foreign currency balance as of a day
+//!
+//! One grouped query: the foreign and USD totals of each account and
+//! currency, over the entries up to and including \p date; merged with
+//! the archived periods' totals.
+std::vector<accounting::ledger::ForeignBalance> loadForeignBalances(LedgerSession& session, int date);
+
+} // namespace db
+
+DBO_EXTERN_TEMPLATES(db::JournalEntry)
+DBO_EXTERN_TEMPLATES(db::JournalLine)
+#endif
@@ -0,0 +1,94 @@
+//! \file LedgerCache.h
+//! \brief A company's in-memory ledger state, kept current
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_LEDGER_CACHE_H_
+#define _DB_LEDGER_CACHE_H_
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "accounting/LedgerState.h"
+#include "accounting/ledger/BalanceNotifier.h"
+
+namespace db
+{
+
+class LedgerSession;
+
+//! \brief Ledger Cache
+//!
+//! One company's account balances and year to date payroll, held in
+//! memory (accounting::LedgerState) and brought up to date from the
+//! database before each read.  Catching up reads only what was recorded
+//! since the last read: journal lines and paychecks with higher ids, and
+//! any period closed since.
+//!
+//! The state is checkpointed to a file next to the company's database.
+//! On startup the cache loads the checkpoint and catches up from there,
+//! so the work is bounded by what happened since the checkpoint, not by
+//! the size of the journal.  A missing or damaged checkpoint means
+//! catching up from the beginning.
+//!
+//! Rows are taken in by id, so this relies on ids being handed out in
+//! commit order: everything that writes journal lines or paychecks
+//! draws their ids under the company's books lock and holds it until
+//! the commit (\see LedgerSession::lockBooks()).  Shared by the
+//! company's sessions; thread safe.
+//!
+class LedgerCache
+{
+public:
+  //! \brief Constructor; loads the checkpoint, if there is one
+  //!
+  //! \param checkpoint   The company's checkpoint file.
+  LedgerCache(const std::string& checkpoint);
+
+  LedgerCache(const LedgerCache&) = delete;
+  LedgerCache& operator=(const LedgerCache&) = delete;
+
+  //! \brief Take in what was recorded since the last call
+  void refresh(LedgerSession& session);
+
+  //! \brief Get the current balances of a set of accounts
+  accounting::ledger::Balances balances(LedgerSession& session, const std::vector<long long>& accounts);
+
+  //! \brief Get the current year to date totals of a set of employees
+  //!
+  //! \returns
+  //! The totals, in the order of \p employees.
+  std::vector<accounting::PayrollTotals> yearToDate(LedgerSession& session, const std::vector<long long>& employees,
+                                                 int year);
+
+  //! \brief Write the checkpoint, if anything changed since the last one
+  //!
+  //! \throws std::runtime_error if it can't be written.
+  void checkpoint();
+
+private:
+  void catchUp(LedgerSession& session);
+
+  std::string file_;
+  std::mutex mutex_;
+  std::mutex writeMutex_;
+  accounting::LedgerState state_;
+  long long checkpointLine_;
+  long long checkpointPaycheck_;
+  int checkpointClosed_;
+};
+
+} // namespace db
+#endif
@@ -0,0 +1,98 @@
+//! \brief Company ledger database session
+//! \file LedgerSession.h
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _LEDGER_SESSION_H_
+#define _LEDGER_SESSION_H_
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/SqlConnectionPool.h>
+
+#include "db/Account.h"
+#include "db/ArchiveStore.h"
+#include "db/ChangeLog.h"
+#include "db/Employee.h"
+#include "db/ExchangeRate.h"
+#include "db/JournalEntry.h"
+#include "db/Paycheck.h"
+
+namespace db
+{
+
+namespace dbo = Wt::Dbo;
+
+//! \brief Ledger Session
+//!
+//! A session on one company's database: its chart of accounts, journal,
+//! exchange rates, employees and payroll history.  Each company lives in its own database (shard), so
+//! a session only ever sees one company.  Sessions borrow connections
+//! from the shard's pool; get them from ShardRouter::session().
+//!
+//! Closed periods are moved out of the database into the company's
+//! archives; the load functions (loadBalances(), loadPayrollHistory(),
+//! ...) read both, so callers see the whole history.
+//!
+//! Every change to the books is also appended to the change log (\see
+//! ChangeCursor), for downstream systems to follow.
+//!
+//! Transactions that write the journal, payroll or change log take the
+//! company's books lock first (lockBooks()), so they commit one at a
+//! time and in the order they draw their ids.
+//!
+class LedgerSession : public dbo::Session
+{
+public:
+  //! \brief Constructor
+  //!
+  //! \param pool       The company database's connection pool.
+  //! \param archives   The company's closed periods, or null for none.
+  LedgerSession(dbo::SqlConnectionPool& pool, ArchiveStore* archives = nullptr);
+
+  //! \brief Get the company's closed period archives; may be null
+  ArchiveStore* archives() const { return archives_; }
+
+  //! \brief Get the closed periods; none without archives
+  ArchiveStore::Closed closedPeriods() const
+  {
+    return archives_ ? archives_->closed() : ArchiveStore::Closed();
+  }
+
+  //! \brief Lock the company's books until the transaction ends
+  //!
+  //! Waits for any other transaction holding the lock.  Must be called
+  //! inside a transaction, before anything is written.
+  void lockBooks();
+
+  //! \brief Get the last day closed, or INT_MIN
+  //!
+  //! As recorded in the database, or by the archives if they are ahead.
+  //! Must be called inside a transaction; under the books lock it can't
+  //! change before the transaction ends.
+  int closedThrough();
+
+  //! \brief Record the last day closed
+  //!
+  //! Must be called inside a transaction holding the books lock.
+  void closedThrough(int date);
+
+  //! \brief Map the ledger tables onto a session
+  static void mapClasses(dbo::Session& session);
+
+private:
+  ArchiveStore* archives_;
+};
+
+} // namespace db
+#endif
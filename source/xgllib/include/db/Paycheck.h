@@ -0,0 +1,84 @@
+//! \file Paycheck.h
+//! \brief Paycheck record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_PAYCHECK_H_
+#define _DB_PAYCHECK_H_
+#include <Wt/Dbo/Types.h>
+#include <Wt/Dbo/WtSqlTraits.h>
+#include <Wt/WDate.h>
+
+#include <vector>
+
+#include "accounting/payroll/Paycheck.h"
+
+namespace dbo = Wt::Dbo;
+
+namespace db
+{
+
+class LedgerSession;
+
+//! \brief Paycheck record
+//!
+//! The stored payroll history; one row per employee per pay period.
+class Paycheck {
+public:
+  long long employeeId = 0;
+  Wt::WDate payDate;
+  int period = 0;
+  double grossWages = 0;
+  double oasdiWages = 0;
+  double oasdiEmployee = 0;
+  double oasdiEmployer = 0;
+  double futaWages = 0;
+
+  template<class Action>
+  void persist(Action& a)
+  {
+    dbo::field(a, employeeId, "employee_id");
+    dbo::field(a, payDate, "pay_date");
+    dbo::field(a, period, "period");
+    dbo::field(a, grossWages, "gross_wages");
+    dbo::field(a, oasdiWages, "oasdi_wages");
+    dbo::field(a, oasdiEmployee, "oasdi_employee");
+    dbo::field(a, oasdiEmployer, "oasdi_employer");
+    dbo::field(a, futaWages, "futa_wages");
+  }
+};
+
+//! \brief Add a paycheck to a session
+//!
+//! Must be called inside a transaction holding the books lock
+//! (LedgerSession::lockBooks()).  Records it in the change log.
+//!
+//! \param payDate     Day number the check is paid; its year and month
+//!                     are taken from it.
+//!
+//! \throws std::invalid_argument if \p payDate is in a closed period.
+dbo::ptr<Paycheck> addPaycheck(LedgerSession& session, int payDate, const accounting::payroll::Paycheck& check);
+
+//! \brief Load the stored paycheck history for a calendar year
+//!
+//! The rows are read with a single projection query straight into plain
+//! value types, without materializing a dbo::ptr<> per paycheck.  A closed
+//! year is read from its archive instead.
+std::vector<accounting::payroll::Paycheck> loadPayrollHistory(LedgerSession& session, int year);
+
+} // namespace db
+
+DBO_EXTERN_TEMPLATES(db::Paycheck)
+#endif
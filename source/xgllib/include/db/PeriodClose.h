@@ -0,0 +1,50 @@
+//! \file PeriodClose.h
+//! \brief Closing the books for a year
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_PERIOD_CLOSE_H_
+#define _DB_PERIOD_CLOSE_H_
+#include "accounting/PeriodArchive.h"
+#include "db/LedgerSession.h"
+
+namespace db
+{
+
+//! \brief Close the books through the end of a year
+//!
+//! Moves every journal entry and paycheck dated on or before December 31
+//! of \p year out of the company database into a new archive (\see
+//! ArchiveStore).  The rows are read, the archive written and synced, and
+//! the rows archived deleted by id, in one transaction under the books
+//! lock (\see LedgerSession::lockBooks()), so nothing can be posted to
+//! the year meanwhile.  If the delete doesn't commit, the rows left
+//! behind are ignored, since they fall in a closed period.
+//! From then on the load functions read the year from the archive, and
+//! nothing more can be posted to it.  The close is recorded in the
+//! change log; the changes themselves stay there.
+//!
+//! SQLite reuses the freed pages for new rows; VACUUM the database to
+//! give them back to the file system.
+//!
+//! \returns
+//! The archive written.
+//!
+//! \throws std::invalid_argument if the year is already closed.
+//! \throws std::logic_error if the session has no archive store.
+accounting::PeriodArchive closeYear(LedgerSession& session, int year);
+
+} // namespace db
+#endif
@@ -0,0 +1,125 @@
+//! \file PostingService.h
+//! \brief Process-wide journal posting service
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _POSTING_SERVICE_H_
+#define _POSTING_SERVICE_H_
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "accounting/ledger/JournalEntry.h"
+#include "util/MpscQueue.h"
+
+namespace db
+{
+
+class JournalCopy;
+class LedgerSession;
+class ShardRouter;
+
+//! \brief Journal posting service
+//!
+//! SQLite allows one writer at a time, so application sessions don't post
+//! journal entries through their own session.  They hand entries to this
+//! service instead, which is shared by the whole process.  Posting pushes
+//! onto a lock-free queue and returns a future.  A writer thread drains
+//! the queue and commits everything it finds, from however many sessions,
+//! in one transaction per company database (group commit).  Each future is
+//! completed with the new entry's id once that transaction has committed.
+//!
+//! There can be several writers, each with its own queue.  A company's
+//! postings always go to the same writer, so they commit in order, and
+//! different companies' databases are written in parallel.  With
+//! PostgreSQL, which has no single writer limit, a batch goes in with
+//! COPY rather than row by row (\see JournalCopy).
+//!
+//! If a batch fails to commit, its entries are retried one at a time so a
+//! bad entry only fails its own future.
+class PostingService
+{
+public:
+  //! \brief Constructor; starts the writer threads
+  //!
+  //! \param router     Company databases; the writers open their own sessions.
+  //! \param maxBatch   Most entries committed in one pass.
+  //! \param writers    Writer threads.
+  PostingService(ShardRouter& router, std::size_t maxBatch = 4096, int writers = 1);
+
+  //! \brief Destructor; commits anything still queued, then stops
+  ~PostingService();
+
+  PostingService(const PostingService&) = delete;
+  PostingService& operator=(const PostingService&) = delete;
+
+  //! \brief Queue a journal entry for posting
+  //!
+  //! Safe to call from any thread.
+  //!
+  //! \returns
+  //! A future holding the entry's id once it has been committed.
+  //!
+  //! \throws std::invalid_argument if the entry does not balance.
+  std::future<long long> post(long long companyId, accounting::ledger::JournalEntry entry);
+
+  //! \brief Receives the accounts of a company touched by a committed batch
+  using CommitListener = std::function<void(long long companyId, const std::vector<long long>& accounts)>;
+
+  //! \brief Set the listener called after each commit
+  //!
+  //! The listener runs on the writer thread and should not block.
+  void setCommitListener(CommitListener listener);
+
+private:
+  struct Posting
+  {
+    long long companyId = 0;
+    accounting::ledger::JournalEntry entry;
+    std::promise<long long> done;
+  };
+
+  struct Writer
+  {
+    util::MpscQueue<Posting> queue;
+    std::atomic<bool> waiting{ false };
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+  };
+
+  void run(Writer& writer);
+  void commit(long long companyId, LedgerSession& session, JournalCopy* copy, std::vector<Posting>& batch);
+
+  ShardRouter& router_;
+  std::size_t maxBatch_;
+  std::atomic<bool> stop_;
+
+  std::mutex listenerMutex_;
+  CommitListener listener_;
+
+  std::vector<std::unique_ptr<Writer>> writers_;
+};
+
+} // namespace db
+#endif
@@ -0,0 +1,54 @@
+//! \file Schema.h
+//! \brief Database schema versions and migrations
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _DB_SCHEMA_H_
+#define _DB_SCHEMA_H_
+#include <Wt/Dbo/SqlConnectionPool.h>
+
+namespace db
+{
+
+namespace dbo = Wt::Dbo;
+
+//! \brief Bring a company database's schema up to date
+//!
+//! Each database records the version of its schema in its schema_version
+//! table, and is brought up to date one migration at a time, each
+//! recorded as it completes.  A database from before schema versions
+//! were kept is taken to be at version 0.  A new database is given the
+//! current mapped tables, then runs every migration for anything that
+//! isn't mapped.  So the migrations check for what they add; running
+//! one over a database that already has its change is harmless.
+//!
+//! Every schema change (a new table or column) needs a migration in
+//! Schema.cpp.  Released migrations are never changed.
+//!
+//! Run when the database is opened, before any session uses it.
+//!
+//! \returns
+//! True if the database was new.
+//!
+//! \throws dbo::Exception if the tables can't be created or a migration fails.
+bool migrateLedger(dbo::SqlConnectionPool& pool);
+
+//! \brief Bring the authentication database's schema up to date
+//!
+//! \see migrateLedger()
+bool migrateAuth(dbo::SqlConnectionPool& pool);
+
+} // namespace db
+#endif
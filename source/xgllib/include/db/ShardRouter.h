@@ -0,0 +1,128 @@
+//! \brief Per-company database routing
+//! \file ShardRouter.h
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _SHARD_ROUTER_H_
+#define _SHARD_ROUTER_H_
+#include <Wt/Dbo/SqlConnectionPool.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "db/Database.h"
+#include "db/LedgerCache.h"
+#include "db/LedgerSession.h"
+
+namespace db
+{
+
+//! \brief Shard Router
+//!
+//! Each client company's ledger and payroll data is kept in its own
+//! database (a SQLite file, or a PostgreSQL schema; \see DatabaseConfig),
+//! apart from the shared authentication database.  Lock contention and
+//! size are then per company, and a large company doesn't slow down a
+//! small one.
+//!
+//! The router maps a company id to that company's database, opening a
+//! connection pool for it on first use (and creating its tables), and
+//! hands out sessions on the pool.  It is shared by the whole process.
+//!
+//! A company's closed periods are archived in a directory next to its
+//! database (\see ArchiveStore); its sessions read them too.
+//!
+//! A company's balances and year to date payroll are also held in memory
+//! (\see LedgerCache), from first use, and checkpointed next to its
+//! database.
+//!
+class ShardRouter
+{
+public:
+  //! \brief Constructor
+  //!
+  //! \param config       Where the company databases are.
+  ShardRouter(const DatabaseConfig& config);
+
+  //! \brief Constructor, for SQLite databases
+  //!
+  //! \param directory    Directory holding the company databases.
+  //! \param poolSize     Connections per company.
+  ShardRouter(const std::string& directory, int poolSize = 4);
+
+  ShardRouter(const ShardRouter&) = delete;
+  ShardRouter& operator=(const ShardRouter&) = delete;
+
+  //! \brief Open a session on a company's database
+  std::unique_ptr<LedgerSession> session(long long companyId);
+
+  //! \brief Get a company's in-memory ledger state
+  LedgerCache& cache(long long companyId);
+
+  //! \brief Load the in-memory state of every company that has a checkpoint
+  //!
+  //! For server startup: each company's checkpoint is read and the
+  //! journal after it taken in.
+  //!
+  //! \returns
+  //! The number of companies loaded.
+  std::size_t restore();
+
+  //! \brief Checkpoint the in-memory state of every company in use
+  //!
+  //! Failures are logged, and retried on the next call.
+  void checkpoint();
+
+  //! \brief Get the database configuration
+  const DatabaseConfig& config() const { return config_; }
+
+  //! \brief Get the database name of a company, \see DatabaseConfig
+  static std::string databaseName(long long companyId);
+
+  //! \brief Get the database file of a company, when using SQLite
+  std::string databaseFile(long long companyId) const;
+
+  //! \brief Get the closed period archive directory of a company
+  std::string archiveDirectory(long long companyId) const;
+
+  //! \brief Get the ledger state checkpoint file of a company
+  std::string checkpointFile(long long companyId) const;
+
+private:
+  //! One company's database.  Opened (and migrated) under its own mutex,
+  //! so a large company's first use doesn't hold up the others; the
+  //! mutex also guards the cache.
+  struct Shard
+  {
+    std::mutex mutex;
+    std::unique_ptr<dbo::SqlConnectionPool> pool;
+    std::unique_ptr<ArchiveStore> archives;
+    std::unique_ptr<LedgerCache> cache;
+  };
+
+  //! \brief Get a company's shard, opening it on first use
+  Shard& shard(long long companyId);
+
+  DatabaseConfig config_;
+
+  //! Guards shards_ itself; never held while a database is opened
+  std::mutex mutex_;
+  std::map<long long, Shard> shards_;
+};
+
+} // namespace db
+#endif
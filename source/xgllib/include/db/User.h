@@ -32,9 +32,14 @@ using AuthInfo = Wt::Auth::Dbo::AuthInfo<User>;
 //!
 class User {
 public:
+  //! \brief The company whose books the user keeps, \see ShardRouter;
+  //! 0 for none
+  long long companyId = 0;
+
   template<class Action>
   void persist(Action& a)
   {
+    dbo::field(a, companyId, "company_id");
   }
 };
 
@@ -0,0 +1,35 @@
+//! \file File.h
+//! \brief Durable file replacement
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _UTIL_FILE_H_
+#define _UTIL_FILE_H_
+#include <string>
+
+namespace util {
+
+    //! \brief Replace a file's contents, all or nothing
+    //!
+    //! The data is written to a temporary name beside the file, synced,
+    //! and renamed into place, so a reader (or a crash) never sees half of
+    //! it.
+    //!
+    //! \throws std::runtime_error if the file can't be written.
+    void writeFile(const std::string& file, const std::string& data);
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+//! \file MpscQueue.h
+//! \brief Lock-free multiple producer, single consumer queue
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef _MPSC_QUEUE_H_
+#define _MPSC_QUEUE_H_
+#include <atomic>
+#include <utility>
+
+//! \brief Utility namespace
+//!
+//! General purpose building blocks that aren't specific to accounting.
+namespace util {
+
+    //! \brief Lock-free multiple producer, single consumer queue
+    //!
+    //! An unbounded linked list queue (after Dmitry Vyukov's intrusive MPSC
+    //! queue).  Any number of threads may push concurrently; a push is a
+    //! single atomic exchange and never blocks.  Only one thread may pop.
+    //!
+    //! A pop can miss an item whose push is still in progress; the item is
+    //! returned by a later pop.
+    //!
+    //! \tparam T   Item type; must be default constructible and movable.
+    template <typename T>
+    class MpscQueue {
+    public:
+        MpscQueue()
+            : _head(new Node()),
+              _tail(_head.load())
+        {
+        }
+
+        ~MpscQueue()
+        {
+            T discard;
+            while (pop(discard))
+                ;
+            delete _tail;
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        //! \brief Add an item; safe to call from any thread
+        void push(T value)
+        {
+            Node *node = new Node();
+            node->value = std::move(value);
+
+            Node *prev = _head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        //! \brief Remove the oldest item; consumer thread only
+        //!
+        //! \returns
+        //! true if an item was moved into \p value.
+        bool pop(T& value)
+        {
+            Node *tail = _tail;
+            Node *next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            value = std::move(next->value);
+            _tail = next;
+            delete tail;
+            return true;
+        }
+
+        //! \brief Check for pending items; consumer thread only
+        bool empty() const
+        {
+            return _tail->next.load(std::memory_order_acquire) == nullptr;
+        }
+
+    private:
+        struct Node {
+            std::atomic<Node*> next{ nullptr };
+            T value;
+        };
+
+        std::atomic<Node*> _head;
+        Node *_tail;
+    };
+
+}
+
+#endif
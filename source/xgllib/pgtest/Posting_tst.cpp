@@ -0,0 +1,141 @@
+/**
+ * \file Posting_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "db/ChangeLog.h"
+#include "db/JournalCopy.h"
+#include "db/JournalEntry.h"
+#include "db/LedgerSession.h"
+#include "db/PostingService.h"
+#include "db/ShardRouter.h"
+#include <gtest/gtest.h>
+
+#include <Wt/Dbo/backend/Postgres.h>
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <vector>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+namespace
+{
+    //! Configuration for the instance under test, or false to skip
+    bool postgres(db::DatabaseConfig &config)
+    {
+        const char *connection = std::getenv("XGL_TEST_POSTGRES");
+        if (!connection || !*connection)
+            return false;
+
+        config.backend = db::DatabaseConfig::ePostgres;
+        config.connection = connection;
+        config.directory = ::testing::TempDir();
+        config.poolSize = 2;
+        config.writers = 4;
+        return true;
+    }
+
+    //! Start a company from nothing
+    void dropCompany(const db::DatabaseConfig &config, long long companyId)
+    {
+        Wt::Dbo::backend::Postgres admin(config.connection);
+        admin.executeSql("drop schema if exists " + db::ShardRouter::databaseName(companyId) + " cascade");
+    }
+
+    JournalEntry sale(int date, double amount)
+    {
+        JournalEntry e;
+        e.date = date;
+        e.memo = "Sale\t#" + std::to_string(date);
+        e.lines.push_back(JournalLine{ 1000, amount, "" });
+        e.lines.push_back(JournalLine{ 4000, -amount, "" });
+        return e;
+    }
+}
+
+TEST(Postgres_tests, posting)
+{
+    db::DatabaseConfig config;
+    if (!postgres(config))
+        GTEST_SKIP() << "XGL_TEST_POSTGRES is not set";
+
+    const long long first = 9000001;
+    const int companies = 8;
+    const int entries = 500;
+    for (long long id = first; id < first + companies; ++id)
+        dropCompany(config, id);
+
+    db::ShardRouter router(config);
+    {
+        db::PostingService posting(router, 64, config.writers);
+
+        std::vector<std::future<long long>> ids;
+        for (int i = 0; i < entries; ++i)
+            for (long long id = first; id < first + companies; ++id)
+                ids.push_back(posting.post(id, sale(toDays(2021, 1, 1) + i % 365, 10.0 + id - first)));
+
+        for (std::future<long long> &id : ids)
+            ASSERT_GT(id.get(), 0);
+    }
+
+    for (long long id = first; id < first + companies; ++id)
+    {
+        std::unique_ptr<db::LedgerSession> session = router.session(id);
+        Balances balances = db::loadBalances(*session, toDays(2021, 12, 31));
+        ASSERT_DOUBLE_EQ(entries * (10.0 + id - first), balances[1000]);
+        ASSERT_DOUBLE_EQ(-entries * (10.0 + id - first), balances[4000]);
+
+        // The COPY path records the change feed too.
+        db::ChangeCursor cursor(*session);
+        std::size_t posted = 0;
+        for (std::vector<Change> changes; !(changes = cursor.next()).empty();)
+            posted += std::count_if(changes.begin(), changes.end(),
+                                    [](const Change &change) { return change.kind == Change::eJournalEntry; });
+        ASSERT_EQ(static_cast<std::size_t>(entries), posted);
+    }
+}
+
+TEST(Postgres_tests, copy_throughput)
+{
+    db::DatabaseConfig config;
+    if (!postgres(config))
+        GTEST_SKIP() << "XGL_TEST_POSTGRES is not set";
+
+    const long long companyId = 9000101;
+    const int entries = 100000;
+    dropCompany(config, companyId);
+
+    db::ShardRouter router(config);
+    router.session(companyId);
+
+    std::vector<JournalEntry> batch;
+    for (int i = 0; i < entries; ++i)
+        batch.push_back(sale(toDays(2021, 1, 1) + i % 365, 1.25));
+
+    db::JournalCopy copy(config.connectionString(db::ShardRouter::databaseName(companyId)));
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < batch.size(); i += 4096)
+    {
+        std::vector<const JournalEntry *> group;
+        for (std::size_t j = i; j < std::min(batch.size(), i + 4096); ++j)
+            group.push_back(&batch[j]);
+        ASSERT_EQ(group.size(), copy.insert(group, INT_MIN).size());
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << entries << " entries by COPY in " << elapsed.count() << " s, "
+              << static_cast<long long>(entries / elapsed.count()) << " entries/s" << std::endl;
+
+    std::unique_ptr<db::LedgerSession> session = router.session(companyId);
+    Balances balances = db::loadBalances(*session, toDays(2021, 12, 31));
+    ASSERT_NEAR(entries * 1.25, balances[1000], 0.005);
+}
@@ -0,0 +1,499 @@
+//! \file ChangeFeed.cpp
+//! \brief Sequenced changes to a company's books, and their export formats
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/ChangeFeed.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+
+#include "accounting/Date.h"
+
+namespace accounting {
+
+namespace {
+
+    const char MAGIC[4] = { 'X', 'G', 'L', 'F' };
+    const char VERSION = 1;
+
+    // Larger than any change; a bigger size is damage.
+    const std::uint64_t MAX_PAYLOAD = 1 << 26;
+
+    long long toCents(double amount) { return std::llround(amount * 100); }
+
+    [[noreturn]] void damaged() { throw std::runtime_error("damaged change"); }
+
+    void unsignedValue(std::string &out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    //! Zigzag: small negative numbers encode as small as small positive ones.
+    void value(std::string &out, long long value)
+    {
+        unsignedValue(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void text(std::string &out, const std::string &text)
+    {
+        unsignedValue(out, text.size());
+        out += text;
+    }
+
+    //! \brief Reads a payload back; throws on running off the end
+    class Decoder {
+    public:
+        Decoder(const char *begin, const char *end)
+            : _p(begin), _end(end)
+        {
+        }
+
+        std::uint64_t unsignedValue()
+        {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (_p == _end)
+                    damaged();
+                const unsigned char byte = static_cast<unsigned char>(*_p++);
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            damaged();
+        }
+
+        long long value()
+        {
+            const std::uint64_t v = unsignedValue();
+            return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+        }
+
+        double amount() { return value() / 100.0; }
+
+        std::string text()
+        {
+            const std::uint64_t size = unsignedValue();
+            if (size > static_cast<std::uint64_t>(_end - _p))
+                damaged();
+            std::string text(_p, size);
+            _p += size;
+            return text;
+        }
+
+        bool done() const { return _p == _end; }
+
+    private:
+        const char *_p;
+        const char *_end;
+    };
+
+    //! Reads a varint from a stream; false at a clean end of stream
+    bool readUnsigned(std::istream &in, std::uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const int byte = in.get();
+            if (byte == std::char_traits<char>::eof())
+            {
+                if (shift == 0)
+                    return false;
+                damaged();
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        damaged();
+    }
+
+    void jsonNumber(std::string &out, long long value)
+    {
+        char buffer[24];
+        out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+    }
+
+    void jsonNumber(std::string &out, double value)
+    {
+        char buffer[32];
+        out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+    }
+
+    void jsonString(std::string &out, const std::string &text)
+    {
+        out += '"';
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    out += escape;
+                }
+                else
+                    out += c;
+            }
+        }
+        out += '"';
+    }
+
+    void jsonDate(std::string &out, int days)
+    {
+        int year, month, day;
+        fromDays(days, year, month, day);
+        char date[16];
+        std::snprintf(date, sizeof(date), "\"%04d-%02d-%02d\"", year, month, day);
+        out += date;
+    }
+
+    //! Appends ,"key":
+    void key(std::string &out, const char *key)
+    {
+        out += ",\"";
+        out += key;
+        out += "\":";
+    }
+
+    const char *kindName(Change::eKIND kind)
+    {
+        switch (kind)
+        {
+        case Change::eJournalEntry:
+            return "journal_entry";
+        case Change::eBalance:
+            return "balance";
+        case Change::ePaycheck:
+            return "paycheck";
+        case Change::ePeriodClosed:
+            return "period_closed";
+        }
+        return "unknown";
+    }
+
+    void json(std::string &out, const Change &change)
+    {
+        out += "{\"seq\":";
+        jsonNumber(out, change.sequence);
+        key(out, "kind");
+        jsonString(out, kindName(change.kind));
+        key(out, "date");
+        jsonDate(out, change.date);
+
+        switch (change.kind)
+        {
+        case Change::eJournalEntry:
+            key(out, "id");
+            jsonNumber(out, change.id);
+            key(out, "memo");
+            jsonString(out, change.entry.memo);
+            key(out, "lines");
+            out += '[';
+            for (std::size_t i = 0; i < change.entry.lines.size(); ++i)
+            {
+                const ledger::JournalLine &line = change.entry.lines[i];
+                out += i ? ",{\"account\":" : "{\"account\":";
+                jsonNumber(out, line.account_id);
+                key(out, "amount");
+                jsonNumber(out, line.amount);
+                key(out, "reference");
+                jsonString(out, line.reference);
+                key(out, "currency");
+                jsonString(out, line.currency.code());
+                key(out, "currency_amount");
+                jsonNumber(out, line.currency == USD ? line.amount : line.currency_amount);
+                out += '}';
+            }
+            out += ']';
+            break;
+        case Change::eBalance:
+            key(out, "id");
+            jsonNumber(out, change.id);
+            key(out, "account");
+            jsonNumber(out, change.account_id);
+            key(out, "amount");
+            jsonNumber(out, change.amount);
+            break;
+        case Change::ePaycheck:
+            key(out, "employee");
+            jsonNumber(out, change.paycheck.employee_id);
+            key(out, "period");
+            jsonNumber(out, static_cast<long long>(change.paycheck.period));
+            key(out, "gross_wages");
+            jsonNumber(out, change.paycheck.gross_wages);
+            key(out, "oasdi_wages");
+            jsonNumber(out, change.paycheck.oasdi_wages);
+            key(out, "oasdi_employee");
+            jsonNumber(out, change.paycheck.oasdi_employee);
+            key(out, "oasdi_employer");
+            jsonNumber(out, change.paycheck.oasdi_employer);
+            key(out, "futa_wages");
+            jsonNumber(out, change.paycheck.futa_wages);
+            break;
+        case Change::ePeriodClosed:
+            break;
+        }
+
+        out += "}\n";
+    }
+
+}
+
+std::vector<Change> Change::posted(long long entryId, const ledger::JournalEntry &entry)
+{
+    std::vector<Change> changes(1);
+    changes[0].kind = eJournalEntry;
+    changes[0].date = entry.date;
+    changes[0].id = entryId;
+    changes[0].entry = entry;
+
+    std::map<long long, long long> moved;
+    for (const ledger::JournalLine &line : entry.lines)
+        moved[line.account_id] += toCents(line.amount);
+
+    for (const auto &account : moved)
+    {
+        if (!account.second)
+            continue;
+        Change balance;
+        balance.kind = eBalance;
+        balance.date = entry.date;
+        balance.id = entryId;
+        balance.account_id = account.first;
+        balance.amount = account.second / 100.0;
+        changes.push_back(balance);
+    }
+
+    return changes;
+}
+
+Change Change::paid(int payDate, const payroll::Paycheck &check)
+{
+    Change change;
+    change.kind = ePaycheck;
+    change.date = payDate;
+    change.paycheck = check;
+    return change;
+}
+
+Change Change::closed(int lastDay)
+{
+    Change change;
+    change.kind = ePeriodClosed;
+    change.date = lastDay;
+    return change;
+}
+
+std::string Change::encode() const
+{
+    std::string out;
+    unsignedValue(out, kind);
+    value(out, date);
+
+    switch (kind)
+    {
+    case eJournalEntry:
+        value(out, id);
+        text(out, entry.memo);
+        unsignedValue(out, entry.lines.size());
+        for (const ledger::JournalLine &line : entry.lines)
+        {
+            value(out, line.account_id);
+            value(out, toCents(line.amount));
+            text(out, line.reference);
+            text(out, line.currency.code());
+            value(out, toCents(line.currency == USD ? line.amount : line.currency_amount));
+        }
+        break;
+    case eBalance:
+        value(out, id);
+        value(out, account_id);
+        value(out, toCents(amount));
+        break;
+    case ePaycheck:
+        value(out, paycheck.employee_id);
+        value(out, paycheck.period);
+        value(out, toCents(paycheck.gross_wages));
+        value(out, toCents(paycheck.oasdi_wages));
+        value(out, toCents(paycheck.oasdi_employee));
+        value(out, toCents(paycheck.oasdi_employer));
+        value(out, toCents(paycheck.futa_wages));
+        break;
+    case ePeriodClosed:
+        break;
+    }
+
+    return out;
+}
+
+Change Change::decode(long long sequence, const std::string &data)
+{
+    Decoder in(data.data(), data.data() + data.size());
+
+    Change change;
+    change.sequence = sequence;
+    const std::uint64_t kind = in.unsignedValue();
+    if (kind < eJournalEntry || kind > ePeriodClosed)
+        damaged();
+    change.kind = static_cast<eKIND>(kind);
+    change.date = static_cast<int>(in.value());
+
+    switch (change.kind)
+    {
+    case eJournalEntry:
+    {
+        change.id = in.value();
+        change.entry.date = change.date;
+        change.entry.memo = in.text();
+        const std::uint64_t lines = in.unsignedValue();
+        if (lines > data.size())
+            damaged();
+        change.entry.lines.reserve(lines);
+        for (std::uint64_t i = 0; i < lines; ++i)
+        {
+            ledger::JournalLine line;
+            line.account_id = in.value();
+            line.amount = in.amount();
+            line.reference = in.text();
+            try
+            {
+                line.currency = Currency(in.text());
+            }
+            catch (std::invalid_argument &)
+            {
+                damaged();
+            }
+            line.currency_amount = in.amount();
+            change.entry.lines.push_back(line);
+        }
+        break;
+    }
+    case eBalance:
+        change.id = in.value();
+        change.account_id = in.value();
+        change.amount = in.amount();
+        break;
+    case ePaycheck:
+    {
+        int year, month, day;
+        fromDays(change.date, year, month, day);
+        change.paycheck.year = year;
+        change.paycheck.month = month;
+        change.paycheck.employee_id = in.value();
+        change.paycheck.period = static_cast<int>(in.value());
+        change.paycheck.gross_wages = in.amount();
+        change.paycheck.oasdi_wages = in.amount();
+        change.paycheck.oasdi_employee = in.amount();
+        change.paycheck.oasdi_employer = in.amount();
+        change.paycheck.futa_wages = in.amount();
+        break;
+    }
+    case ePeriodClosed:
+        break;
+    }
+
+    if (!in.done())
+        damaged();
+    return change;
+}
+
+ChangeWriter::ChangeWriter(std::ostream &out, eFORMAT format)
+    : _out(out),
+      _format(format),
+      _sequence(0),
+      _written(0)
+{
+    if (_format == eBinary)
+    {
+        _out.write(MAGIC, sizeof(MAGIC));
+        _out.put(VERSION);
+    }
+}
+
+void ChangeWriter::write(const Change &change)
+{
+    _buffer.clear();
+    if (_format == eBinary)
+    {
+        const std::string payload = change.encode();
+        value(_buffer, change.sequence - _sequence);
+        text(_buffer, payload);
+    }
+    else
+        json(_buffer, change);
+
+    _out.write(_buffer.data(), _buffer.size());
+    _sequence = change.sequence;
+    ++_written;
+}
+
+ChangeReader::ChangeReader(std::istream &in)
+    : _in(in),
+      _sequence(0)
+{
+    char header[sizeof(MAGIC) + 1];
+    if (!_in.read(header, sizeof(header)) || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), header))
+        throw std::runtime_error("not a change feed");
+    if (header[sizeof(MAGIC)] != VERSION)
+        throw std::runtime_error("unknown change feed version");
+}
+
+bool ChangeReader::read(Change &change)
+{
+    std::uint64_t delta;
+    if (!readUnsigned(_in, delta))
+        return false;
+
+    std::uint64_t size;
+    if (!readUnsigned(_in, size) || size > MAX_PAYLOAD)
+        damaged();
+    std::string payload(size, '\0');
+    if (size && !_in.read(&payload[0], size))
+        damaged();
+
+    _sequence += static_cast<long long>(delta >> 1) ^ -static_cast<long long>(delta & 1);
+    change = Change::decode(_sequence, payload);
+    return true;
+}
+
+}
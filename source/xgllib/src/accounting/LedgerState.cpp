@@ -0,0 +1,262 @@
+//! \file LedgerState.cpp
+//! \brief In-memory ledger state and its checkpoint file
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/LedgerState.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "util/File.h"
+
+namespace accounting {
+
+namespace {
+
+    const char MAGIC[4] = { 'X', 'G', 'L', 'C' };
+    const std::uint32_t VERSION = 3;
+
+    // The file layout.  Every field is naturally aligned, so the records
+    // can be used where they're mapped.
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::int64_t last_line;
+        std::int64_t last_paycheck;
+        std::int32_t closed_through;
+        std::uint32_t reserved;
+        std::uint64_t balances;
+        std::uint64_t ytd;
+        std::uint64_t checksum;
+    };
+
+    struct BalanceRecord {
+        std::int64_t account;
+        std::int64_t cents;
+    };
+
+    struct YtdRecord {
+        std::int64_t employee;
+        std::int32_t year;
+        std::uint32_t reserved;
+        std::int64_t oasdi_wages;
+        std::int64_t oasdi_employee;
+        std::int64_t futa_wages;
+    };
+
+    long long toCents(double amount) { return std::llround(amount * 100); }
+
+    //! \brief FNV-1a, over the header (its checksum zero) and the records
+    std::uint64_t checksum(Header header, const char *records, std::size_t size)
+    {
+        header.checksum = 0;
+
+        std::uint64_t hash = 14695981039346656037ull;
+        const char *data = reinterpret_cast<const char *>(&header);
+        for (std::size_t i = 0; i < sizeof(header); ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(records[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    //! \brief A read-only mapping of a whole file
+    class Mapping {
+    public:
+        explicit Mapping(const std::string &file)
+            : _data(nullptr),
+              _size(0)
+        {
+            const int fd = ::open(file.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("can't read " + file);
+
+            struct stat status;
+            if (::fstat(fd, &status) == 0 && status.st_size > 0)
+            {
+                _size = static_cast<std::size_t>(status.st_size);
+                void *data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                _data = data == MAP_FAILED ? nullptr : static_cast<const char *>(data);
+            }
+            ::close(fd);
+
+            if (!_data)
+                throw std::runtime_error("can't read " + file);
+        }
+
+        ~Mapping() { ::munmap(const_cast<char *>(_data), _size); }
+
+        Mapping(const Mapping &) = delete;
+        Mapping &operator=(const Mapping &) = delete;
+
+        const char *data() const { return _data; }
+        std::size_t size() const { return _size; }
+
+    private:
+        const char *_data;
+        std::size_t _size;
+    };
+
+}
+
+LedgerState::LedgerState()
+    : _last_line(0),
+      _last_paycheck(0),
+      _closed_through(INT_MIN)
+{
+}
+
+LedgerState::LedgerState(const std::string &file)
+{
+    const Mapping mapping(file);
+
+    if (mapping.size() < sizeof(Header))
+        throw std::runtime_error(file + " is not a checkpoint");
+    const Header &header = *reinterpret_cast<const Header *>(mapping.data());
+    if (!std::equal(MAGIC, MAGIC + sizeof(MAGIC), header.magic))
+        throw std::runtime_error(file + " is not a checkpoint");
+    if (header.version != VERSION)
+        throw std::runtime_error(file + " is an unknown checkpoint version");
+
+    const std::size_t records = mapping.size() - sizeof(Header);
+    if (header.balances > records / sizeof(BalanceRecord) ||
+        records != header.balances * sizeof(BalanceRecord) + header.ytd * sizeof(YtdRecord) ||
+        header.checksum != checksum(header, mapping.data() + sizeof(Header), records))
+        throw std::runtime_error(file + " is damaged");
+
+    _last_line = header.last_line;
+    _last_paycheck = header.last_paycheck;
+    _closed_through = header.closed_through;
+
+    const BalanceRecord *balance = reinterpret_cast<const BalanceRecord *>(mapping.data() + sizeof(Header));
+    _balances.reserve(header.balances);
+    for (std::size_t i = 0; i < header.balances; ++i, ++balance)
+        _balances.emplace(balance->account, balance->cents);
+
+    const YtdRecord *ytd = reinterpret_cast<const YtdRecord *>(balance);
+    _ytd.reserve(header.ytd);
+    for (std::size_t i = 0; i < header.ytd; ++i, ++ytd)
+        _ytd.emplace(YearKey{ ytd->employee, ytd->year }, Totals{ ytd->oasdi_wages, ytd->oasdi_employee, ytd->futa_wages });
+}
+
+void LedgerState::checkpoint(const std::string &file) const
+{
+    std::vector<BalanceRecord> balances;
+    balances.reserve(_balances.size());
+    for (const auto &balance : _balances)
+        balances.push_back(BalanceRecord{ balance.first, balance.second });
+    std::sort(balances.begin(), balances.end(),
+              [](const BalanceRecord &a, const BalanceRecord &b) { return a.account < b.account; });
+
+    std::vector<YtdRecord> ytd;
+    ytd.reserve(_ytd.size());
+    for (const auto &totals : _ytd)
+        ytd.push_back(YtdRecord{ totals.first.employee, totals.first.year, 0,
+                                 totals.second.oasdi_wages, totals.second.oasdi_employee,
+                                 totals.second.futa_wages });
+    std::sort(ytd.begin(), ytd.end(), [](const YtdRecord &a, const YtdRecord &b) {
+        return a.employee != b.employee ? a.employee < b.employee : a.year < b.year;
+    });
+
+    const std::size_t balanceBytes = balances.size() * sizeof(BalanceRecord);
+    const std::size_t ytdBytes = ytd.size() * sizeof(YtdRecord);
+    std::string data(sizeof(Header) + balanceBytes + ytdBytes, '\0');
+    char *records = &data[sizeof(Header)];
+    if (balanceBytes)
+        std::memcpy(records, balances.data(), balanceBytes);
+    if (ytdBytes)
+        std::memcpy(records + balanceBytes, ytd.data(), ytdBytes);
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.last_line = _last_line;
+    header.last_paycheck = _last_paycheck;
+    header.closed_through = _closed_through;
+    header.balances = balances.size();
+    header.ytd = ytd.size();
+    header.checksum = checksum(header, records, balanceBytes + ytdBytes);
+    std::memcpy(&data[0], &header, sizeof(header));
+
+    util::writeFile(file, data);
+}
+
+void LedgerState::post(long long lineId, long long accountId, double amount)
+{
+    _balances[accountId] += toCents(amount);
+    _last_line = std::max(_last_line, lineId);
+}
+
+void LedgerState::pay(long long paycheckId, const payroll::Paycheck &check)
+{
+    Totals &totals = _ytd[YearKey{ check.employee_id, check.year }];
+    totals.oasdi_wages += toCents(check.oasdi_wages);
+    totals.oasdi_employee += toCents(check.oasdi_employee);
+    totals.futa_wages += toCents(check.futa_wages);
+    _last_paycheck = std::max(_last_paycheck, paycheckId);
+}
+
+void LedgerState::clearYear(int year)
+{
+    for (auto totals = _ytd.begin(); totals != _ytd.end();)
+    {
+        if (totals->first.year == year)
+            totals = _ytd.erase(totals);
+        else
+            ++totals;
+    }
+}
+
+double LedgerState::balance(long long accountId) const
+{
+    const auto found = _balances.find(accountId);
+    return found == _balances.end() ? 0.0 : found->second / 100.0;
+}
+
+ledger::Balances LedgerState::balances(const std::vector<long long> &accounts) const
+{
+    ledger::Balances balances;
+    for (long long account : accounts)
+        balances[account] = balance(account);
+    return balances;
+}
+
+PayrollTotals LedgerState::yearToDate(long long employeeId, int year) const
+{
+    const auto found = _ytd.find(YearKey{ employeeId, year });
+    if (found == _ytd.end())
+        return PayrollTotals{ 0, 0, 0 };
+    return PayrollTotals{ found->second.oasdi_wages / 100.0, found->second.oasdi_employee / 100.0,
+                          found->second.futa_wages / 100.0 };
+}
+
+}
@@ -0,0 +1,554 @@
+//! \file PeriodArchive.cpp
+//! \brief Compressed columnar archive of a closed accounting period
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/PeriodArchive.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "accounting/Date.h"
+#include "util/File.h"
+
+namespace accounting {
+
+namespace {
+
+    const char MAGIC[4] = { 'X', 'G', 'L', 'A' };
+    const char VERSION = 1;
+
+    long long toCents(double amount) { return std::llround(amount * 100); }
+
+    //! \brief FNV-1a, over the file up to the checksum
+    std::uint64_t checksum(const char *data, std::size_t size)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    //! \brief Appends varints and strings to a column
+    class Encoder {
+    public:
+        void unsignedValue(std::uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                _data.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            _data.push_back(static_cast<char>(value));
+        }
+
+        //! Zigzag: small negative numbers encode as small as small positive ones.
+        void value(long long value)
+        {
+            unsignedValue((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+        }
+
+        void text(const std::string &text)
+        {
+            unsignedValue(text.size());
+            _data += text;
+        }
+
+        void column(const Encoder &column)
+        {
+            text(column._data);
+        }
+
+        std::string &data() { return _data; }
+
+    private:
+        std::string _data;
+    };
+
+    //! \brief Reads varints and strings back; throws on running off the end
+    class Decoder {
+    public:
+        Decoder(const char *begin, const char *end)
+            : _p(begin), _end(end)
+        {
+        }
+
+        std::uint64_t unsignedValue()
+        {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (_p == _end)
+                    damaged();
+                const unsigned char byte = static_cast<unsigned char>(*_p++);
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            damaged();
+        }
+
+        long long value()
+        {
+            const std::uint64_t v = unsignedValue();
+            return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+        }
+
+        std::string text()
+        {
+            const std::uint64_t size = unsignedValue();
+            if (size > static_cast<std::uint64_t>(_end - _p))
+                damaged();
+            std::string text(_p, size);
+            _p += size;
+            return text;
+        }
+
+        //! The next column, as a decoder of its own
+        Decoder column()
+        {
+            const std::uint64_t size = unsignedValue();
+            if (size > static_cast<std::uint64_t>(_end - _p))
+                damaged();
+            Decoder column(_p, _p + size);
+            _p += size;
+            return column;
+        }
+
+        //! A row count; every row takes at least a byte, so a count
+        //! larger than what's left is damage
+        std::size_t count()
+        {
+            const std::uint64_t count = unsignedValue();
+            if (count > static_cast<std::uint64_t>(_end - _p))
+                damaged();
+            return count;
+        }
+
+        std::size_t index(std::size_t size)
+        {
+            const std::uint64_t index = unsignedValue();
+            if (index >= size)
+                damaged();
+            return index;
+        }
+
+    private:
+        [[noreturn]] static void damaged() { throw std::runtime_error("damaged archive"); }
+
+        const char *_p;
+        const char *_end;
+    };
+
+    //! \brief Positions 0 .. n-1 sorted by a comparison
+    template<typename Less>
+    std::vector<std::size_t> order(std::size_t n, Less less)
+    {
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), less);
+        return order;
+    }
+
+}
+
+PeriodArchive::PeriodArchive(int first, int last)
+    : _first(first),
+      _last(last)
+{
+}
+
+PeriodArchive::PeriodArchive(const std::string &file)
+{
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream)
+        throw std::runtime_error("can't read " + file);
+    const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(MAGIC) + 1 + 8 || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), data.begin()))
+        throw std::runtime_error(file + " is not an archive");
+    if (data[sizeof(MAGIC)] != VERSION)
+        throw std::runtime_error(file + " is an unknown archive version");
+
+    const std::size_t body = data.size() - 8;
+    std::uint64_t stored = 0;
+    for (int i = 7; i >= 0; --i)
+        stored = (stored << 8) | static_cast<unsigned char>(data[body + i]);
+    if (stored != checksum(data.data(), body))
+        throw std::runtime_error(file + " is damaged");
+
+    Decoder in(data.data() + sizeof(MAGIC) + 1, data.data() + body);
+    _first = static_cast<int>(in.value());
+    _last = static_cast<int>(in.value());
+    const std::size_t entries = in.count();
+    const std::size_t lines = in.count();
+    const std::size_t paychecks = in.count();
+    const std::size_t accounts = in.count();
+    const std::size_t currencies = in.count();
+
+    Decoder accountColumn = in.column();
+    long long account = 0;
+    _accounts.reserve(accounts);
+    for (std::size_t i = 0; i < accounts; ++i)
+    {
+        account += accountColumn.value();
+        _account_index.emplace(account, static_cast<std::uint32_t>(i));
+        _accounts.push_back(account);
+    }
+    _account_total.assign(accounts, 0);
+
+    Decoder currencyColumn = in.column();
+    for (std::size_t i = 0; i < currencies; ++i)
+    {
+        const std::uint64_t packed = currencyColumn.unsignedValue();
+        _currencies.push_back(Currency(std::string{ static_cast<char>(packed >> 16), static_cast<char>(packed >> 8),
+                                                    static_cast<char>(packed) }));
+    }
+
+    Decoder entryId = in.column(), entryDate = in.column(), memo = in.column();
+    _entry_id.resize(entries);
+    _entry_date.resize(entries);
+    _memo.resize(entries);
+    long long id = 0, date = 0;
+    for (std::size_t i = 0; i < entries; ++i)
+    {
+        _entry_id[i] = id += entryId.value();
+        _entry_date[i] = static_cast<int>(date += entryDate.value());
+        _memo[i] = memo.text();
+    }
+
+    Decoder lineDate = in.column(), lineEntry = in.column(), lineId = in.column(), lineAccount = in.column(),
+            amount = in.column(), reference = in.column(), lineCurrency = in.column(),
+            currencyAmount = in.column();
+    _line_id.resize(lines);
+    _line_entry.resize(lines);
+    _line_date.resize(lines);
+    _line_account.resize(lines);
+    _amount.resize(lines);
+    _reference.resize(lines);
+    _line_currency.resize(lines);
+    _currency_amount.resize(lines);
+    long long entry = 0;
+    id = date = 0;
+    for (std::size_t i = 0; i < lines; ++i)
+    {
+        _line_date[i] = static_cast<int>(date += lineDate.value());
+        _line_entry[i] = entry += lineEntry.value();
+        _line_id[i] = id += lineId.value();
+        _line_account[i] = static_cast<std::uint32_t>(lineAccount.index(accounts));
+        _amount[i] = amount.value();
+        _reference[i] = reference.text();
+        _line_currency[i] = static_cast<std::uint32_t>(lineCurrency.index(currencies));
+        _currency_amount[i] = _currencies[_line_currency[i]] == USD ? _amount[i] : currencyAmount.value();
+        _account_total[_line_account[i]] += _amount[i];
+    }
+
+    Decoder employee = in.column(), payDate = in.column(), period = in.column();
+    Decoder money[5] = { in.column(), in.column(), in.column(), in.column(), in.column() };
+    _paychecks.resize(paychecks);
+    long long employeeId = 0;
+    date = 0;
+    for (std::size_t i = 0; i < paychecks; ++i)
+    {
+        ArchivedPaycheck &p = _paychecks[i];
+        employeeId += employee.value();
+        const bool same = i > 0 && _paychecks[i - 1].check.employee_id == employeeId;
+        const payroll::Paycheck *previous = same ? &_paychecks[i - 1].check : nullptr;
+
+        p.pay_date = static_cast<int>(date += payDate.value());
+        int day;
+        fromDays(p.pay_date, p.check.year, p.check.month, day);
+        p.check.employee_id = employeeId;
+        p.check.period = static_cast<int>((previous ? previous->period : 0) + period.value());
+
+        double payroll::Paycheck::*fields[5] = { &payroll::Paycheck::gross_wages, &payroll::Paycheck::oasdi_wages,
+                                                 &payroll::Paycheck::oasdi_employee, &payroll::Paycheck::oasdi_employer,
+                                                 &payroll::Paycheck::futa_wages };
+        for (int f = 0; f < 5; ++f)
+        {
+            const long long cents = (previous ? toCents(previous->*fields[f]) : 0) + money[f].value();
+            p.check.*fields[f] = cents / 100.0;
+        }
+    }
+}
+
+std::uint32_t PeriodArchive::accountIndex(long long accountId)
+{
+    auto found = _account_index.emplace(accountId, static_cast<std::uint32_t>(_accounts.size()));
+    if (found.second)
+    {
+        _accounts.push_back(accountId);
+        _account_total.push_back(0);
+    }
+    return found.first->second;
+}
+
+std::uint32_t PeriodArchive::currencyIndex(Currency currency)
+{
+    auto found = std::find(_currencies.begin(), _currencies.end(), currency);
+    if (found != _currencies.end())
+        return static_cast<std::uint32_t>(found - _currencies.begin());
+    _currencies.push_back(currency);
+    return static_cast<std::uint32_t>(_currencies.size() - 1);
+}
+
+void PeriodArchive::add(const ArchivedEntry &entry)
+{
+    _entry_id.push_back(entry.id);
+    _entry_date.push_back(entry.date);
+    _memo.push_back(entry.memo);
+}
+
+void PeriodArchive::add(const ArchivedLine &line)
+{
+    const std::uint32_t account = accountIndex(line.line.account_id);
+    const long long cents = toCents(line.line.amount);
+
+    _line_id.push_back(line.id);
+    _line_entry.push_back(line.entry_id);
+    _line_date.push_back(line.date);
+    _line_account.push_back(account);
+    _amount.push_back(cents);
+    _reference.push_back(line.line.reference);
+    _line_currency.push_back(currencyIndex(line.line.currency));
+    _currency_amount.push_back(line.line.currency == USD ? cents : toCents(line.line.currency_amount));
+    _account_total[account] += cents;
+}
+
+void PeriodArchive::add(const ArchivedPaycheck &paycheck)
+{
+    _paychecks.push_back(paycheck);
+}
+
+void PeriodArchive::write(const std::string &file) const
+{
+    // Dictionaries go out sorted; lines refer to them by rank.
+    const std::vector<std::size_t> accountOrder =
+        order(_accounts.size(), [this](std::size_t a, std::size_t b) { return _accounts[a] < _accounts[b]; });
+    std::vector<std::uint32_t> accountRank(_accounts.size());
+    Encoder accounts;
+    long long previous = 0;
+    for (std::size_t r = 0; r < accountOrder.size(); ++r)
+    {
+        accountRank[accountOrder[r]] = static_cast<std::uint32_t>(r);
+        accounts.value(_accounts[accountOrder[r]] - previous);
+        previous = _accounts[accountOrder[r]];
+    }
+
+    const std::vector<std::size_t> currencyOrder =
+        order(_currencies.size(), [this](std::size_t a, std::size_t b) { return _currencies[a] < _currencies[b]; });
+    std::vector<std::uint32_t> currencyRank(_currencies.size());
+    Encoder currencies;
+    for (std::size_t r = 0; r < currencyOrder.size(); ++r)
+    {
+        currencyRank[currencyOrder[r]] = static_cast<std::uint32_t>(r);
+        currencies.unsignedValue(_currencies[currencyOrder[r]].packed());
+    }
+
+    Encoder entryId, entryDate, memo;
+    long long id = 0, date = 0;
+    for (std::size_t i : order(_entry_id.size(), [this](std::size_t a, std::size_t b) {
+             return std::make_pair(_entry_date[a], _entry_id[a]) < std::make_pair(_entry_date[b], _entry_id[b]);
+         }))
+    {
+        entryId.value(_entry_id[i] - id);
+        entryDate.value(_entry_date[i] - date);
+        memo.text(_memo[i]);
+        id = _entry_id[i];
+        date = _entry_date[i];
+    }
+
+    Encoder lineDate, lineEntry, lineId, lineAccount, amount, reference, lineCurrency, currencyAmount;
+    long long entry = 0;
+    id = date = 0;
+    for (std::size_t i : order(_line_id.size(), [this](std::size_t a, std::size_t b) {
+             return std::make_tuple(_line_date[a], _line_entry[a], _line_id[a]) <
+                    std::make_tuple(_line_date[b], _line_entry[b], _line_id[b]);
+         }))
+    {
+        lineDate.value(_line_date[i] - date);
+        lineEntry.value(_line_entry[i] - entry);
+        lineId.value(_line_id[i] - id);
+        lineAccount.unsignedValue(accountRank[_line_account[i]]);
+        amount.value(_amount[i]);
+        reference.text(_reference[i]);
+        lineCurrency.unsignedValue(currencyRank[_line_currency[i]]);
+        if (_currencies[_line_currency[i]] != USD)
+            currencyAmount.value(_currency_amount[i]);
+        date = _line_date[i];
+        entry = _line_entry[i];
+        id = _line_id[i];
+    }
+
+    // Paychecks by employee, then date, so each check's amounts can be
+    // stored as the change from the employee's last one.
+    Encoder employee, payDate, period;
+    Encoder money[5];
+    double payroll::Paycheck::*fields[5] = { &payroll::Paycheck::gross_wages, &payroll::Paycheck::oasdi_wages,
+                                             &payroll::Paycheck::oasdi_employee, &payroll::Paycheck::oasdi_employer,
+                                             &payroll::Paycheck::futa_wages };
+    const payroll::Paycheck *last = nullptr;
+    long long employeeId = 0;
+    date = 0;
+    for (std::size_t i : order(_paychecks.size(), [this](std::size_t a, std::size_t b) {
+             return std::make_pair(_paychecks[a].check.employee_id, _paychecks[a].pay_date) <
+                    std::make_pair(_paychecks[b].check.employee_id, _paychecks[b].pay_date);
+         }))
+    {
+        const payroll::Paycheck &check = _paychecks[i].check;
+        const bool same = last && last->employee_id == check.employee_id;
+
+        employee.value(check.employee_id - employeeId);
+        payDate.value(_paychecks[i].pay_date - date);
+        period.value(check.period - (same ? last->period : 0));
+        for (int f = 0; f < 5; ++f)
+            money[f].value(toCents(check.*fields[f]) - (same ? toCents(last->*fields[f]) : 0));
+
+        employeeId = check.employee_id;
+        date = _paychecks[i].pay_date;
+        last = &check;
+    }
+
+    Encoder out;
+    out.data().assign(MAGIC, sizeof(MAGIC));
+    out.data().push_back(VERSION);
+    out.value(_first);
+    out.value(_last);
+    out.unsignedValue(_entry_id.size());
+    out.unsignedValue(_line_id.size());
+    out.unsignedValue(_paychecks.size());
+    out.unsignedValue(_accounts.size());
+    out.unsignedValue(_currencies.size());
+    for (const Encoder *column : { &accounts, &currencies, &entryId, &entryDate, &memo, &lineDate, &lineEntry, &lineId,
+                                   &lineAccount, &amount, &reference, &lineCurrency, &currencyAmount, &employee,
+                                   &payDate, &period, &money[0], &money[1], &money[2], &money[3], &money[4] })
+        out.column(*column);
+
+    std::uint64_t sum = checksum(out.data().data(), out.data().size());
+    for (int i = 0; i < 8; ++i, sum >>= 8)
+        out.data().push_back(static_cast<char>(sum & 0xff));
+
+    util::writeFile(file, out.data());
+}
+
+ArchivedEntry PeriodArchive::entry(std::size_t i) const
+{
+    return ArchivedEntry{ _entry_id[i], _entry_date[i], _memo[i] };
+}
+
+ArchivedLine PeriodArchive::line(std::size_t i) const
+{
+    ledger::JournalLine line{ _accounts[_line_account[i]], _amount[i] / 100.0, _reference[i],
+                              _currencies[_line_currency[i]], _currency_amount[i] / 100.0 };
+    return ArchivedLine{ _line_id[i], _line_entry[i], _line_date[i], line };
+}
+
+void PeriodArchive::addBalances(ledger::Balances &balances, int date) const
+{
+    if (date >= _last)
+    {
+        for (std::size_t a = 0; a < _accounts.size(); ++a)
+            balances[_accounts[a]] += _account_total[a] / 100.0;
+        return;
+    }
+
+    std::vector<long long> totals(_accounts.size(), 0);
+    std::vector<char> posted(_accounts.size(), 0);
+    for (std::size_t i = 0; i < _line_id.size(); ++i)
+    {
+        if (_line_date[i] <= date)
+        {
+            totals[_line_account[i]] += _amount[i];
+            posted[_line_account[i]] = 1;
+        }
+    }
+    for (std::size_t a = 0; a < _accounts.size(); ++a)
+    {
+        if (posted[a])
+            balances[_accounts[a]] += totals[a] / 100.0;
+    }
+}
+
+void PeriodArchive::addBalances(ledger::Balances &balances, const std::vector<long long> &accounts) const
+{
+    for (long long account : accounts)
+    {
+        auto found = _account_index.find(account);
+        if (found != _account_index.end())
+            balances[account] += _account_total[found->second] / 100.0;
+    }
+}
+
+void PeriodArchive::addAccountLines(std::vector<ledger::CashLine> &lines, long long accountId, int from,
+                                    int to) const
+{
+    auto found = _account_index.find(accountId);
+    if (found == _account_index.end() || to < _first || from > _last)
+        return;
+
+    const std::size_t begin = lines.size();
+    for (std::size_t i = 0; i < _line_id.size(); ++i)
+    {
+        if (_line_account[i] == found->second && _line_date[i] >= from && _line_date[i] <= to)
+            lines.push_back(ledger::CashLine{ _line_id[i], _line_date[i], _amount[i] / 100.0, _reference[i] });
+    }
+    std::sort(lines.begin() + begin, lines.end(), [](const ledger::CashLine &a, const ledger::CashLine &b) {
+        return a.date != b.date ? a.date < b.date : a.id < b.id;
+    });
+}
+
+std::vector<ledger::ForeignBalance> PeriodArchive::foreignBalances(int date) const
+{
+    std::map<std::pair<long long, Currency>, std::pair<long long, long long>> totals;
+    for (std::size_t i = 0; i < _line_id.size(); ++i)
+    {
+        const Currency currency = _currencies[_line_currency[i]];
+        if (currency == USD || _line_date[i] > date)
+            continue;
+        std::pair<long long, long long> &total = totals[std::make_pair(_accounts[_line_account[i]], currency)];
+        total.first += _currency_amount[i];
+        total.second += _amount[i];
+    }
+
+    std::vector<ledger::ForeignBalance> balances;
+    balances.reserve(totals.size());
+    for (const auto &total : totals)
+    {
+        balances.push_back(ledger::ForeignBalance{ total.first.first, total.first.second, total.second.first / 100.0,
+                                                   total.second.second / 100.0 });
+    }
+    return balances;
+}
+
+void PeriodArchive::addPaychecks(std::vector<payroll::Paycheck> &history, int year) const
+{
+    for (const ArchivedPaycheck &paycheck : _paychecks)
+    {
+        if (paycheck.check.year == year)
+            history.push_back(paycheck.check);
+    }
+}
+
+}
@@ -0,0 +1,172 @@
+//! \file BalanceNotifier.cpp
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/ledger/BalanceNotifier.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace accounting {
+namespace ledger {
+
+BalanceNotifier::BalanceNotifier(Loader loader, std::chrono::milliseconds window)
+    : _loader(std::move(loader)),
+      _window(window),
+      _stop(false),
+      _next_id(1)
+{
+    _thread = std::thread(&BalanceNotifier::run, this);
+}
+
+BalanceNotifier::~BalanceNotifier()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+std::size_t BalanceNotifier::subscribe(long long company, const std::vector<long long> &accounts, Listener listener)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const std::size_t id = _next_id++;
+    _subscriptions[id] = Subscription{ company, accounts, std::move(listener) };
+    for (long long account : accounts)
+        _watchers[AccountKey{ company, account }].push_back(id);
+
+    return id;
+}
+
+void BalanceNotifier::unsubscribe(std::size_t subscription)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto found = _subscriptions.find(subscription);
+    if (found == _subscriptions.end())
+        return;
+
+    for (long long account : found->second.accounts)
+    {
+        const AccountKey key{ found->second.company, account };
+        std::vector<std::size_t> &watchers = _watchers[key];
+        watchers.erase(std::remove(watchers.begin(), watchers.end(), subscription), watchers.end());
+        if (watchers.empty())
+            _watchers.erase(key);
+    }
+    _subscriptions.erase(found);
+}
+
+void BalanceNotifier::changed(long long company, const std::vector<long long> &accounts)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (long long account : accounts)
+            _dirty.insert(AccountKey{ company, account });
+    }
+    _wake.notify_one();
+}
+
+void BalanceNotifier::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (;;)
+    {
+        _wake.wait(lock, [this] { return _stop || !_dirty.empty(); });
+        if (_stop)
+            break;
+
+        // Let the changes pile up for a moment before reading.
+        _wake.wait_for(lock, _window, [this] { return _stop; });
+        if (_stop)
+            break;
+
+        std::unordered_set<AccountKey, AccountKeyHash> dirty;
+        dirty.swap(_dirty);
+
+        std::map<long long, std::vector<long long>> watched;
+        for (const AccountKey &key : dirty)
+            if (_watchers.count(key))
+                watched[key.company].push_back(key.account);
+
+        if (watched.empty())
+            continue;
+
+        lock.unlock();
+        std::map<long long, Balances> balances;
+        std::vector<AccountKey> failed;
+        for (auto &company : watched)
+        {
+            try
+            {
+                balances[company.first] = _loader(company.first, company.second);
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "Can't read balances of company " << company.first << ": " << e.what() << std::endl;
+                for (long long account : company.second)
+                    failed.push_back(AccountKey{ company.first, account });
+            }
+        }
+        lock.lock();
+
+        // Read them again after the next window.
+        _dirty.insert(failed.begin(), failed.end());
+
+        // Hand each subscriber the accounts it asked for.
+        std::unordered_map<std::size_t, Balances> deliveries;
+        for (auto &company : balances)
+        {
+            for (auto &balance : company.second)
+            {
+                auto watchers = _watchers.find(AccountKey{ company.first, balance.first });
+                if (watchers == _watchers.end())
+                    continue;
+
+                for (std::size_t id : watchers->second)
+                    deliveries[id][balance.first] = balance.second;
+            }
+        }
+
+        std::vector<std::pair<Listener, Balances>> calls;
+        for (auto &delivery : deliveries)
+        {
+            auto subscription = _subscriptions.find(delivery.first);
+            if (subscription != _subscriptions.end())
+                calls.emplace_back(subscription->second.listener, std::move(delivery.second));
+        }
+
+        lock.unlock();
+        for (auto &call : calls)
+        {
+            try
+            {
+                call.first(call.second);
+            }
+            catch (std::exception &e)
+            {
+                std::cerr << "Balance listener failed: " << e.what() << std::endl;
+            }
+        }
+        lock.lock();
+    }
+}
+
+}
+}
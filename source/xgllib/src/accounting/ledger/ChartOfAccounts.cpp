@@ -0,0 +1,121 @@
+//! \file ChartOfAccounts.cpp
+//! \brief Chart of accounts hierarchy
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/ledger/ChartOfAccounts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace accounting {
+namespace ledger {
+
+ChartOfAccounts::ChartOfAccounts(const std::vector<Account> &accounts)
+{
+    std::unordered_map<long long, std::size_t> index;
+    index.reserve(accounts.size());
+    for (std::size_t i = 0; i < accounts.size(); ++i)
+    {
+        if (accounts[i].id == 0 || !index.emplace(accounts[i].id, i).second)
+            throw std::invalid_argument("duplicate or zero account id " + std::to_string(accounts[i].id));
+    }
+
+    // Children of each account, and the top level, by account number.
+    std::vector<std::vector<std::size_t>> children(accounts.size());
+    std::vector<std::size_t> roots;
+    for (std::size_t i = 0; i < accounts.size(); ++i)
+    {
+        if (accounts[i].parent_id == 0)
+        {
+            roots.push_back(i);
+            continue;
+        }
+        auto parent = index.find(accounts[i].parent_id);
+        if (parent == index.end())
+            throw std::invalid_argument("account " + std::to_string(accounts[i].id) + " has unknown parent " +
+                                        std::to_string(accounts[i].parent_id));
+        children[parent->second].push_back(i);
+    }
+
+    auto byNumber = [&accounts](std::size_t a, std::size_t b) {
+        return accounts[a].number != accounts[b].number ? accounts[a].number < accounts[b].number
+                                                        : accounts[a].id < accounts[b].id;
+    };
+    std::sort(roots.begin(), roots.end(), byNumber);
+    for (auto &c : children)
+        std::sort(c.begin(), c.end(), byNumber);
+
+    _accounts.reserve(accounts.size());
+    _depth.reserve(accounts.size());
+    _end.resize(accounts.size());
+    _position.reserve(accounts.size());
+
+    // Depth first, with an explicit stack so a deep chart can't overflow
+    // the call stack.  Each frame is an account's position and the next
+    // of its children to visit.
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    for (std::size_t root : roots)
+    {
+        auto visit = [&](std::size_t i) {
+            _position.emplace(accounts[i].id, _accounts.size());
+            _depth.push_back(static_cast<int>(stack.size()));
+            _accounts.push_back(accounts[i]);
+            stack.emplace_back(i, 0);
+        };
+
+        visit(root);
+        while (!stack.empty())
+        {
+            auto &top = stack.back();
+            const std::vector<std::size_t> &c = children[top.first];
+            if (top.second < c.size())
+                visit(c[top.second++]);
+            else
+            {
+                _end[_position[accounts[top.first].id]] = _accounts.size();
+                stack.pop_back();
+            }
+        }
+    }
+
+    // Anything not reached hangs off a cycle.
+    if (_accounts.size() != accounts.size())
+        throw std::invalid_argument("chart of accounts has a cycle");
+}
+
+bool ChartOfAccounts::contains(long long ancestor, long long id) const
+{
+    const std::size_t a = position(ancestor);
+    const std::size_t p = position(id);
+    return a <= p && p < _end[a];
+}
+
+Rollup::Rollup(const ChartOfAccounts &chart, const Balances &balances)
+    : _chart(chart),
+      _prefix(chart.size() + 1, 0)
+{
+    for (std::size_t p = 0; p < chart.size(); ++p)
+    {
+        auto found = balances.find(chart.at(p).id);
+        const long long cents = found == balances.end() ? 0 : std::llround(found->second * 100);
+        _prefix[p + 1] = _prefix[p] + cents;
+    }
+}
+
+}
+}
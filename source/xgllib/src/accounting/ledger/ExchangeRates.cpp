@@ -0,0 +1,77 @@
+//! \file ExchangeRates.cpp
+//! \brief Daily exchange rate table
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/ledger/ExchangeRates.h"
+
+namespace accounting {
+namespace ledger {
+
+void ExchangeRates::set(const Currency &currency, int date, double rate)
+{
+    if (currency == USD)
+        return;
+
+    auto found = _series.find(currency);
+    if (found == _series.end())
+    {
+        _series.emplace(currency, Series{ date, { rate }, { true } });
+        return;
+    }
+
+    Series &series = found->second;
+    if (date < series.first)
+    {
+        // Earlier than anything so far: shift the series up, and carry the
+        // new rate forward to the old first day.
+        const std::size_t gap = series.first - date;
+        series.rates.insert(series.rates.begin(), gap, rate);
+        series.published.insert(series.published.begin(), gap, false);
+        series.published[0] = true;
+        series.first = date;
+        return;
+    }
+
+    std::size_t day = date - series.first;
+    if (day >= series.rates.size())
+    {
+        series.rates.resize(day + 1, series.rates.back());
+        series.published.resize(day + 1, false);
+    }
+    series.rates[day] = rate;
+    series.published[day] = true;
+
+    // Carry it over the days after it that have no rate of their own.
+    for (++day; day < series.rates.size() && !series.published[day]; ++day)
+        series.rates[day] = rate;
+}
+
+double ExchangeRates::rate(const Currency &currency, int date) const
+{
+    if (currency == USD)
+        return 1;
+
+    auto found = _series.find(currency);
+    if (found == _series.end() || date < found->second.first)
+        throw std::out_of_range("no " + currency.code() + " rate on day " + std::to_string(date));
+
+    const Series &series = found->second;
+    const std::size_t day = date - series.first;
+    return day < series.rates.size() ? series.rates[day] : series.rates.back();
+}
+
+}
+}
@@ -0,0 +1,525 @@
+//! \file Reconciliation.cpp
+//! \brief Bank statement reconciliation
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/ledger/Reconciliation.h"
+#include "accounting/Date.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace accounting {
+namespace ledger {
+
+namespace
+{
+    //! Don't bother spinning up a thread for less than this many lines.
+    const std::size_t MIN_LINES_PER_THREAD = 4096;
+
+    //! A line as the passes see it, in whole cents so amounts hash and sum
+    //! exactly.
+    struct Item {
+        long long cents;
+        int date;
+        const std::string *reference;
+        bool matched;
+    };
+
+    //! Statement and ledger line indexes of a one to one match.
+    using Pair = std::pair<std::size_t, std::size_t>;
+
+    //! A line and the lines on the other side that sum to it.
+    struct Split {
+        std::size_t target;
+        std::vector<std::size_t> parts;
+    };
+
+    std::vector<Item> items(const std::vector<CashLine> &lines)
+    {
+        std::vector<Item> result;
+        result.reserve(lines.size());
+        for (const CashLine &line : lines)
+            result.push_back(Item{ std::llround(line.amount * 100), line.date, &line.reference, false });
+        return result;
+    }
+
+    inline std::size_t combine(std::size_t seed, std::size_t value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    struct AmountDateKey {
+        long long cents;
+        int date;
+
+        bool operator==(const AmountDateKey &other) const
+        {
+            return cents == other.cents && date == other.date;
+        }
+    };
+
+    struct AmountDateHash {
+        std::size_t operator()(const AmountDateKey &key) const
+        {
+            return combine(std::hash<long long>()(key.cents), std::hash<int>()(key.date));
+        }
+    };
+
+    struct ExactKey {
+        long long cents;
+        int date;
+        const std::string *reference;
+
+        bool operator==(const ExactKey &other) const
+        {
+            return cents == other.cents && date == other.date && *reference == *other.reference;
+        }
+    };
+
+    struct ExactHash {
+        std::size_t operator()(const ExactKey &key) const
+        {
+            return combine(combine(std::hash<long long>()(key.cents), std::hash<int>()(key.date)),
+                           std::hash<std::string>()(*key.reference));
+        }
+    };
+
+    bool exactKey(const Item &item, ExactKey &key)
+    {
+        key = ExactKey{ item.cents, item.date, item.reference };
+        return !item.reference->empty();
+    }
+
+    bool amountDateKey(const Item &item, AmountDateKey &key)
+    {
+        key = AmountDateKey{ item.cents, item.date };
+        return true;
+    }
+
+    //! Unmatched ledger lines sharing a key, in ledger order.  Lines before
+    //! next have been taken.
+    struct Bucket {
+        std::vector<std::size_t> lines;
+        std::size_t next = 0;
+    };
+
+    //! Match each statement line to the first unmatched ledger line with
+    //! the same key: one hash probe per line.
+    template<class Key, class Hash>
+    void hashPass(std::vector<Item> &statement, std::vector<Item> &ledger,
+                  bool (*key)(const Item &, Key &), std::vector<Pair> &pairs)
+    {
+        std::unordered_map<Key, Bucket, Hash> index;
+        index.reserve(ledger.size());
+
+        Key k;
+        for (std::size_t l = 0; l < ledger.size(); ++l)
+        {
+            if (!ledger[l].matched && key(ledger[l], k))
+                index[k].lines.push_back(l);
+        }
+
+        for (std::size_t s = 0; s < statement.size(); ++s)
+        {
+            if (statement[s].matched || !key(statement[s], k))
+                continue;
+            auto found = index.find(k);
+            if (found == index.end() || found->second.next == found->second.lines.size())
+                continue;
+
+            const std::size_t l = found->second.lines[found->second.next++];
+            statement[s].matched = true;
+            ledger[l].matched = true;
+            pairs.emplace_back(s, l);
+        }
+    }
+
+    //! Unmatched ledger lines of one amount, by date.
+    using AmountGroups = std::unordered_map<long long, std::vector<std::size_t>>;
+
+    //! Date window pass over one amount partition.
+    void windowPass(std::vector<Item> &statement, std::vector<Item> &ledger,
+                    const std::vector<std::size_t> &lines, AmountGroups &groups,
+                    int tolerance, std::vector<Pair> &pairs)
+    {
+        for (auto &group : groups)
+        {
+            std::stable_sort(group.second.begin(), group.second.end(),
+                             [&ledger](std::size_t a, std::size_t b) { return ledger[a].date < ledger[b].date; });
+        }
+
+        for (std::size_t s : lines)
+        {
+            Item &line = statement[s];
+            auto found = groups.find(line.cents);
+            if (found == groups.end())
+                continue;
+            const std::vector<std::size_t> &group = found->second;
+
+            auto first = std::lower_bound(group.begin(), group.end(), line.date - tolerance,
+                                          [&ledger](std::size_t l, int date) { return ledger[l].date < date; });
+
+            // Nearest date wins; on a tie the earlier one.
+            std::size_t best = ledger.size();
+            int bestDistance = tolerance + 1;
+            for (auto i = first; i != group.end() && ledger[*i].date <= line.date + tolerance; ++i)
+            {
+                const int distance = std::abs(ledger[*i].date - line.date);
+                if (!ledger[*i].matched && distance < bestDistance)
+                {
+                    best = *i;
+                    bestDistance = distance;
+                }
+            }
+
+            if (best != ledger.size())
+            {
+                line.matched = true;
+                ledger[best].matched = true;
+                pairs.emplace_back(s, best);
+            }
+        }
+    }
+
+    //! Look for \p count candidates, from \p start on, summing to \p remaining.
+    //! The last part is a hash lookup, so the search is O(candidates^(count-1)).
+    bool findParts(const std::vector<std::size_t> &candidates, const std::vector<Item> &parts,
+                   const std::unordered_map<long long, std::vector<std::size_t>> &positions,
+                   std::size_t start, long long remaining, unsigned count, std::vector<std::size_t> &chosen)
+    {
+        if (count == 1)
+        {
+            auto found = positions.find(remaining);
+            if (found == positions.end())
+                return false;
+            for (std::size_t position : found->second)
+            {
+                if (position >= start)
+                {
+                    chosen.push_back(candidates[position]);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        for (std::size_t position = start; position + count <= candidates.size(); ++position)
+        {
+            chosen.push_back(candidates[position]);
+            if (findParts(candidates, parts, positions, position + 1,
+                          remaining - parts[candidates[position]].cents, count - 1, chosen))
+                return true;
+            chosen.pop_back();
+        }
+        return false;
+    }
+
+    //! Propose splits for targets[lines[first, last)], against the parts
+    //! unmatched at the start of the pass.  Read only, so workers can share
+    //! the inputs.
+    void proposeSplits(const std::vector<Item> &targets, const std::vector<std::size_t> &lines,
+                       std::size_t first, std::size_t last,
+                       const std::vector<Item> &parts, const std::vector<std::size_t> &byDate,
+                       const ReconciliationOptions &options, std::vector<Split> &splits)
+    {
+        std::vector<std::size_t> candidates;
+        std::unordered_map<long long, std::vector<std::size_t>> positions;
+        std::vector<std::size_t> chosen;
+
+        for (std::size_t i = first; i < last; ++i)
+        {
+            const Item &target = targets[lines[i]];
+            const long long magnitude = std::llabs(target.cents);
+            if (magnitude == 0)
+                continue;
+
+            // Walk out from the target's date, nearest first, collecting
+            // smaller amounts of the same sign.
+            candidates.clear();
+            std::size_t right = std::lower_bound(byDate.begin(), byDate.end(), target.date,
+                                                 [&parts](std::size_t p, int date) { return parts[p].date < date; }) -
+                                byDate.begin();
+            std::size_t left = right;
+            while (candidates.size() < options.max_split_candidates)
+            {
+                const bool hasLeft = left > 0 && target.date - parts[byDate[left - 1]].date <= options.date_tolerance;
+                const bool hasRight = right < byDate.size() && parts[byDate[right]].date - target.date <= options.date_tolerance;
+                if (!hasLeft && !hasRight)
+                    break;
+
+                std::size_t p;
+                if (hasLeft && (!hasRight || target.date - parts[byDate[left - 1]].date <= parts[byDate[right]].date - target.date))
+                    p = byDate[--left];
+                else
+                    p = byDate[right++];
+
+                const Item &part = parts[p];
+                if (part.cents != 0 && (part.cents < 0) == (target.cents < 0) && std::llabs(part.cents) < magnitude)
+                    candidates.push_back(p);
+            }
+            if (candidates.size() < 2)
+                continue;
+
+            positions.clear();
+            for (std::size_t position = 0; position < candidates.size(); ++position)
+                positions[parts[candidates[position]].cents].push_back(position);
+
+            // Fewest parts first.
+            for (unsigned count = 2; count <= options.max_split_parts; ++count)
+            {
+                chosen.clear();
+                if (findParts(candidates, parts, positions, 0, target.cents, count, chosen))
+                {
+                    std::sort(chosen.begin(), chosen.end());
+                    splits.push_back(Split{ lines[i], chosen });
+                    break;
+                }
+            }
+        }
+    }
+
+    //! Split pass, one direction: each unmatched target against several
+    //! unmatched parts.  Proposals are found in parallel, then accepted in
+    //! target order while none of their parts has been taken.
+    std::vector<Split> splitPass(std::vector<Item> &targets, std::vector<Item> &parts,
+                                 const ReconciliationOptions &options, std::size_t workers)
+    {
+        std::vector<std::size_t> lines;
+        for (std::size_t t = 0; t < targets.size(); ++t)
+        {
+            if (!targets[t].matched)
+                lines.push_back(t);
+        }
+
+        std::vector<std::size_t> byDate;
+        for (std::size_t p = 0; p < parts.size(); ++p)
+        {
+            if (!parts[p].matched)
+                byDate.push_back(p);
+        }
+        std::stable_sort(byDate.begin(), byDate.end(),
+                         [&parts](std::size_t a, std::size_t b) { return parts[a].date < parts[b].date; });
+
+        std::vector<Split> accepted;
+        if (lines.empty() || byDate.size() < 2 || options.max_split_parts < 2)
+            return accepted;
+
+        workers = std::max<std::size_t>(1, std::min(workers, lines.size()));
+        const std::size_t chunk = (lines.size() + workers - 1) / workers;
+        std::vector<std::vector<Split>> proposals(workers);
+        {
+            std::vector<std::thread> pool;
+            for (std::size_t w = 1; w < workers; ++w)
+            {
+                const std::size_t first = std::min(lines.size(), w * chunk);
+                const std::size_t last = std::min(lines.size(), first + chunk);
+                pool.emplace_back(proposeSplits, std::cref(targets), std::cref(lines), first, last,
+                                  std::cref(parts), std::cref(byDate), std::cref(options), std::ref(proposals[w]));
+            }
+            proposeSplits(targets, lines, 0, std::min(lines.size(), chunk), parts, byDate, options, proposals[0]);
+            for (auto &t : pool)
+                t.join();
+        }
+
+        // The chunks are contiguous, so this is target order.
+        for (const std::vector<Split> &worker : proposals)
+        {
+            for (const Split &split : worker)
+            {
+                bool free = true;
+                for (std::size_t p : split.parts)
+                    free = free && !parts[p].matched;
+                if (!free)
+                    continue;
+
+                for (std::size_t p : split.parts)
+                    parts[p].matched = true;
+                targets[split.target].matched = true;
+                accepted.push_back(split);
+            }
+        }
+        return accepted;
+    }
+
+    ReconciliationMatch match(ReconciliationMatch::eMATCH_KIND kind, const Pair &pair,
+                              const std::vector<CashLine> &statement, const std::vector<CashLine> &ledger)
+    {
+        return ReconciliationMatch{ kind, { statement[pair.first].id }, { ledger[pair.second].id } };
+    }
+}
+
+Reconciliation::Reconciliation(const ReconciliationOptions &options)
+    : _options(options)
+{
+}
+
+void Reconciliation::reconcile(const std::vector<CashLine> &statement, const std::vector<CashLine> &ledger,
+                               unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const std::size_t useful = std::max<std::size_t>(1, (statement.size() + ledger.size()) / MIN_LINES_PER_THREAD);
+    const std::size_t workers = std::min<std::size_t>(threads, useful);
+
+    std::vector<Item> bank = items(statement);
+    std::vector<Item> books = items(ledger);
+
+    // Passes 1 and 2: hash index probes.
+    std::vector<Pair> exact;
+    hashPass<ExactKey, ExactHash>(bank, books, exactKey, exact);
+
+    std::vector<Pair> amountDate;
+    hashPass<AmountDateKey, AmountDateHash>(bank, books, amountDateKey, amountDate);
+
+    // Pass 3: date window, partitioned by amount.
+    std::vector<std::vector<std::size_t>> lines(workers);
+    std::vector<AmountGroups> groups(workers);
+    std::hash<long long> partition;
+    for (std::size_t l = 0; l < books.size(); ++l)
+    {
+        if (!books[l].matched)
+            groups[partition(books[l].cents) % workers][books[l].cents].push_back(l);
+    }
+    for (std::size_t s = 0; s < bank.size(); ++s)
+    {
+        if (!bank[s].matched)
+            lines[partition(bank[s].cents) % workers].push_back(s);
+    }
+
+    std::vector<std::vector<Pair>> window(workers);
+    {
+        std::vector<std::thread> pool;
+        for (std::size_t w = 1; w < workers; ++w)
+            pool.emplace_back(windowPass, std::ref(bank), std::ref(books), std::cref(lines[w]), std::ref(groups[w]),
+                              _options.date_tolerance, std::ref(window[w]));
+        windowPass(bank, books, lines[0], groups[0], _options.date_tolerance, window[0]);
+        for (auto &t : pool)
+            t.join();
+    }
+    for (std::size_t w = 1; w < workers; ++w)
+        window[0].insert(window[0].end(), window[w].begin(), window[w].end());
+    std::sort(window[0].begin(), window[0].end());
+
+    // Pass 4: splits, a statement line against several ledger lines and
+    // then a ledger line against several statement lines.
+    std::vector<Split> bankSplits = splitPass(bank, books, _options, workers);
+    std::vector<Split> bookSplits = splitPass(books, bank, _options, workers);
+
+    _matches.clear();
+    for (const Pair &pair : exact)
+        _matches.push_back(match(ReconciliationMatch::eMatchExact, pair, statement, ledger));
+    for (const Pair &pair : amountDate)
+        _matches.push_back(match(ReconciliationMatch::eMatchAmountDate, pair, statement, ledger));
+    for (const Pair &pair : window[0])
+        _matches.push_back(match(ReconciliationMatch::eMatchDateWindow, pair, statement, ledger));
+
+    std::vector<std::pair<std::size_t, ReconciliationMatch>> splits;
+    for (const Split &split : bankSplits)
+    {
+        ReconciliationMatch m{ ReconciliationMatch::eMatchSplit, { statement[split.target].id }, {} };
+        for (std::size_t p : split.parts)
+            m.ledger.push_back(ledger[p].id);
+        splits.emplace_back(split.target, m);
+    }
+    for (const Split &split : bookSplits)
+    {
+        ReconciliationMatch m{ ReconciliationMatch::eMatchSplit, {}, { ledger[split.target].id } };
+        for (std::size_t p : split.parts)
+            m.statement.push_back(statement[p].id);
+        splits.emplace_back(split.parts.front(), m);
+    }
+    std::stable_sort(splits.begin(), splits.end(),
+                     [](const std::pair<std::size_t, ReconciliationMatch> &a,
+                        const std::pair<std::size_t, ReconciliationMatch> &b) { return a.first < b.first; });
+    for (auto &split : splits)
+        _matches.push_back(std::move(split.second));
+
+    _unmatched_statement.clear();
+    for (std::size_t s = 0; s < bank.size(); ++s)
+    {
+        if (!bank[s].matched)
+            _unmatched_statement.push_back(statement[s].id);
+    }
+    _unmatched_ledger.clear();
+    for (std::size_t l = 0; l < books.size(); ++l)
+    {
+        if (!books[l].matched)
+            _unmatched_ledger.push_back(ledger[l].id);
+    }
+}
+
+std::size_t Reconciliation::count(ReconciliationMatch::eMATCH_KIND kind) const
+{
+    return std::count_if(_matches.begin(), _matches.end(),
+                         [kind](const ReconciliationMatch &m) { return m.kind == kind; });
+}
+
+std::vector<CashLine> readStatement(std::istream &in)
+{
+    std::vector<CashLine> statement;
+    std::string text;
+    for (long long number = 1; std::getline(in, text); ++number)
+    {
+        if (!text.empty() && text.back() == '\r')
+            text.pop_back();
+        if (text.find_first_not_of(" \t") == std::string::npos)
+            continue;
+
+        int year, month, day;
+        char *end = nullptr;
+        const std::string::size_type comma = text.find(',');
+        CashLine line;
+        line.id = number;
+
+        if (comma == std::string::npos || sscanf(text.c_str(), "%d-%d-%d", &year, &month, &day) != 3 ||
+            month < 1 || month > 12 || day < 1 || day > 31)
+        {
+            if (number == 1)
+                continue;
+            throw std::invalid_argument("statement line " + std::to_string(number) + ": expected yyyy-mm-dd,amount,reference");
+        }
+        line.date = toDays(year, month, day);
+
+        line.amount = std::strtod(text.c_str() + comma + 1, &end);
+        while (*end == ' ')
+            ++end;
+        if (end == text.c_str() + comma + 1 || (*end != ',' && *end != '\0'))
+            throw std::invalid_argument("statement line " + std::to_string(number) + ": bad amount");
+
+        if (*end == ',')
+        {
+            line.reference = end + 1;
+            const std::string::size_type first = line.reference.find_first_not_of(' ');
+            const std::string::size_type last = line.reference.find_last_not_of(' ');
+            line.reference = first == std::string::npos ? std::string() : line.reference.substr(first, last - first + 1);
+            if (line.reference.size() >= 2 && line.reference.front() == '"' && line.reference.back() == '"')
+                line.reference = line.reference.substr(1, line.reference.size() - 2);
+        }
+
+        statement.push_back(line);
+    }
+    return statement;
+}
+
+}
+}
@@ -0,0 +1,101 @@
+//! \file Revaluation.cpp
+//! \brief Period end foreign currency revaluation
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/ledger/Revaluation.h"
+#include "accounting/Date.h"
+
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+
+namespace accounting {
+namespace ledger {
+
+Revaluation::Revaluation(long long gain_loss_account)
+    : _gain_loss_account(gain_loss_account),
+      _gain(0)
+{
+}
+
+void Revaluation::reserve(std::size_t balances)
+{
+    _account.reserve(balances);
+    _currency.reserve(balances);
+    _currency_balance.reserve(balances);
+    _book_balance.reserve(balances);
+}
+
+void Revaluation::add(const ForeignBalance &balance)
+{
+    _account.push_back(balance.account_id);
+    _currency.push_back(balance.currency);
+    _currency_balance.push_back(balance.currency_balance);
+    _book_balance.push_back(balance.book_balance);
+}
+
+JournalEntry Revaluation::revalue(const ExchangeRates &rates, int date)
+{
+    const std::size_t n = size();
+
+    // A few currencies across many balances: look each up once.
+    std::unordered_map<Currency, double> byCurrency;
+    _rate.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto found = byCurrency.find(_currency[i]);
+        if (found == byCurrency.end())
+            found = byCurrency.emplace(_currency[i], rates.rate(_currency[i], date)).first;
+        _rate[i] = found->second;
+    }
+
+    _adjustment.resize(n);
+    const double *balance = _currency_balance.data();
+    const double *book = _book_balance.data();
+    const double *rate = _rate.data();
+    double *adjustment = _adjustment.data();
+    for (std::size_t i = 0; i < n; ++i)
+        adjustment[i] = std::nearbyint((balance[i] * rate[i] - book[i]) * 100) / 100;
+
+    int year, month, day;
+    fromDays(date, year, month, day);
+    char memo[64];
+    snprintf(memo, sizeof(memo), "Unrealized exchange gain/loss %04d-%02d-%02d", year, month, day);
+
+    JournalEntry entry;
+    entry.date = date;
+    entry.memo = memo;
+
+    // The foreign amount of each account is unchanged; only its USD value
+    // moves.
+    double total = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (adjustment[i] == 0)
+            continue;
+        entry.lines.push_back(JournalLine{ _account[i], adjustment[i], "FX revaluation", _currency[i], 0 });
+        total += adjustment[i];
+    }
+
+    _gain = std::nearbyint(total * 100) / 100;
+    if (!entry.lines.empty())
+        entry.lines.push_back(JournalLine{ _gain_loss_account, -_gain, "FX revaluation" });
+
+    return entry;
+}
+
+}
+}
@@ -0,0 +1,296 @@
+//! \file AchWriter.cpp
+//! \brief NACHA ACH direct deposit file writer
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/payroll/AchWriter.h"
+#include "accounting/Date.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace accounting {
+namespace payroll {
+
+namespace
+{
+    //! Characters in a record, and on a line with its newline.
+    const std::size_t RECORD_SIZE = 94;
+    const std::size_t LINE_SIZE = RECORD_SIZE + 1;
+
+    //! Records per block; the file is padded to a whole block.
+    const std::size_t BLOCKING_FACTOR = 10;
+
+    //! Records buffered before a write to the stream.
+    const std::size_t BUFFERED_RECORDS = 1024;
+
+    //! PPD credits only.
+    const char SERVICE_CLASS[] = "220";
+
+    //! Hashes are kept to their low ten digits.
+    const unsigned long long HASH_MODULUS = 10000000000ull;
+
+    //! Largest amount the entry's ten digit field holds, in cents.
+    const long long MAX_ENTRY_CENTS = 9999999999ll;
+
+    //! Write \p value right justified and zero filled; high digits that
+    //! don't fit are dropped.
+    inline char *digits(char *p, unsigned long long value, std::size_t width)
+    {
+        for (std::size_t i = width; i-- > 0; value /= 10)
+            p[i] = static_cast<char>('0' + value % 10);
+        return p + width;
+    }
+
+    //! Write \p text left justified and space filled, truncated to fit.
+    inline char *text(char *p, const char *text, std::size_t length, std::size_t width)
+    {
+        length = std::min(length, width);
+        std::memcpy(p, text, length);
+        std::memset(p + length, ' ', width - length);
+        return p + width;
+    }
+
+    inline char *text(char *p, const std::string &s, std::size_t width)
+    {
+        return text(p, s.data(), s.size(), width);
+    }
+
+    inline char *blank(char *p, std::size_t width)
+    {
+        std::memset(p, ' ', width);
+        return p + width;
+    }
+
+    //! Write a day number as YYMMDD.
+    inline char *date(char *p, int days)
+    {
+        int year, month, day;
+        fromDays(days, year, month, day);
+        p = digits(p, year % 100, 2);
+        p = digits(p, month, 2);
+        return digits(p, day, 2);
+    }
+}
+
+DirectDeposit DirectDeposit::make(std::uint32_t routing, const std::string &account, const std::string &name,
+                                  eACCOUNT_TYPE type)
+{
+    DirectDeposit deposit;
+    deposit.routing = routing;
+    text(deposit.account, account, sizeof(deposit.account));
+    text(deposit.name, name, sizeof(deposit.name));
+    deposit.type = type;
+    return deposit;
+}
+
+bool DirectDeposit::validRouting(std::uint32_t routing)
+{
+    if (routing == 0 || routing > 999999999)
+        return false;
+
+    // ABA check: weights 3, 7, 1 repeating over the nine digits.
+    static const int WEIGHTS[9] = { 3, 7, 1, 3, 7, 1, 3, 7, 1 };
+    int sum = 0;
+    for (int i = 8; i >= 0; --i, routing /= 10)
+        sum += WEIGHTS[i] * (routing % 10);
+    return sum % 10 == 0;
+}
+
+AchWriter::AchWriter(std::ostream &out, const AchOrigin &origin, int created, int minutes, char modifier)
+    : _out(out),
+      _origin(origin),
+      _buffer(BUFFERED_RECORDS * LINE_SIZE),
+      _used(0),
+      _records(0),
+      _in_batch(false),
+      _batch_number(0),
+      _batch_entries(0),
+      _batch_hash(0),
+      _batch_credit(0),
+      _file_batches(0),
+      _file_entries(0),
+      _file_hash(0),
+      _file_credit(0)
+{
+    if (!DirectDeposit::validRouting(origin.destination_routing) || !DirectDeposit::validRouting(origin.odfi_routing))
+        throw std::invalid_argument("bad destination or originating bank routing number");
+
+    // File header
+    char *p = record();
+    *p++ = '1';
+    p = text(p, "01", 2, 2);
+    *p++ = ' ';
+    p = digits(p, origin.destination_routing, 9);
+    p = text(p, origin.origin_id, 10);
+    p = date(p, created);
+    p = digits(p, minutes / 60 % 24, 2);
+    p = digits(p, minutes % 60, 2);
+    *p++ = modifier;
+    p = text(p, "094", 3, 3);
+    p = digits(p, BLOCKING_FACTOR, 2);
+    *p++ = '1';
+    p = text(p, origin.destination_name, 23);
+    p = text(p, origin.origin_name, 23);
+    blank(p, 8);
+}
+
+char *AchWriter::record()
+{
+    if (_used == _buffer.size())
+        flush();
+
+    char *line = _buffer.data() + _used;
+    line[RECORD_SIZE] = '\n';
+    _used += LINE_SIZE;
+    ++_records;
+    return line;
+}
+
+void AchWriter::flush()
+{
+    _out.write(_buffer.data(), _used);
+    _used = 0;
+}
+
+void AchWriter::beginBatch(int effective, const std::string &description)
+{
+    if (_in_batch)
+        throw std::logic_error("ACH batch already open");
+
+    _in_batch = true;
+    ++_batch_number;
+    _batch_entries = 0;
+    _batch_hash = 0;
+    _batch_credit = 0;
+
+    char *p = record();
+    *p++ = '5';
+    p = text(p, SERVICE_CLASS, 3, 3);
+    p = text(p, _origin.company_name, 16);
+    p = blank(p, 20);
+    p = text(p, _origin.company_id, 10);
+    p = text(p, "PPD", 3, 3);
+    p = text(p, description, 10);
+    p = blank(p, 6);
+    p = date(p, effective);
+    p = blank(p, 3);
+    *p++ = '1';
+    p = digits(p, _origin.odfi_routing / 10, 8);
+    digits(p, _batch_number, 7);
+}
+
+void AchWriter::credit(long long id, long long cents, const DirectDeposit &account)
+{
+    if (!_in_batch)
+        throw std::logic_error("ACH entry outside a batch");
+    if (!DirectDeposit::validRouting(account.routing))
+        throw std::invalid_argument("bad routing number for " + std::to_string(id));
+    if (cents <= 0 || cents > MAX_ENTRY_CENTS)
+        throw std::invalid_argument("bad deposit amount for " + std::to_string(id));
+
+    const std::uint32_t dfi = account.routing / 10;
+
+    ++_batch_entries;
+    ++_file_entries;
+    _batch_hash += dfi;
+    _batch_credit += cents;
+
+    char *p = record();
+    *p++ = '6';
+    p = text(p, account.type == DirectDeposit::eAccountSavings ? "32" : "22", 2, 2);
+    p = digits(p, dfi, 8);
+    p = digits(p, account.routing % 10, 1);
+    p = text(p, account.account, sizeof(account.account), 17);
+    p = digits(p, cents, 10);
+    p = digits(p, id, 15);
+    p = text(p, account.name, sizeof(account.name), 22);
+    p = blank(p, 2);
+    *p++ = '0';
+    p = digits(p, _origin.odfi_routing / 10, 8);
+    digits(p, _file_entries, 7);
+}
+
+std::size_t AchWriter::deposit(const std::pmr::vector<Paycheck> &paychecks, const std::vector<DirectDeposit> &accounts)
+{
+    if (accounts.size() != paychecks.size())
+        throw std::invalid_argument("deposit accounts don't match the paychecks");
+
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < paychecks.size(); ++i)
+    {
+        if (accounts[i].routing == 0)
+            continue;
+        const long long cents = std::llround(paychecks[i].net_pay() * 100);
+        if (cents <= 0)
+            continue;
+        credit(paychecks[i].employee_id, cents, accounts[i]);
+        ++written;
+    }
+    return written;
+}
+
+void AchWriter::endBatch()
+{
+    if (!_in_batch)
+        throw std::logic_error("no ACH batch open");
+    _in_batch = false;
+
+    ++_file_batches;
+    _file_hash += _batch_hash;
+    _file_credit += _batch_credit;
+
+    char *p = record();
+    *p++ = '8';
+    p = text(p, SERVICE_CLASS, 3, 3);
+    p = digits(p, _batch_entries, 6);
+    p = digits(p, _batch_hash % HASH_MODULUS, 10);
+    p = digits(p, 0, 12);
+    p = digits(p, _batch_credit, 12);
+    p = text(p, _origin.company_id, 10);
+    p = blank(p, 19 + 6);
+    p = digits(p, _origin.odfi_routing / 10, 8);
+    digits(p, _batch_number, 7);
+}
+
+void AchWriter::finish()
+{
+    if (_in_batch)
+        endBatch();
+
+    const std::size_t records = _records + 1;
+    const std::size_t blocks = (records + BLOCKING_FACTOR - 1) / BLOCKING_FACTOR;
+
+    char *p = record();
+    *p++ = '9';
+    p = digits(p, _file_batches, 6);
+    p = digits(p, blocks, 6);
+    p = digits(p, _file_entries, 8);
+    p = digits(p, _file_hash % HASH_MODULUS, 10);
+    p = digits(p, 0, 12);
+    p = digits(p, _file_credit, 12);
+    blank(p, 39);
+
+    while (_records % BLOCKING_FACTOR)
+        std::memset(record(), '9', RECORD_SIZE);
+
+    flush();
+    _out.flush();
+}
+
+}
+}
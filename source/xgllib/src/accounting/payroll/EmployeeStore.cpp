@@ -0,0 +1,60 @@
+//! \file EmployeeStore.cpp
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/payroll/EmployeeStore.h"
+
+namespace accounting {
+namespace payroll {
+
+void EmployeeStore::reserve(std::size_t employees)
+{
+    _id.reserve(employees);
+    _annual_wage.reserve(employees);
+    _pay_period.reserve(employees);
+    _ytd_oasdi_wages.reserve(employees);
+    _ytd_oasdi.reserve(employees);
+    _ytd_futa_wages.reserve(employees);
+}
+
+std::size_t EmployeeStore::add(const Employee &employee, double ytd_oasdi_wages, double ytd_oasdi,
+                               double ytd_futa_wages)
+{
+    _id.push_back(employee.id);
+    _annual_wage.push_back(employee.annual_wage);
+    _pay_period.push_back(static_cast<std::uint8_t>(employee.pay_period));
+    _ytd_oasdi_wages.push_back(ytd_oasdi_wages);
+    _ytd_oasdi.push_back(ytd_oasdi);
+    _ytd_futa_wages.push_back(ytd_futa_wages);
+    return _id.size() - 1;
+}
+
+Employee EmployeeStore::employee(std::size_t i) const
+{
+    return Employee{ _id[i], _annual_wage[i], payPeriod(i) };
+}
+
+std::size_t EmployeeStore::memoryUsage() const
+{
+    return _id.capacity() * sizeof(long long) +
+           _annual_wage.capacity() * sizeof(double) +
+           _pay_period.capacity() * sizeof(std::uint8_t) +
+           _ytd_oasdi_wages.capacity() * sizeof(double) +
+           _ytd_oasdi.capacity() * sizeof(double) +
+           _ytd_futa_wages.capacity() * sizeof(double);
+}
+
+}
+}
@@ -0,0 +1,94 @@
+//! \file PayrollRun.cpp
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/payroll/PayrollRun.h"
+
+namespace accounting {
+namespace payroll {
+
+namespace
+{
+    //! Arena space left over for the run's other intermediate data.
+    const std::size_t ARENA_SLACK = 64 * 1024;
+}
+
+PayrollRun::PayrollRun(int year, int month, int period, std::size_t employees, const PayrollTaxes &taxes,
+                       std::pmr::memory_resource *upstream)
+    : _year(year),
+      _month(month),
+      _period(period),
+      _taxes(taxes),
+      _arena(employees * sizeof(Paycheck) + ARENA_SLACK, upstream),
+      _paychecks(&_arena)
+{
+    // The only upstream allocation the run makes in the common case.
+    _paychecks.reserve(employees);
+}
+
+const Paycheck &PayrollRun::issue(long long id, double annual_wage, PayPeriod::ePAY_PERIOD pay_period,
+                                  YearToDate &ytd)
+{
+    PayPeriod period;
+    period.setPayPeriod(pay_period);
+
+    Paycheck check = Paycheck();
+    check.employee_id = id;
+    check.year = _year;
+    check.month = _month;
+    check.period = _period;
+    check.gross_wages = period.calculateGrossSalaryWages(annual_wage);
+    _taxes.calculate(check, ytd);
+
+    _paychecks.push_back(check);
+    return _paychecks.back();
+}
+
+const Paycheck &PayrollRun::pay(const Employee &employee, YearToDate &ytd)
+{
+    return issue(employee.id, employee.annual_wage, employee.pay_period, ytd);
+}
+
+void PayrollRun::pay(const Roster &roster, std::vector<YearToDate> &ytd)
+{
+    for (std::size_t i = 0; i < roster.size(); ++i)
+        pay(roster[i], ytd[i]);
+}
+
+void PayrollRun::pay(EmployeeStore &store)
+{
+    const std::vector<long long> &id = store.id();
+    const std::vector<double> &annual_wage = store.annualWage();
+    std::vector<double> &ytd_oasdi_wages = store.ytdOasdiWages();
+    std::vector<double> &ytd_oasdi = store.ytdOasdi();
+    std::vector<double> &ytd_futa_wages = store.ytdFutaWages();
+
+    for (std::size_t i = 0; i < store.size(); ++i)
+    {
+        YearToDate ytd;
+        ytd.oasdi_wages = ytd_oasdi_wages[i];
+        ytd.oasdi_employee = ytd_oasdi[i];
+        ytd.futa_wages = ytd_futa_wages[i];
+
+        issue(id[i], annual_wage[i], store.payPeriod(i), ytd);
+
+        ytd_oasdi_wages[i] = ytd.oasdi_wages;
+        ytd_oasdi[i] = ytd.oasdi_employee;
+        ytd_futa_wages[i] = ytd.futa_wages;
+    }
+}
+
+}
+}
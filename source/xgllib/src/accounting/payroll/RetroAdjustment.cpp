@@ -0,0 +1,108 @@
+//! \file RetroAdjustment.cpp
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/payroll/RetroAdjustment.h"
+
+#include <algorithm>
+
+namespace accounting {
+namespace payroll {
+
+RetroAdjustment::RetroAdjustment(const PayrollTaxes &taxes)
+    : _taxes(taxes)
+{
+}
+
+void RetroAdjustment::load(const std::vector<Paycheck> &history)
+{
+    _chains.clear();
+
+    for (const Paycheck &check : history)
+        _chains[check.employee_id].checks.push_back(check);
+
+    for (auto &entry : _chains)
+    {
+        Chain &chain = entry.second;
+        std::sort(chain.checks.begin(), chain.checks.end(),
+                  [](const Paycheck &a, const Paycheck &b) { return a.period < b.period; });
+
+        // Year to date totals as issued, before each check.
+        YearToDate ytd;
+        chain.ytd.reserve(chain.checks.size());
+        for (const Paycheck &check : chain.checks)
+        {
+            chain.ytd.push_back(ytd);
+            ytd.gross_wages += check.gross_wages;
+            ytd.oasdi_wages += check.oasdi_wages;
+            ytd.oasdi_employee += check.oasdi_employee;
+            ytd.futa_wages += check.futa_wages;
+        }
+    }
+}
+
+std::vector<PayrollDelta> RetroAdjustment::apply(const PayChange &change)
+{
+    std::vector<PayrollDelta> deltas;
+
+    auto found = _chains.find(change.employee_id);
+    if (found == _chains.end())
+        return deltas;
+
+    Chain &chain = found->second;
+    auto first = std::lower_bound(chain.checks.begin(), chain.checks.end(), change.first_period,
+                                  [](const Paycheck &check, int period) { return check.period < period; });
+
+    std::size_t i = first - chain.checks.begin();
+    if (i == chain.checks.size())
+        return deltas;
+
+    YearToDate ytd = chain.ytd[i];
+    for (; i < chain.checks.size(); ++i)
+    {
+        Paycheck &issued = chain.checks[i];
+        Paycheck check = issued;
+        check.gross_wages = change.gross_wages;
+
+        chain.ytd[i] = ytd;
+        _taxes.calculate(check, ytd);
+
+        PayrollDelta delta;
+        delta.employee_id = check.employee_id;
+        delta.period = check.period;
+        delta.gross_wages = check.gross_wages - issued.gross_wages;
+        delta.oasdi_wages = check.oasdi_wages - issued.oasdi_wages;
+        delta.oasdi_employee = check.oasdi_employee - issued.oasdi_employee;
+        delta.oasdi_employer = check.oasdi_employer - issued.oasdi_employer;
+        delta.futa_wages = check.futa_wages - issued.futa_wages;
+
+        issued = check;
+
+        if (delta.gross_wages || delta.oasdi_wages || delta.oasdi_employee ||
+            delta.oasdi_employer || delta.futa_wages)
+            deltas.push_back(delta);
+    }
+
+    return deltas;
+}
+
+const std::vector<Paycheck> *RetroAdjustment::paychecks(long long employee_id) const
+{
+    auto found = _chains.find(employee_id);
+    return found == _chains.end() ? nullptr : &found->second.checks;
+}
+
+}
+}
@@ -0,0 +1,116 @@
+//! \file Simulation.cpp
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/payroll/Simulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace accounting {
+namespace payroll {
+
+Simulation::Simulation(std::shared_ptr<const EmployeeStore> roster, const PayrollTaxes &taxes)
+    : _roster(std::move(roster)),
+      _taxes(taxes)
+{
+}
+
+void Simulation::payYear(const Employee &employee, const Scenario &scenario, ScenarioResult &result) const
+{
+    PayPeriod period;
+    period.setPayPeriod(scenario.pay_period == PayPeriod::ePayPeriodUndefined
+                            ? employee.pay_period
+                            : scenario.pay_period);
+
+    Paycheck check = Paycheck();
+    check.gross_wages = period.calculateGrossSalaryWages(employee.annual_wage);
+
+    YearToDate ytd;
+    const int periods = period.getPayPeriodsInYear();
+    for (int i = 0; i < periods; ++i)
+    {
+        _taxes.calculate(check, ytd);
+        result.oasdi_employer += check.oasdi_employer;
+    }
+
+    ++result.headcount;
+    result.gross_wages += ytd.gross_wages;
+    result.oasdi_employee += ytd.oasdi_employee;
+    result.futa_wages += ytd.futa_wages;
+}
+
+ScenarioResult Simulation::evaluate(const Scenario &scenario) const
+{
+    ScenarioResult result;
+    result.name = scenario.name;
+
+    const bool overlay = !scenario.changes.empty() || !scenario.terminations.empty();
+    const double raise = 1.0 + scenario.raise;
+
+    const EmployeeStore &roster = *_roster;
+    const std::vector<long long> &id = roster.id();
+    for (std::size_t i = 0; i < roster.size(); ++i)
+    {
+        Employee employee = roster.employee(i);
+        if (overlay)
+        {
+            if (scenario.terminations.count(id[i]))
+                continue;
+
+            auto changed = scenario.changes.find(id[i]);
+            if (changed != scenario.changes.end())
+                employee = changed->second;
+        }
+
+        employee.annual_wage *= raise;
+        payYear(employee, scenario, result);
+    }
+
+    for (const Employee &hire : scenario.hires)
+        payYear(hire, scenario, result);
+
+    result.futa_tax = result.futa_wages * _taxes.futa.tax_rate;
+    return result;
+}
+
+std::vector<ScenarioResult> Simulation::run(const std::vector<Scenario> &scenarios, unsigned threads) const
+{
+    std::vector<ScenarioResult> results(scenarios.size());
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<std::size_t>(threads, scenarios.size());
+
+    // Workers pull the next scenario off a shared counter.
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < scenarios.size(); i = next++)
+            results[i] = evaluate(scenarios[i]);
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool)
+        t.join();
+
+    return results;
+}
+
+}
+}
@@ -0,0 +1,195 @@
+//! \file TaxReport.cpp
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "accounting/payroll/TaxReport.h"
+
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+namespace accounting {
+namespace payroll {
+
+namespace
+{
+    //! Don't bother spinning up a thread for less than this many paychecks.
+    const std::size_t MIN_CHECKS_PER_THREAD = 16384;
+
+    //! Wages paid to one employee, by quarter.
+    struct EmployeeWages {
+        double wages[4] = { 0, 0, 0, 0 };
+    };
+
+    using EmployeePartition = std::unordered_map<long long, EmployeeWages>;
+
+    //! Per quarter totals that don't depend on the employee.
+    struct QuarterTotals {
+        double wages[4] = { 0, 0, 0, 0 };
+        double oasdi_wages[4] = { 0, 0, 0, 0 };
+        double oasdi_tax[4] = { 0, 0, 0, 0 };
+    };
+
+    //! Result of reducing one employee partition.
+    struct PartitionTotals {
+        std::size_t employees = 0;
+        std::size_t quarter_employees[4] = { 0, 0, 0, 0 };
+        double excess_payments = 0;
+        double taxable_wages[4] = { 0, 0, 0, 0 };
+    };
+
+    //! Worker state for the first (scan) pass.
+    struct ScanResult {
+        QuarterTotals totals;
+        std::vector<EmployeePartition> partitions;
+    };
+
+    void scan(const Paycheck *begin, const Paycheck *end, int year, ScanResult &result)
+    {
+        const std::size_t partitions = result.partitions.size();
+
+        for (const Paycheck *check = begin; check != end; ++check)
+        {
+            if (check->year != year)
+                continue;
+
+            const int q = check->quarter() - 1;
+            result.totals.wages[q] += check->gross_wages;
+            result.totals.oasdi_wages[q] += check->oasdi_wages;
+            result.totals.oasdi_tax[q] += check->oasdi_employee + check->oasdi_employer;
+
+            const std::size_t p = static_cast<unsigned long long>(check->employee_id) % partitions;
+            result.partitions[p][check->employee_id].wages[q] += check->gross_wages;
+        }
+    }
+
+    void reduce(std::vector<ScanResult> &scans, std::size_t p, double wage_cap, PartitionTotals &totals)
+    {
+        // Merge this partition from every worker into the first one.
+        EmployeePartition &merged = scans[0].partitions[p];
+        for (std::size_t i = 1; i < scans.size(); ++i)
+        {
+            for (auto &employee : scans[i].partitions[p])
+            {
+                EmployeeWages &wages = merged[employee.first];
+                for (int q = 0; q < 4; ++q)
+                    wages.wages[q] += employee.second.wages[q];
+            }
+            scans[i].partitions[p].clear();
+        }
+
+        // Apply the wage cap in quarter order for each employee.
+        for (auto &employee : merged)
+        {
+            double paid = 0;
+            ++totals.employees;
+            for (int q = 0; q < 4; ++q)
+            {
+                const double wages = employee.second.wages[q];
+                if (wages > 0)
+                    ++totals.quarter_employees[q];
+
+                const double taxable = std::max(0.0, std::min(wages, wage_cap - paid));
+                totals.taxable_wages[q] += taxable;
+                totals.excess_payments += wages - taxable;
+                paid += wages;
+            }
+        }
+    }
+}
+
+TaxReport::TaxReport(int year, const FUTA_RATE &futa)
+    : _year(year),
+      _futa(futa),
+      _form941(),
+      _form940()
+{
+}
+
+void TaxReport::generate(const std::vector<Paycheck> &history, unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const std::size_t useful = std::max<std::size_t>(1, history.size() / MIN_CHECKS_PER_THREAD);
+    const std::size_t workers = std::min<std::size_t>(threads, useful);
+
+    // Pass 1: scan contiguous chunks of the history.
+    std::vector<ScanResult> scans(workers);
+    for (auto &s : scans)
+        s.partitions.resize(workers);
+
+    const std::size_t chunk = (history.size() + workers - 1) / workers;
+    const Paycheck *data = history.data();
+    {
+        std::vector<std::thread> pool;
+        for (std::size_t w = 1; w < workers; ++w)
+        {
+            const std::size_t first = std::min(history.size(), w * chunk);
+            const std::size_t last = std::min(history.size(), first + chunk);
+            pool.emplace_back(scan, data + first, data + last, _year, std::ref(scans[w]));
+        }
+        scan(data, data + std::min(history.size(), chunk), _year, scans[0]);
+        for (auto &t : pool)
+            t.join();
+    }
+
+    // Pass 2: merge and reduce each employee partition.
+    std::vector<PartitionTotals> partitions(workers);
+    {
+        std::vector<std::thread> pool;
+        for (std::size_t p = 1; p < workers; ++p)
+            pool.emplace_back(reduce, std::ref(scans), p, _futa.wage_cap, std::ref(partitions[p]));
+        reduce(scans, 0, _futa.wage_cap, partitions[0]);
+        for (auto &t : pool)
+            t.join();
+    }
+
+    // Combine the partial results.
+    _form940 = Form940Summary();
+    for (int q = 0; q < 4; ++q)
+    {
+        Form941Summary &f = _form941[q];
+        f = Form941Summary();
+        f.quarter = q + 1;
+        for (auto &s : scans)
+        {
+            f.wages += s.totals.wages[q];
+            f.social_security_wages += s.totals.oasdi_wages[q];
+            f.social_security_tax += s.totals.oasdi_tax[q];
+        }
+
+        double taxable = 0;
+        for (auto &p : partitions)
+        {
+            f.employees += p.quarter_employees[q];
+            taxable += p.taxable_wages[q];
+        }
+
+        _form940.total_payments += f.wages;
+        _form940.taxable_futa_wages += taxable;
+        _form940.quarterly_liability[q] = taxable * _futa.tax_rate;
+    }
+
+    for (auto &p : partitions)
+    {
+        _form940.employees += p.employees;
+        _form940.excess_payments += p.excess_payments;
+    }
+    _form940.futa_tax = _form940.taxable_futa_wages * _futa.tax_rate;
+}
+
+}
+}
@@ -0,0 +1,61 @@
+//! \file Account.cpp
+//! \brief Account record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/Account.h"
+
+#include <Wt/Dbo/Impl.h>
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+DBO_INSTANTIATE_TEMPLATES(db::Account)
+
+namespace db
+{
+
+void saveAccount(dbo::Session &session, const accounting::ledger::Account &account)
+{
+  dbo::ptr<Account> record = session.find<Account>().where("account_id = ?").bind(account.id);
+  if (!record)
+  {
+    record = session.add(std::make_unique<Account>());
+    record.modify()->accountId = account.id;
+  }
+
+  Account *modified = record.modify();
+  modified->parentId = account.parent_id;
+  modified->number = account.number;
+  modified->name = account.name;
+}
+
+accounting::ledger::ChartOfAccounts loadChartOfAccounts(dbo::Session &session)
+{
+  typedef std::tuple<long long, long long, std::string, std::string> Row;
+
+  std::vector<accounting::ledger::Account> accounts;
+
+  dbo::Transaction transaction(session);
+
+  dbo::collection<Row> rows = session.query<Row>(
+      "select account_id, parent_id, number, name from account");
+
+  for (const Row &row : rows)
+    accounts.push_back(accounting::ledger::Account{ std::get<0>(row), std::get<1>(row), std::get<2>(row), std::get<3>(row) });
+
+  return accounting::ledger::ChartOfAccounts(accounts);
+}
+
+} // namespace db
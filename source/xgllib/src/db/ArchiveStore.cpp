@@ -0,0 +1,104 @@
+//! \file ArchiveStore.cpp
+//! \brief A company's closed period archives
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/ArchiveStore.h"
+
+#include <sys/stat.h>
+
+#include <filesystem>
+#include <stdexcept>
+
+namespace db
+{
+
+namespace
+{
+
+  const char EXTENSION[] = ".xgla";
+
+}
+
+ArchiveStore::ArchiveStore(const std::string &directory)
+    : directory_(directory),
+      scanned_{ 0, 0 }
+{
+  if (!directory_.empty() && directory_.back() != '/')
+    directory_ += '/';
+}
+
+std::string ArchiveStore::file(int year) const
+{
+  return directory_ + std::to_string(year) + EXTENSION;
+}
+
+void ArchiveStore::scan()
+{
+  // A stat per call; the directory is only listed when a rename into it
+  // has changed its modification time.
+  struct stat status;
+  if (::stat(directory_.c_str(), &status) != 0)
+    return;
+  if (status.st_mtim.tv_sec == scanned_.tv_sec && status.st_mtim.tv_nsec == scanned_.tv_nsec)
+    return;
+
+  for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory_))
+  {
+    if (entry.path().extension() != EXTENSION)
+      continue;
+    std::shared_ptr<const accounting::PeriodArchive> &archive = archives_[entry.path().filename().string()];
+    if (!archive)
+      archive = std::make_shared<const accounting::PeriodArchive>(entry.path().string());
+  }
+  scanned_ = status.st_mtim;
+}
+
+ArchiveStore::Closed ArchiveStore::closed()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  scan();
+
+  Closed closed;
+  closed.archives.reserve(archives_.size());
+  for (const auto &archive : archives_)
+  {
+    closed.through = archive.second->last();
+    closed.archives.push_back(archive.second);
+  }
+  return closed;
+}
+
+int ArchiveStore::closedThrough()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  scan();
+
+  return archives_.empty() ? INT_MIN : archives_.rbegin()->second->last();
+}
+
+void ArchiveStore::add(int year, const accounting::PeriodArchive &archive)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const std::string name = file(year);
+  std::filesystem::create_directories(directory_);
+  if (std::filesystem::exists(name))
+    throw std::invalid_argument(std::to_string(year) + " is already closed");
+
+  archive.write(name);
+}
+
+} // namespace db
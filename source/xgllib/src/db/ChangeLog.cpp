@@ -0,0 +1,76 @@
+//! \file ChangeLog.cpp
+//! \brief Change feed of a company's books
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/ChangeLog.h"
+
+#include <Wt/Dbo/Impl.h>
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include <string>
+#include <tuple>
+
+#include "db/LedgerSession.h"
+
+DBO_INSTANTIATE_TEMPLATES(db::Change)
+
+namespace db
+{
+
+void recordChanges(LedgerSession &session, const std::vector<accounting::Change> &changes)
+{
+  for (const accounting::Change &change : changes)
+  {
+    const std::string data = change.encode();
+    auto record = std::make_unique<Change>();
+    record->data.assign(data.begin(), data.end());
+    session.add(std::move(record));
+  }
+}
+
+ChangeCursor::ChangeCursor(LedgerSession &session, long long since)
+    : session_(session),
+      position_(since)
+{
+}
+
+std::vector<accounting::Change> ChangeCursor::next(std::size_t max)
+{
+  typedef std::tuple<long long, std::vector<unsigned char>> Row;
+
+  std::vector<accounting::Change> changes;
+
+  dbo::Transaction transaction(session_);
+
+  dbo::collection<Row> rows = session_.query<Row>(
+      "select id, data from change_log")
+      .where("id > ?").bind(position_)
+      .orderBy("id")
+      .limit(static_cast<int>(max));
+
+  for (const Row &row : rows)
+  {
+    const std::vector<unsigned char> &data = std::get<1>(row);
+    changes.push_back(accounting::Change::decode(std::get<0>(row), std::string(data.begin(), data.end())));
+  }
+
+  if (!changes.empty())
+    position_ = changes.back().sequence;
+  return changes;
+}
+
+} // namespace db
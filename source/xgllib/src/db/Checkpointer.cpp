@@ -0,0 +1,56 @@
+//! \file Checkpointer.cpp
+//! \brief Periodic ledger state checkpoints
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/Checkpointer.h"
+
+#include "db/ShardRouter.h"
+
+namespace db
+{
+
+Checkpointer::Checkpointer(ShardRouter &router, std::chrono::seconds interval)
+    : router_(router),
+      interval_(interval),
+      stop_(false)
+{
+  thread_ = std::thread(&Checkpointer::run, this);
+}
+
+Checkpointer::~Checkpointer()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    wake_.notify_one();
+  }
+  thread_.join();
+
+  router_.checkpoint();
+}
+
+void Checkpointer::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!wake_.wait_for(lock, interval_, [this] { return stop_; }))
+  {
+    lock.unlock();
+    router_.checkpoint();
+    lock.lock();
+  }
+}
+
+} // namespace db
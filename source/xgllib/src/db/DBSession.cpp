@@ -24,9 +24,12 @@
 #include "Wt/Auth/FacebookService.h"
 #include "Wt/Auth/Dbo/AuthInfo.h"
 
+#include "Wt/Dbo/FixedSqlConnectionPool.h"
+#include "Wt/Dbo/Transaction.h"
 #include "Wt/Dbo/backend/Sqlite3.h"
 
 #include "db/DBSession.h"
+#include "db/Schema.h"
 
 using namespace Wt;
 
@@ -64,33 +67,73 @@ void DBSession::configureAuth()
         myOAuthServices[i]->generateRedirectEndpoint();
 }
 
-DBSession::DBSession(const std::string &sqliteDb)
+std::unique_ptr<dbo::SqlConnectionPool> DBSession::createPool(const DatabaseConfig &config)
 {
-    auto connection = std::make_unique<Dbo::backend::Sqlite3>(sqliteDb);
+    std::unique_ptr<dbo::SqlConnectionPool> pool = openPool(config, "auth");
 
-    connection->setProperty("show-queries", "true");
+    if (migrateAuth(*pool))
+        std::cerr << "Created database." << std::endl;
 
-    setConnection(std::move(connection));
+    return pool;
+}
 
+void DBSession::mapClasses()
+{
     mapClass<User>("user");
     mapClass<AuthInfo>("auth_info");
     mapClass<AuthInfo::AuthIdentityType>("auth_identity");
     mapClass<AuthInfo::AuthTokenType>("auth_token");
+}
+
+DBSession::DBSession(dbo::SqlConnectionPool &pool)
+{
+    setConnectionPool(pool);
+    mapClasses();
+
+    users_ = std::make_unique<UserDatabase>(*this);
+}
+
+DBSession::DBSession(const std::string &sqliteDb)
+{
+    auto connection = std::make_unique<Dbo::backend::Sqlite3>(sqliteDb);
+
+    connection->setProperty("show-queries", "true");
 
-    try
-    {
-        createTables();
-        std::cerr << "Created database." << std::endl;
-    }
-    catch (std::exception &e)
     {
-        std::cerr << e.what() << std::endl;
-        std::cerr << "Using existing database";
+        dbo::FixedSqlConnectionPool pool(connection->clone(), 1);
+        if (migrateAuth(pool))
+            std::cerr << "Created database." << std::endl;
     }
 
+    setConnection(std::move(connection));
+
+    mapClasses();
+
     users_ = std::make_unique<UserDatabase>(*this);
 }
 
+UserDatabase::UserDatabase(dbo::Session &session)
+    : Wt::Auth::Dbo::UserDatabase<AuthInfo>(session),
+      session_(session)
+{
+}
+
+Auth::User UserDatabase::registerNew()
+{
+    dbo::Transaction transaction(session_);
+
+    Auth::User user = Wt::Auth::Dbo::UserDatabase<AuthInfo>::registerNew();
+
+    dbo::ptr<User> record = session_.add(std::make_unique<User>());
+    record.flush();
+    record.modify()->companyId = record.id();
+    find(user).modify()->setUser(record);
+
+    transaction.commit();
+
+    return user;
+}
+
 Auth::AbstractUserDatabase &DBSession::users()
 {
     return *users_;
@@ -0,0 +1,83 @@
+//! \file Database.cpp
+//! \brief Database backend selection and connection pools
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Wt/Dbo/FixedSqlConnectionPool.h"
+#include "Wt/Dbo/backend/Sqlite3.h"
+#ifdef XGL_WITH_POSTGRES
+#include "Wt/Dbo/backend/Postgres.h"
+#endif
+
+#include "db/Database.h"
+
+#include <stdexcept>
+
+namespace db
+{
+
+DatabaseConfig::eBACKEND DatabaseConfig::parseBackend(const std::string &name)
+{
+  if (name == "sqlite3")
+    return eSqlite3;
+  if (name == "postgres")
+    return ePostgres;
+  throw std::invalid_argument("unknown database backend '" + name + "'");
+}
+
+bool DatabaseConfig::postgresAvailable()
+{
+#ifdef XGL_WITH_POSTGRES
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::string DatabaseConfig::file(const std::string &name) const
+{
+  if (directory.empty() || directory.back() == '/')
+    return directory + name + ".db";
+  return directory + "/" + name + ".db";
+}
+
+std::string DatabaseConfig::connectionString(const std::string &name) const
+{
+  return connection + " options='-c search_path=" + name + "'";
+}
+
+std::unique_ptr<dbo::SqlConnection> openConnection(const DatabaseConfig &config, const std::string &name)
+{
+  if (config.backend == DatabaseConfig::eSqlite3)
+    return std::make_unique<dbo::backend::Sqlite3>(config.file(name));
+
+#ifdef XGL_WITH_POSTGRES
+  // The schema has to exist before anything is created in it.
+  {
+    dbo::backend::Postgres admin(config.connection);
+    admin.executeSql("create schema if not exists \"" + name + "\"");
+  }
+  return std::make_unique<dbo::backend::Postgres>(config.connectionString(name));
+#else
+  throw std::runtime_error("database-backend postgres: built without PostgreSQL (configure with -DXGL_POSTGRES=ON)");
+#endif
+}
+
+std::unique_ptr<dbo::SqlConnectionPool> openPool(const DatabaseConfig &config, const std::string &name)
+{
+  return std::make_unique<dbo::FixedSqlConnectionPool>(openConnection(config, name), config.poolSize);
+}
+
+} // namespace db
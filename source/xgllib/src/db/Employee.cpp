@@ -0,0 +1,74 @@
+//! \file Employee.cpp
+//! \brief Employee record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/Employee.h"
+
+#include <Wt/Dbo/Impl.h>
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include <tuple>
+#include <vector>
+
+#include "db/LedgerCache.h"
+#include "db/LedgerSession.h"
+
+DBO_INSTANTIATE_TEMPLATES(db::Employee)
+
+using namespace accounting::payroll;
+
+namespace db
+{
+
+EmployeeStore loadEmployeeStore(LedgerSession &session, LedgerCache &cache, int year)
+{
+  typedef std::tuple<long long, double, int> EmployeeRow;
+
+  EmployeeStore store;
+
+  dbo::Transaction transaction(session);
+
+  int count = session.query<int>("select count(1) from employee");
+  store.reserve(count);
+
+  dbo::collection<EmployeeRow> rows = session.query<EmployeeRow>(
+      "select id, annual_wage, pay_period from employee")
+      .orderBy("id");
+
+  std::vector<EmployeeRow> employees;
+  employees.reserve(count);
+  for (const EmployeeRow &row : rows)
+    employees.push_back(row);
+
+  std::vector<long long> ids;
+  ids.reserve(employees.size());
+  for (const EmployeeRow &row : employees)
+    ids.push_back(std::get<0>(row));
+  const std::vector<accounting::PayrollTotals> ytd = cache.yearToDate(session, ids, year);
+
+  for (std::size_t i = 0; i < employees.size(); ++i)
+  {
+    const EmployeeRow &row = employees[i];
+    store.add(accounting::payroll::Employee{ std::get<0>(row), std::get<1>(row),
+                  static_cast<PayPeriod::ePAY_PERIOD>(std::get<2>(row)) },
+              ytd[i].oasdi_wages, ytd[i].oasdi_employee, ytd[i].futa_wages);
+  }
+
+  return store;
+}
+
+} // namespace db
@@ -0,0 +1,76 @@
+//! \file ExchangeRate.cpp
+//! \brief Exchange rate record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/ExchangeRate.h"
+
+#include <Wt/Dbo/Impl.h>
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include "accounting/Date.h"
+
+DBO_INSTANTIATE_TEMPLATES(db::ExchangeRate)
+
+namespace db
+{
+
+void setExchangeRate(dbo::Session &session, const accounting::Currency &currency, int date, double rate)
+{
+  int year, month, day;
+  accounting::fromDays(date, year, month, day);
+  const Wt::WDate when(year, month, day);
+
+  dbo::ptr<ExchangeRate> existing = session.find<ExchangeRate>()
+      .where("currency = ?").bind(currency.code())
+      .where("date = ?").bind(when);
+  if (existing)
+  {
+    existing.modify()->rate = rate;
+    return;
+  }
+
+  auto record = std::make_unique<ExchangeRate>();
+  record->currency = currency.code();
+  record->date = when;
+  record->rate = rate;
+  session.add(std::move(record));
+}
+
+accounting::ledger::ExchangeRates loadExchangeRates(dbo::Session &session)
+{
+  typedef std::tuple<std::string, Wt::WDate, double> Row;
+
+  accounting::ledger::ExchangeRates rates;
+
+  dbo::Transaction transaction(session);
+
+  // In date order, so each set() appends to the dense array.
+  dbo::collection<Row> rows = session.query<Row>(
+      "select currency, date, rate from exchange_rate")
+      .orderBy("currency, date");
+
+  for (const Row &row : rows)
+  {
+    const Wt::WDate &date = std::get<1>(row);
+    rates.set(accounting::Currency(std::get<0>(row)),
+              accounting::toDays(date.year(), date.month(), date.day()), std::get<2>(row));
+  }
+
+  return rates;
+}
+
+} // namespace db
@@ -0,0 +1,179 @@
+//! \file JournalCopy.cpp
+//! \brief Bulk journal entry insert over PostgreSQL COPY
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/JournalCopy.h"
+
+#include <libpq-fe.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+#include "accounting/ChangeFeed.h"
+
+namespace db
+{
+
+namespace
+{
+
+  struct ClearResult
+  {
+    void operator()(PGresult *result) const { PQclear(result); }
+  };
+
+  typedef std::unique_ptr<PGresult, ClearResult> Result;
+
+}
+
+JournalCopy::JournalCopy(const std::string &connection)
+    : connection_(PQconnectdb(connection.c_str()))
+{
+  if (PQstatus(connection_) != CONNECTION_OK)
+  {
+    const std::string message = PQerrorMessage(connection_);
+    PQfinish(connection_);
+    throw std::runtime_error("can't connect to PostgreSQL: " + message);
+  }
+}
+
+JournalCopy::~JournalCopy()
+{
+  PQfinish(connection_);
+}
+
+void JournalCopy::execute(const char *statement)
+{
+  Result result(PQexec(connection_, statement));
+  if (PQresultStatus(result.get()) != PGRES_COMMAND_OK)
+    throw std::runtime_error(std::string(statement) + ": " + PQerrorMessage(connection_));
+}
+
+int JournalCopy::lockBooks()
+{
+  const char *statement = "update ledger_lock set closed_through = closed_through returning closed_through";
+  Result result(PQexec(connection_, statement));
+  if (PQresultStatus(result.get()) != PGRES_TUPLES_OK || PQntuples(result.get()) != 1)
+    throw std::runtime_error(std::string(statement) + ": " + PQerrorMessage(connection_));
+  return std::atoi(PQgetvalue(result.get(), 0, 0));
+}
+
+std::vector<long long> JournalCopy::nextIds(const char *sequence, std::size_t count)
+{
+  const std::string query = std::string("select nextval('") + sequence + "') from generate_series(1, " +
+                            std::to_string(count) + ")";
+  Result result(PQexec(connection_, query.c_str()));
+  if (PQresultStatus(result.get()) != PGRES_TUPLES_OK || PQntuples(result.get()) != static_cast<int>(count))
+    throw std::runtime_error(query + ": " + PQerrorMessage(connection_));
+
+  std::vector<long long> ids(count);
+  for (std::size_t i = 0; i < count; ++i)
+    ids[i] = std::atoll(PQgetvalue(result.get(), static_cast<int>(i), 0));
+  return ids;
+}
+
+void JournalCopy::copy(const char *statement, const std::string &rows)
+{
+  {
+    Result result(PQexec(connection_, statement));
+    if (PQresultStatus(result.get()) != PGRES_COPY_IN)
+      throw std::runtime_error(std::string(statement) + ": " + PQerrorMessage(connection_));
+  }
+
+  if (PQputCopyData(connection_, rows.data(), static_cast<int>(rows.size())) != 1 ||
+      PQputCopyEnd(connection_, nullptr) != 1)
+    throw std::runtime_error(std::string(statement) + ": " + PQerrorMessage(connection_));
+
+  // The COPY's own result, then the end of results.
+  bool ok = true;
+  while (PGresult *raw = PQgetResult(connection_))
+  {
+    Result result(raw);
+    ok = ok && PQresultStatus(raw) == PGRES_COMMAND_OK;
+  }
+  if (!ok)
+    throw std::runtime_error(std::string(statement) + ": " + PQerrorMessage(connection_));
+}
+
+std::vector<long long> JournalCopy::insert(const std::vector<const accounting::ledger::JournalEntry *> &entries,
+                                          int closedThrough)
+{
+  if (entries.empty())
+    return std::vector<long long>();
+
+  std::size_t lineCount = 0;
+  for (const accounting::ledger::JournalEntry *entry : entries)
+    lineCount += entry->lines.size();
+
+  execute("begin");
+  try
+  {
+    // Under the lock no close can come in before the commit, and the ids
+    // are drawn in commit order.
+    closedThrough = std::max(closedThrough, lockBooks());
+    for (const accounting::ledger::JournalEntry *entry : entries)
+    {
+      if (entry->date <= closedThrough)
+        throw std::invalid_argument("journal entry is dated in a closed period");
+    }
+
+    const std::vector<long long> ids = nextIds("journal_entry_id_seq", entries.size());
+    const std::vector<long long> lineIds = nextIds("journal_line_id_seq", lineCount);
+
+    std::string rows;
+    rows.reserve(entries.size() * 48);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+      entryRow(rows, ids[i], *entries[i]);
+    copy("copy journal_entry (id, version, date, memo) from stdin", rows);
+
+    rows.clear();
+    rows.reserve(lineCount * 64);
+    std::size_t line = 0;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      for (const accounting::ledger::JournalLine &journalLine : entries[i]->lines)
+        lineRow(rows, lineIds[line++], ids[i], journalLine);
+    }
+    copy("copy journal_line (id, version, entry_id, account_id, amount, reference, currency, currency_amount) "
+         "from stdin",
+         rows);
+
+    std::vector<std::string> changes;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      for (const accounting::Change &change : accounting::Change::posted(ids[i], *entries[i]))
+        changes.push_back(change.encode());
+    }
+    const std::vector<long long> changeIds = nextIds("change_log_id_seq", changes.size());
+
+    rows.clear();
+    for (std::size_t i = 0; i < changes.size(); ++i)
+      changeRow(rows, changeIds[i], changes[i]);
+    copy("copy change_log (id, version, data) from stdin", rows);
+
+    execute("commit");
+    return ids;
+  }
+  catch (std::exception &)
+  {
+    Result(PQexec(connection_, "rollback"));
+    throw;
+  }
+}
+
+} // namespace db
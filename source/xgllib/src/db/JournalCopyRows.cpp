@@ -0,0 +1,119 @@
+//! \file JournalCopyRows.cpp
+//! \brief COPY text format rows for JournalCopy
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/JournalCopy.h"
+
+#include <charconv>
+#include <cstdio>
+
+#include "accounting/Date.h"
+
+namespace db
+{
+
+namespace
+{
+
+  void number(std::string &out, long long value)
+  {
+    char buffer[24];
+    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+  }
+
+  //! Shortest text that reads back as the same double
+  void number(std::string &out, double value)
+  {
+    char buffer[32];
+    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+  }
+
+  //! Backslash, tab and line breaks are special in COPY text.
+  void text(std::string &out, const std::string &text)
+  {
+    for (char c : text)
+    {
+      switch (c)
+      {
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      default:
+        out += c;
+      }
+    }
+  }
+
+}
+
+void JournalCopy::entryRow(std::string &out, long long id, const accounting::ledger::JournalEntry &entry)
+{
+  int year, month, day;
+  accounting::fromDays(entry.date, year, month, day);
+  char date[16];
+  std::snprintf(date, sizeof(date), "%04d-%02d-%02d", year, month, day);
+
+  number(out, id);
+  out += "\t0\t";
+  out += date;
+  out += '\t';
+  text(out, entry.memo);
+  out += '\n';
+}
+
+void JournalCopy::lineRow(std::string &out, long long id, long long entryId, const accounting::ledger::JournalLine &line)
+{
+  number(out, id);
+  out += "\t0\t";
+  number(out, entryId);
+  out += '\t';
+  number(out, line.account_id);
+  out += '\t';
+  number(out, line.amount);
+  out += '\t';
+  text(out, line.reference);
+  out += '\t';
+  out += line.currency.code();
+  out += '\t';
+  number(out, line.currency == accounting::USD ? line.amount : line.currency_amount);
+  out += '\n';
+}
+
+void JournalCopy::changeRow(std::string &out, long long id, const std::string &data)
+{
+  static const char HEX[] = "0123456789abcdef";
+
+  // bytea in hex; the backslash doubled for COPY.
+  number(out, id);
+  out += "\t0\t\\\\x";
+  for (unsigned char c : data)
+  {
+    out += HEX[c >> 4];
+    out += HEX[c & 0xf];
+  }
+  out += '\n';
+}
+
+} // namespace db
@@ -0,0 +1,253 @@
+//! \file JournalEntry.cpp
+//! \brief Journal entry and journal line records
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/JournalEntry.h"
+
+#include <Wt/Dbo/Impl.h>
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include <climits>
+#include <map>
+#include <stdexcept>
+
+#include "accounting/Date.h"
+#include "db/LedgerSession.h"
+
+DBO_INSTANTIATE_TEMPLATES(db::JournalEntry)
+DBO_INSTANTIATE_TEMPLATES(db::JournalLine)
+
+namespace db
+{
+
+namespace
+{
+
+  Wt::WDate toDate(int days)
+  {
+    int year, month, day;
+    accounting::fromDays(days, year, month, day);
+    return Wt::WDate(year, month, day);
+  }
+
+}
+
+void checkOpenPeriod(LedgerSession &session, int date)
+{
+  if (date <= session.closedThrough())
+    throw std::invalid_argument("journal entry is dated in a closed period");
+}
+
+dbo::ptr<JournalEntry> addJournalEntry(LedgerSession &session, const accounting::ledger::JournalEntry &entry)
+{
+  checkOpenPeriod(session, entry.date);
+
+  int year, month, day;
+  accounting::fromDays(entry.date, year, month, day);
+
+  auto record = std::make_unique<JournalEntry>();
+  record->date = Wt::WDate(year, month, day);
+  record->memo = entry.memo;
+  dbo::ptr<JournalEntry> added = session.add(std::move(record));
+
+  for (const accounting::ledger::JournalLine &line : entry.lines)
+  {
+    auto lineRecord = std::make_unique<JournalLine>();
+    lineRecord->entry = added;
+    lineRecord->accountId = line.account_id;
+    lineRecord->amount = line.amount;
+    lineRecord->reference = line.reference;
+    lineRecord->currency = line.currency.code();
+    lineRecord->currencyAmount = line.currency == accounting::USD ? line.amount : line.currency_amount;
+    session.add(std::move(lineRecord));
+  }
+
+  // The entry needs its id for the change log.
+  added.flush();
+  recordChanges(session, accounting::Change::posted(added.id(), entry));
+
+  return added;
+}
+
+accounting::ledger::Balances loadBalances(LedgerSession &session, const std::vector<long long> &accounts)
+{
+  typedef std::tuple<long long, double> Row;
+
+  accounting::ledger::Balances balances;
+  if (accounts.empty())
+    return balances;
+
+  std::string in = "account_id in (?";
+  for (std::size_t i = 1; i < accounts.size(); ++i)
+    in += ", ?";
+  in += ")";
+
+  const ArchiveStore::Closed closed = session.closedPeriods();
+
+  dbo::Transaction transaction(session);
+
+  dbo::Query<Row> query = session.query<Row>(
+      "select account_id, sum(amount) from journal_line")
+      .where(in)
+      .groupBy("account_id");
+  for (long long account : accounts)
+    query.bind(account);
+  if (closed.through != INT_MIN)
+    query.where("entry_id in (select id from journal_entry where date > ?)").bind(toDate(closed.through));
+
+  for (const Row &row : query.resultList())
+    balances[std::get<0>(row)] = std::get<1>(row);
+
+  for (const auto &archive : closed.archives)
+    archive->addBalances(balances, accounts);
+
+  // Accounts with no lines yet have a zero balance.
+  for (long long account : accounts)
+    balances.emplace(account, 0.0);
+
+  return balances;
+}
+
+accounting::ledger::Balances loadBalances(LedgerSession &session, int date)
+{
+  typedef std::tuple<long long, double> Row;
+
+  accounting::ledger::Balances balances;
+
+  const ArchiveStore::Closed closed = session.closedPeriods();
+  if (date > closed.through)
+  {
+    dbo::Transaction transaction(session);
+
+    dbo::Query<Row> query = session.query<Row>(
+        "select l.account_id, sum(l.amount) "
+        "from journal_line l join journal_entry e on l.entry_id = e.id")
+        .where("e.date <= ?").bind(toDate(date))
+        .groupBy("l.account_id");
+    if (closed.through != INT_MIN)
+      query.where("e.date > ?").bind(toDate(closed.through));
+
+    for (const Row &row : query.resultList())
+      balances[std::get<0>(row)] = std::get<1>(row);
+  }
+
+  for (const auto &archive : closed.archives)
+  {
+    if (archive->first() <= date)
+      archive->addBalances(balances, date);
+  }
+
+  return balances;
+}
+
+std::vector<accounting::ledger::CashLine> loadAccountLines(LedgerSession &session, long long accountId,
+                                                           int from, int to)
+{
+  typedef std::tuple<long long, Wt::WDate, double, std::string> Row;
+
+  std::vector<accounting::ledger::CashLine> lines;
+
+  // The archives hold everything up to the close, in date order, and
+  // the database everything after it.
+  const ArchiveStore::Closed closed = session.closedPeriods();
+  if (from <= closed.through)
+  {
+    for (const auto &archive : closed.archives)
+      archive->addAccountLines(lines, accountId, from, to);
+  }
+  if (to <= closed.through)
+    return lines;
+
+  const Wt::WDate first = toDate(from > closed.through ? from : closed.through + 1);
+  const Wt::WDate last = toDate(to);
+
+  dbo::Transaction transaction(session);
+
+  dbo::collection<Row> rows = session.query<Row>(
+      "select l.id, e.date, l.amount, l.reference "
+      "from journal_line l join journal_entry e on l.entry_id = e.id")
+      .where("l.account_id = ?").bind(accountId)
+      .where("e.date >= ?").bind(first)
+      .where("e.date <= ?").bind(last)
+      .orderBy("e.date, l.id");
+
+  for (const Row &row : rows)
+  {
+    const Wt::WDate &date = std::get<1>(row);
+    lines.push_back(accounting::ledger::CashLine{
+        std::get<0>(row), accounting::toDays(date.year(), date.month(), date.day()),
+        std::get<2>(row), std::get<3>(row) });
+  }
+
+  return lines;
+}
+
+std::vector<accounting::ledger::ForeignBalance> loadForeignBalances(LedgerSession &session, int date)
+{
+  typedef std::tuple<long long, std::string, double, double> Row;
+
+  const ArchiveStore::Closed closed = session.closedPeriods();
+
+  // The archived totals and the database's, added together by account
+  // and currency.
+  std::map<std::pair<long long, accounting::Currency>, accounting::ledger::ForeignBalance> merged;
+  auto merge = [&merged](const accounting::ledger::ForeignBalance &balance) {
+    auto found = merged.emplace(std::make_pair(balance.account_id, balance.currency), balance);
+    if (!found.second)
+    {
+      found.first->second.currency_balance += balance.currency_balance;
+      found.first->second.book_balance += balance.book_balance;
+    }
+  };
+
+  for (const auto &archive : closed.archives)
+  {
+    if (archive->first() <= date)
+    {
+      for (const accounting::ledger::ForeignBalance &balance : archive->foreignBalances(date))
+        merge(balance);
+    }
+  }
+
+  if (date > closed.through)
+  {
+    dbo::Transaction transaction(session);
+
+    dbo::Query<Row> query = session.query<Row>(
+        "select l.account_id, l.currency, sum(l.currency_amount), sum(l.amount) "
+        "from journal_line l join journal_entry e on l.entry_id = e.id")
+        .where("l.currency <> ?").bind(accounting::USD.code())
+        .where("e.date <= ?").bind(toDate(date))
+        .groupBy("l.account_id, l.currency");
+    if (closed.through != INT_MIN)
+      query.where("e.date > ?").bind(toDate(closed.through));
+
+    for (const Row &row : query.resultList())
+    {
+      merge(accounting::ledger::ForeignBalance{
+          std::get<0>(row), accounting::Currency(std::get<1>(row)), std::get<2>(row), std::get<3>(row) });
+    }
+  }
+
+  std::vector<accounting::ledger::ForeignBalance> balances;
+  balances.reserve(merged.size());
+  for (const auto &balance : merged)
+    balances.push_back(balance.second);
+  return balances;
+}
+
+} // namespace db
@@ -0,0 +1,169 @@
+//! \file LedgerCache.cpp
+//! \brief A company's in-memory ledger state, kept current
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/LedgerCache.h"
+
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include <filesystem>
+#include <iostream>
+#include <tuple>
+
+#include "accounting/Date.h"
+#include "db/LedgerSession.h"
+
+namespace db
+{
+
+LedgerCache::LedgerCache(const std::string &checkpoint)
+    : file_(checkpoint)
+{
+  if (std::filesystem::exists(file_))
+  {
+    try
+    {
+      state_ = accounting::LedgerState(file_);
+    }
+    catch (std::exception &e)
+    {
+      std::cerr << e.what() << "; rebuilding it from the journal." << std::endl;
+    }
+  }
+
+  checkpointLine_ = state_.lastLine();
+  checkpointPaycheck_ = state_.lastPaycheck();
+  checkpointClosed_ = state_.closedThrough();
+}
+
+void LedgerCache::refresh(LedgerSession &session)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  catchUp(session);
+}
+
+accounting::ledger::Balances LedgerCache::balances(LedgerSession &session, const std::vector<long long> &accounts)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  catchUp(session);
+  return state_.balances(accounts);
+}
+
+std::vector<accounting::PayrollTotals> LedgerCache::yearToDate(LedgerSession &session,
+                                                               const std::vector<long long> &employees, int year)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  catchUp(session);
+
+  std::vector<accounting::PayrollTotals> totals;
+  totals.reserve(employees.size());
+  for (long long employee : employees)
+    totals.push_back(state_.yearToDate(employee, year));
+  return totals;
+}
+
+void LedgerCache::checkpoint()
+{
+  std::lock_guard<std::mutex> writing(writeMutex_);
+
+  // Copy the state, so that readers don't wait on the disk.
+  accounting::LedgerState state;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_.lastLine() == checkpointLine_ && state_.lastPaycheck() == checkpointPaycheck_ &&
+        state_.closedThrough() == checkpointClosed_)
+      return;
+    state = state_;
+    checkpointLine_ = state.lastLine();
+    checkpointPaycheck_ = state.lastPaycheck();
+    checkpointClosed_ = state.closedThrough();
+  }
+
+  try
+  {
+    state.checkpoint(file_);
+  }
+  catch (std::exception &)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    checkpointLine_ = checkpointPaycheck_ = -1;
+    throw;
+  }
+}
+
+void LedgerCache::catchUp(LedgerSession &session)
+{
+  typedef std::tuple<long long, long long, double> LineRow;
+  typedef std::tuple<long long, long long, Wt::WDate, double, double, double> PaycheckRow;
+
+  const long long lastLine = state_.lastLine();
+  const long long lastPaycheck = state_.lastPaycheck();
+
+  // Periods closed since we last looked took their rows out of the
+  // database, maybe before we saw them.  Take in their lines we haven't,
+  // and their years' payroll afresh.
+  const ArchiveStore::Closed closed = session.closedPeriods();
+  if (closed.through != state_.closedThrough())
+  {
+    for (const auto &archive : closed.archives)
+    {
+      if (archive->last() <= state_.closedThrough())
+        continue;
+
+      for (std::size_t i = 0; i < archive->lines(); ++i)
+      {
+        const accounting::ArchivedLine line = archive->line(i);
+        if (line.id > lastLine)
+          state_.post(line.id, line.line.account_id, line.line.amount);
+      }
+
+      int first, last, month, day;
+      accounting::fromDays(archive->first(), first, month, day);
+      accounting::fromDays(archive->last(), last, month, day);
+      for (int year = first; year <= last; ++year)
+        state_.clearYear(year);
+      for (std::size_t i = 0; i < archive->paychecks(); ++i)
+        state_.pay(0, archive->paycheck(i).check);
+    }
+    state_.closedThrough(closed.through);
+  }
+
+  dbo::Transaction transaction(session);
+
+  dbo::collection<LineRow> lines = session.query<LineRow>(
+      "select id, account_id, amount from journal_line")
+      .where("id > ?").bind(lastLine);
+  for (const LineRow &row : lines)
+    state_.post(std::get<0>(row), std::get<1>(row), std::get<2>(row));
+
+  dbo::collection<PaycheckRow> paychecks = session.query<PaycheckRow>(
+      "select id, employee_id, pay_date, oasdi_wages, oasdi_employee, futa_wages from paycheck")
+      .where("id > ?").bind(lastPaycheck);
+  for (const PaycheckRow &row : paychecks)
+  {
+    accounting::payroll::Paycheck check = {};
+    check.employee_id = std::get<1>(row);
+    check.year = std::get<2>(row).year();
+    check.month = std::get<2>(row).month();
+    check.oasdi_wages = std::get<3>(row);
+    check.oasdi_employee = std::get<4>(row);
+    check.futa_wages = std::get<5>(row);
+    state_.pay(std::get<0>(row), check);
+  }
+}
+
+} // namespace db
@@ -0,0 +1,61 @@
+//! \file LedgerSession.cpp
+//! \brief LedgerSession class
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/LedgerSession.h"
+
+#include <algorithm>
+
+namespace db
+{
+
+LedgerSession::LedgerSession(dbo::SqlConnectionPool &pool, ArchiveStore *archives)
+    : archives_(archives)
+{
+  setConnectionPool(pool);
+  mapClasses(*this);
+}
+
+void LedgerSession::lockBooks()
+{
+  // A write to the one row: a row lock on PostgreSQL, the write lock on
+  // SQLite.
+  execute("update ledger_lock set closed_through = closed_through");
+}
+
+int LedgerSession::closedThrough()
+{
+  const int closed = query<int>("select closed_through from ledger_lock");
+  return archives_ ? std::max(closed, archives_->closedThrough()) : closed;
+}
+
+void LedgerSession::closedThrough(int date)
+{
+  execute("update ledger_lock set closed_through = ?").bind(date);
+}
+
+void LedgerSession::mapClasses(dbo::Session &session)
+{
+  session.mapClass<Account>("account");
+  session.mapClass<Employee>("employee");
+  session.mapClass<Paycheck>("paycheck");
+  session.mapClass<JournalEntry>("journal_entry");
+  session.mapClass<JournalLine>("journal_line");
+  session.mapClass<ExchangeRate>("exchange_rate");
+  session.mapClass<Change>("change_log");
+}
+
+} // namespace db
@@ -0,0 +1,106 @@
+//! \file Paycheck.cpp
+//! \brief Paycheck record
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/Paycheck.h"
+
+#include <Wt/Dbo/Impl.h>
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include <climits>
+#include <stdexcept>
+
+#include "accounting/Date.h"
+#include "db/LedgerSession.h"
+
+DBO_INSTANTIATE_TEMPLATES(db::Paycheck)
+
+namespace db
+{
+
+dbo::ptr<Paycheck> addPaycheck(LedgerSession &session, int payDate, const accounting::payroll::Paycheck &check)
+{
+  if (payDate <= session.closedThrough())
+    throw std::invalid_argument("paycheck is dated in a closed period");
+
+  int year, month, day;
+  accounting::fromDays(payDate, year, month, day);
+
+  auto record = std::make_unique<Paycheck>();
+  record->employeeId = check.employee_id;
+  record->payDate = Wt::WDate(year, month, day);
+  record->period = check.period;
+  record->grossWages = check.gross_wages;
+  record->oasdiWages = check.oasdi_wages;
+  record->oasdiEmployee = check.oasdi_employee;
+  record->oasdiEmployer = check.oasdi_employer;
+  record->futaWages = check.futa_wages;
+  dbo::ptr<Paycheck> added = session.add(std::move(record));
+
+  accounting::payroll::Paycheck paid = check;
+  paid.year = year;
+  paid.month = month;
+  recordChanges(session, { accounting::Change::paid(payDate, paid) });
+
+  return added;
+}
+
+std::vector<accounting::payroll::Paycheck> loadPayrollHistory(LedgerSession &session, int year)
+{
+  typedef std::tuple<long long, Wt::WDate, int, double, double, double, double, double> Row;
+
+  std::vector<accounting::payroll::Paycheck> history;
+
+  const ArchiveStore::Closed closed = session.closedPeriods();
+  for (const auto &archive : closed.archives)
+    archive->addPaychecks(history, year);
+  if (accounting::toDays(year, 12, 31) <= closed.through)
+    return history;
+
+  dbo::Transaction transaction(session);
+
+  dbo::Query<Row> query = session.query<Row>(
+      "select employee_id, pay_date, period, gross_wages, oasdi_wages, "
+      "oasdi_employee, oasdi_employer, futa_wages from paycheck")
+      .where("pay_date >= ?").bind(Wt::WDate(year, 1, 1))
+      .where("pay_date <= ?").bind(Wt::WDate(year, 12, 31));
+  if (closed.through != INT_MIN)
+  {
+    int closedYear, month, day;
+    accounting::fromDays(closed.through, closedYear, month, day);
+    query.where("pay_date > ?").bind(Wt::WDate(closedYear, month, day));
+  }
+
+  for (const Row &row : query.resultList())
+  {
+    accounting::payroll::Paycheck check;
+    check.employee_id = std::get<0>(row);
+    check.year = std::get<1>(row).year();
+    check.month = std::get<1>(row).month();
+    check.period = std::get<2>(row);
+    check.gross_wages = std::get<3>(row);
+    check.oasdi_wages = std::get<4>(row);
+    check.oasdi_employee = std::get<5>(row);
+    check.oasdi_employer = std::get<6>(row);
+    check.futa_wages = std::get<7>(row);
+    history.push_back(check);
+  }
+
+  return history;
+}
+
+} // namespace db
@@ -0,0 +1,174 @@
+//! \file PeriodClose.cpp
+//! \brief Closing the books for a year
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/PeriodClose.h"
+
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "accounting/Date.h"
+
+namespace db
+{
+
+namespace
+{
+
+  int toDays(const Wt::WDate &date)
+  {
+    return accounting::toDays(date.year(), date.month(), date.day());
+  }
+
+  //! Delete rows by id, a statement per chunk of ids
+  void deleteRows(dbo::Session &session, const char *table, const std::vector<long long> &ids)
+  {
+    const std::size_t CHUNK = 500;
+
+    for (std::size_t i = 0; i < ids.size(); i += CHUNK)
+    {
+      const std::size_t count = std::min(CHUNK, ids.size() - i);
+      std::string sql = std::string("delete from ") + table + " where id in (?";
+      for (std::size_t j = 1; j < count; ++j)
+        sql += ", ?";
+      sql += ")";
+
+      dbo::Call call = session.execute(sql);
+      for (std::size_t j = 0; j < count; ++j)
+        call.bind(ids[i + j]);
+      call.run();
+    }
+  }
+
+}
+
+accounting::PeriodArchive closeYear(LedgerSession &session, int year)
+{
+  typedef std::tuple<long long, Wt::WDate, std::string> EntryRow;
+  typedef std::tuple<long long, long long, Wt::WDate, long long, double, std::string, std::string, double> LineRow;
+  typedef std::tuple<long long, long long, Wt::WDate, int, double, double, double, double, double> PaycheckRow;
+
+  if (!session.archives())
+    throw std::logic_error("session has no archive store");
+
+  dbo::Transaction transaction(session);
+
+  // Nothing can be posted to the year from here until the commit.
+  session.lockBooks();
+
+  const int closed = session.closedThrough();
+  const int last = accounting::toDays(year, 12, 31);
+  if (last <= closed)
+    throw std::invalid_argument(std::to_string(year) + " is already closed");
+
+  const Wt::WDate lastDate(year, 12, 31);
+  int closedYear, closedMonth, closedDay;
+  accounting::fromDays(closed == INT_MIN ? 0 : closed, closedYear, closedMonth, closedDay);
+  const Wt::WDate closedDate(closedYear, closedMonth, closedDay);
+
+  // Everything since the last close.  The first close takes in whatever
+  // is older than the year, too.
+  dbo::Query<EntryRow> entryQuery = session.query<EntryRow>("select id, date, memo from journal_entry")
+      .where("date <= ?").bind(lastDate);
+  dbo::Query<LineRow> lineQuery = session.query<LineRow>(
+      "select l.id, l.entry_id, e.date, l.account_id, l.amount, l.reference, l.currency, l.currency_amount "
+      "from journal_line l join journal_entry e on l.entry_id = e.id")
+      .where("e.date <= ?").bind(lastDate);
+  dbo::Query<PaycheckRow> paycheckQuery = session.query<PaycheckRow>(
+      "select id, employee_id, pay_date, period, gross_wages, oasdi_wages, "
+      "oasdi_employee, oasdi_employer, futa_wages from paycheck")
+      .where("pay_date <= ?").bind(lastDate);
+  if (closed != INT_MIN)
+  {
+    entryQuery.where("date > ?").bind(closedDate);
+    lineQuery.where("e.date > ?").bind(closedDate);
+    paycheckQuery.where("pay_date > ?").bind(closedDate);
+  }
+
+  int first = closed == INT_MIN ? accounting::toDays(year, 1, 1) : closed + 1;
+
+  std::vector<accounting::ArchivedEntry> entries;
+  for (const EntryRow &row : entryQuery.resultList())
+  {
+    entries.push_back(accounting::ArchivedEntry{ std::get<0>(row), toDays(std::get<1>(row)), std::get<2>(row) });
+    first = std::min(first, entries.back().date);
+  }
+
+  std::vector<accounting::ArchivedLine> lines;
+  for (const LineRow &row : lineQuery.resultList())
+  {
+    accounting::ledger::JournalLine line{ std::get<3>(row), std::get<4>(row), std::get<5>(row),
+                                          accounting::Currency(std::get<6>(row)), std::get<7>(row) };
+    lines.push_back(accounting::ArchivedLine{ std::get<0>(row), std::get<1>(row), toDays(std::get<2>(row)), line });
+  }
+
+  std::vector<accounting::ArchivedPaycheck> paychecks;
+  std::vector<long long> paycheckIds;
+  for (const PaycheckRow &row : paycheckQuery.resultList())
+  {
+    accounting::ArchivedPaycheck paycheck;
+    paycheck.pay_date = toDays(std::get<2>(row));
+    paycheck.check.employee_id = std::get<1>(row);
+    paycheck.check.year = std::get<2>(row).year();
+    paycheck.check.month = std::get<2>(row).month();
+    paycheck.check.period = std::get<3>(row);
+    paycheck.check.gross_wages = std::get<4>(row);
+    paycheck.check.oasdi_wages = std::get<5>(row);
+    paycheck.check.oasdi_employee = std::get<6>(row);
+    paycheck.check.oasdi_employer = std::get<7>(row);
+    paycheck.check.futa_wages = std::get<8>(row);
+    paychecks.push_back(paycheck);
+    paycheckIds.push_back(std::get<0>(row));
+    first = std::min(first, paycheck.pay_date);
+  }
+
+  accounting::PeriodArchive archive(first, last);
+  for (const accounting::ArchivedEntry &entry : entries)
+    archive.add(entry);
+  for (const accounting::ArchivedLine &line : lines)
+    archive.add(line);
+  for (const accounting::ArchivedPaycheck &paycheck : paychecks)
+    archive.add(paycheck);
+
+  // Synced and renamed into place before anything is deleted.
+  session.archives()->add(year, archive);
+
+  // Exactly the rows archived.
+  std::vector<long long> ids;
+  for (const accounting::ArchivedLine &line : lines)
+    ids.push_back(line.id);
+  deleteRows(session, "journal_line", ids);
+  ids.clear();
+  for (const accounting::ArchivedEntry &entry : entries)
+    ids.push_back(entry.id);
+  deleteRows(session, "journal_entry", ids);
+  deleteRows(session, "paycheck", paycheckIds);
+
+  session.closedThrough(last);
+  recordChanges(session, { accounting::Change::closed(last) });
+
+  transaction.commit();
+
+  return archive;
+}
+
+} // namespace db
@@ -0,0 +1,225 @@
+//! \file PostingService.cpp
+//! \brief Process-wide journal posting service
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/PostingService.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "db/JournalCopy.h"
+#include "db/JournalEntry.h"
+#include "db/LedgerSession.h"
+#include "db/ShardRouter.h"
+
+namespace db
+{
+
+PostingService::PostingService(ShardRouter &router, std::size_t maxBatch, int writers)
+    : router_(router),
+      maxBatch_(maxBatch),
+      stop_(false)
+{
+  for (int i = 0; i < std::max(1, writers); ++i)
+    writers_.push_back(std::make_unique<Writer>());
+  for (std::unique_ptr<Writer> &writer : writers_)
+    writer->thread = std::thread(&PostingService::run, this, std::ref(*writer));
+}
+
+PostingService::~PostingService()
+{
+  stop_ = true;
+  for (std::unique_ptr<Writer> &writer : writers_)
+  {
+    {
+      std::lock_guard<std::mutex> lock(writer->mutex);
+      writer->wake.notify_one();
+    }
+    writer->thread.join();
+  }
+}
+
+std::future<long long> PostingService::post(long long companyId, accounting::ledger::JournalEntry entry)
+{
+  if (!entry.balanced())
+    throw std::invalid_argument("journal entry does not balance");
+
+  Posting posting;
+  posting.companyId = companyId;
+  posting.entry = std::move(entry);
+  std::future<long long> result = posting.done.get_future();
+
+  Writer &writer = *writers_[static_cast<unsigned long long>(companyId) % writers_.size()];
+  writer.queue.push(std::move(posting));
+
+  // Only pay for the lock when the writer is asleep.
+  if (writer.waiting)
+  {
+    std::lock_guard<std::mutex> lock(writer.mutex);
+    writer.wake.notify_one();
+  }
+
+  return result;
+}
+
+void PostingService::setCommitListener(CommitListener listener)
+{
+  std::lock_guard<std::mutex> lock(listenerMutex_);
+  listener_ = std::move(listener);
+}
+
+void PostingService::run(Writer &writer)
+{
+  // The writer's sessions, one per company it has posted to, and with
+  // PostgreSQL its COPY connections.
+  std::map<long long, std::unique_ptr<LedgerSession>> sessions;
+  std::map<long long, std::unique_ptr<JournalCopy>> copies;
+  std::map<long long, std::vector<Posting>> batches;
+
+#ifdef XGL_WITH_POSTGRES
+  const bool useCopy = router_.config().backend == DatabaseConfig::ePostgres;
+#endif
+
+  for (;;)
+  {
+    std::size_t pending = 0;
+    Posting posting;
+    while (pending < maxBatch_ && writer.queue.pop(posting))
+    {
+      batches[posting.companyId].push_back(std::move(posting));
+      ++pending;
+    }
+
+    if (pending)
+    {
+      for (auto &batch : batches)
+      {
+        if (batch.second.empty())
+          continue;
+
+        std::unique_ptr<LedgerSession> &session = sessions[batch.first];
+        std::unique_ptr<JournalCopy> &copy = copies[batch.first];
+        try
+        {
+          if (!session)
+            session = router_.session(batch.first);
+#ifdef XGL_WITH_POSTGRES
+          if (useCopy && !copy)
+            copy = std::make_unique<JournalCopy>(
+                router_.config().connectionString(ShardRouter::databaseName(batch.first)));
+#endif
+        }
+        catch (std::exception &)
+        {
+          // The company's database can't be opened; fail its postings.
+          for (Posting &failed : batch.second)
+            failed.done.set_exception(std::current_exception());
+          batch.second.clear();
+          continue;
+        }
+
+        commit(batch.first, *session, copy.get(), batch.second);
+        batch.second.clear();
+      }
+      continue;
+    }
+
+    if (stop_)
+      break;
+
+    // The timeout bounds the latency of a wakeup lost to a push that
+    // was still in progress when we looked.
+    std::unique_lock<std::mutex> lock(writer.mutex);
+    writer.waiting = true;
+    writer.wake.wait_for(lock, std::chrono::milliseconds(10),
+                         [this, &writer] { return stop_ || !writer.queue.empty(); });
+    writer.waiting = false;
+  }
+}
+
+void PostingService::commit(long long companyId, LedgerSession &session, JournalCopy *copy,
+                            std::vector<Posting> &batch)
+{
+  try
+  {
+    std::vector<long long> ids;
+    ids.reserve(batch.size());
+
+    if (copy)
+    {
+      std::vector<const accounting::ledger::JournalEntry *> entries;
+      entries.reserve(batch.size());
+      for (Posting &posting : batch)
+        entries.push_back(&posting.entry);
+      ids = copy->insert(entries, session.closedPeriods().through);
+    }
+    else
+    {
+      std::vector<dbo::ptr<JournalEntry>> added;
+      added.reserve(batch.size());
+
+      dbo::Transaction transaction(session);
+      session.lockBooks();
+      for (Posting &posting : batch)
+        added.push_back(addJournalEntry(session, posting.entry));
+      transaction.commit();
+
+      for (const dbo::ptr<JournalEntry> &entry : added)
+        ids.push_back(entry.id());
+    }
+
+    for (std::size_t i = 0; i < batch.size(); ++i)
+      batch[i].done.set_value(ids[i]);
+  }
+  catch (std::exception &e)
+  {
+    // The rolled back entries are still pending in the session; drop
+    // them, or the next commit on it would flush them again.
+    session.discardUnflushed();
+
+    if (batch.size() == 1)
+    {
+      batch[0].done.set_exception(std::current_exception());
+      return;
+    }
+
+    std::cerr << "Group commit of " << batch.size() << " entries failed ("
+              << e.what() << "); posting individually." << std::endl;
+
+    for (Posting &posting : batch)
+    {
+      std::vector<Posting> one;
+      one.push_back(std::move(posting));
+      commit(companyId, session, copy, one);
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(listenerMutex_);
+  if (listener_)
+  {
+    std::unordered_set<long long> touched;
+    for (const Posting &posting : batch)
+      for (const accounting::ledger::JournalLine &line : posting.entry.lines)
+        touched.insert(line.account_id);
+    listener_(companyId, std::vector<long long>(touched.begin(), touched.end()));
+  }
+}
+
+} // namespace db
@@ -0,0 +1,182 @@
+//! \file Schema.cpp
+//! \brief Database schema versions and migrations
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/Schema.h"
+
+#include <Wt/Dbo/Exception.h>
+#include <Wt/Dbo/Session.h>
+#include <Wt/Dbo/Transaction.h>
+
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "db/ChangeLog.h"
+#include "db/DBSession.h"
+#include "db/LedgerSession.h"
+
+namespace db
+{
+
+namespace
+{
+
+  //! A migration; takes the schema from one version to the next
+  typedef void (*Migration)(dbo::SqlConnectionPool &pool, dbo::Session &session);
+
+  //! Check whether a table has a column; a table that doesn't exist has none
+  bool hasColumn(dbo::Session &session, const std::string &table, const std::string &column)
+  {
+    try
+    {
+      // In a transaction of its own: a failed statement spoils a
+      // PostgreSQL transaction.
+      dbo::Transaction transaction(session);
+      session.query<int>("select count(" + column + ") from " + table + " where 1 = 0").resultValue();
+      transaction.commit();
+      return true;
+    }
+    catch (dbo::Exception &)
+    {
+      return false;
+    }
+  }
+
+  //! Create the table of a mapped class, if it doesn't exist
+  template<class C>
+  void createTable(dbo::SqlConnectionPool &pool, dbo::Session &session, const char *table)
+  {
+    if (hasColumn(session, table, "id"))
+      return;
+
+    dbo::Session creator;
+    creator.setConnectionPool(pool);
+    creator.mapClass<C>(table);
+    creator.createTables();
+  }
+
+  //! Version 1: foreign currency journal lines, and exchange rates
+  void currencies(dbo::SqlConnectionPool &pool, dbo::Session &session)
+  {
+    if (!hasColumn(session, "journal_line", "currency"))
+    {
+      dbo::Transaction transaction(session);
+      session.execute("alter table journal_line add column currency varchar(3) not null default 'USD'");
+      session.execute("alter table journal_line add column currency_amount double precision not null default 0");
+      session.execute("update journal_line set currency_amount = amount");
+      transaction.commit();
+    }
+
+    createTable<ExchangeRate>(pool, session, "exchange_rate");
+  }
+
+  //! Version 2: the chart of accounts
+  void chartOfAccounts(dbo::SqlConnectionPool &pool, dbo::Session &session)
+  {
+    createTable<Account>(pool, session, "account");
+  }
+
+  //! Version 3: the books lock, which holds the last day closed
+  void booksLock(dbo::SqlConnectionPool &, dbo::Session &session)
+  {
+    dbo::Transaction transaction(session);
+    session.execute("create table if not exists ledger_lock (closed_through integer not null)");
+    if (session.query<int>("select count(1) from ledger_lock") == 0)
+      session.execute("insert into ledger_lock (closed_through) values (?)").bind(INT_MIN);
+    transaction.commit();
+  }
+
+  //! Version 4: the change log
+  void changeLog(dbo::SqlConnectionPool &pool, dbo::Session &session)
+  {
+    createTable<Change>(pool, session, "change_log");
+  }
+
+  //! Version 1: the company whose books each user keeps
+  void userCompany(dbo::SqlConnectionPool &, dbo::Session &session)
+  {
+    if (hasColumn(session, "\"user\"", "company_id"))
+      return;
+
+    dbo::Transaction transaction(session);
+    session.execute("alter table \"user\" add column company_id bigint not null default 0");
+    transaction.commit();
+  }
+
+  const std::vector<Migration> LEDGER_MIGRATIONS = {
+      currencies,
+      chartOfAccounts,
+      booksLock,
+      changeLog
+  };
+
+  const std::vector<Migration> AUTH_MIGRATIONS = {
+      userCompany
+  };
+
+  //! \param table   A table every version has, to tell a new database
+  bool migrate(dbo::SqlConnectionPool &pool, dbo::Session &session, const char *table,
+               const std::vector<Migration> &migrations)
+  {
+    const int latest = static_cast<int>(migrations.size());
+
+    // A new database gets the mapped tables, then runs every migration
+    // for the rest (the migrations find their tables already there).
+    const bool created = !hasColumn(session, table, "id");
+    if (created)
+      session.createTables();
+
+    int version;
+    {
+      dbo::Transaction transaction(session);
+      session.execute("create table if not exists schema_version (version integer not null)");
+      version = session.query<int>("select coalesce(max(version), -1) from schema_version");
+      if (version < 0)
+      {
+        version = 0;
+        session.execute("insert into schema_version (version) values (?)").bind(version);
+      }
+      transaction.commit();
+    }
+
+    for (; version < latest; ++version)
+    {
+      migrations[version](pool, session);
+
+      dbo::Transaction transaction(session);
+      session.execute("update schema_version set version = ?").bind(version + 1);
+      transaction.commit();
+    }
+
+    return created;
+  }
+
+}
+
+bool migrateLedger(dbo::SqlConnectionPool &pool)
+{
+  LedgerSession session(pool);
+  return migrate(pool, session, "journal_entry", LEDGER_MIGRATIONS);
+}
+
+bool migrateAuth(dbo::SqlConnectionPool &pool)
+{
+  DBSession session(pool);
+  return migrate(pool, session, "auth_info", AUTH_MIGRATIONS);
+}
+
+} // namespace db
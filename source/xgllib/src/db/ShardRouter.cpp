@@ -0,0 +1,167 @@
+//! \file ShardRouter.cpp
+//! \brief ShardRouter class
+//!
+//! Copyright (C) 2021  IO Industrial Holdings, LLC
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "db/ShardRouter.h"
+
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "db/Schema.h"
+
+namespace db
+{
+
+namespace
+{
+
+  const char PREFIX[] = "company_";
+
+}
+
+ShardRouter::ShardRouter(const DatabaseConfig &config)
+    : config_(config)
+{
+  if (!config_.directory.empty() && config_.directory.back() != '/')
+    config_.directory += '/';
+}
+
+ShardRouter::ShardRouter(const std::string &directory, int poolSize)
+    : ShardRouter(DatabaseConfig{ DatabaseConfig::eSqlite3, directory, std::string(), poolSize })
+{
+}
+
+std::string ShardRouter::databaseName(long long companyId)
+{
+  return PREFIX + std::to_string(companyId);
+}
+
+std::string ShardRouter::databaseFile(long long companyId) const
+{
+  return config_.file(databaseName(companyId));
+}
+
+std::string ShardRouter::archiveDirectory(long long companyId) const
+{
+  return config_.directory + databaseName(companyId) + ".archive";
+}
+
+std::string ShardRouter::checkpointFile(long long companyId) const
+{
+  return config_.directory + databaseName(companyId) + ".checkpoint";
+}
+
+ShardRouter::Shard &ShardRouter::shard(long long companyId)
+{
+  Shard *company;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    company = &shards_[companyId];
+  }
+
+  std::lock_guard<std::mutex> lock(company->mutex);
+  if (!company->pool)
+  {
+    std::unique_ptr<dbo::SqlConnectionPool> pool = openPool(config_, databaseName(companyId));
+
+    // First use of this shard since startup; bring its tables up to date.
+    if (migrateLedger(*pool))
+      std::cerr << "Created database for company " << companyId << "." << std::endl;
+
+    company->archives = std::make_unique<ArchiveStore>(archiveDirectory(companyId));
+    company->pool = std::move(pool);
+  }
+
+  return *company;
+}
+
+std::unique_ptr<LedgerSession> ShardRouter::session(long long companyId)
+{
+  Shard &company = shard(companyId);
+  return std::make_unique<LedgerSession>(*company.pool, company.archives.get());
+}
+
+LedgerCache &ShardRouter::cache(long long companyId)
+{
+  Shard &company = shard(companyId);
+
+  std::lock_guard<std::mutex> lock(company.mutex);
+  if (!company.cache)
+    company.cache = std::make_unique<LedgerCache>(checkpointFile(companyId));
+  return *company.cache;
+}
+
+std::size_t ShardRouter::restore()
+{
+  const std::string directory = config_.directory.empty() ? "." : config_.directory;
+  if (!std::filesystem::is_directory(directory))
+    return 0;
+
+  std::vector<long long> companies;
+  for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory))
+  {
+    const std::string name = entry.path().stem().string();
+    if (entry.path().extension() != ".checkpoint" || name.compare(0, sizeof(PREFIX) - 1, PREFIX) != 0)
+      continue;
+    try
+    {
+      companies.push_back(std::stoll(name.substr(sizeof(PREFIX) - 1)));
+    }
+    catch (std::exception &)
+    {
+      // Not one of ours.
+    }
+  }
+
+  for (long long companyId : companies)
+    cache(companyId).refresh(*session(companyId));
+
+  return companies.size();
+}
+
+void ShardRouter::checkpoint()
+{
+  std::vector<std::pair<long long, Shard *>> shards;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &shard : shards_)
+      shards.emplace_back(shard.first, &shard.second);
+  }
+
+  // Shards are never removed, so they outlive the router lock.
+  std::vector<std::pair<long long, LedgerCache *>> caches;
+  for (const auto &shard : shards)
+  {
+    std::lock_guard<std::mutex> lock(shard.second->mutex);
+    if (shard.second->cache)
+      caches.emplace_back(shard.first, shard.second->cache.get());
+  }
+
+  for (const auto &cache : caches)
+  {
+    try
+    {
+      cache.second->checkpoint();
+    }
+    catch (std::exception &e)
+    {
+      std::cerr << "Can't checkpoint company " << cache.first << ": " << e.what() << std::endl;
+    }
+  }
+}
+
+} // namespace db
@@ -0,0 +1,66 @@
+//! \file File.cpp
+//! \brief Durable file replacement
+//!
+//! \copyright Copyright (C) 2021 IO Industrial Holdings, LLC; All Rights Reserved.
+//!
+//! This program is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU General Public License as published by
+//! the Free Software Foundation, either version 3 of the License, or
+//! (at your option) any later version.
+//!
+//! This program is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU General Public License for more details.
+//!
+//! You should have received a copy of the GNU General Public License
+//! along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "util/File.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace util {
+
+void writeFile(const std::string &file, const std::string &data)
+{
+    const std::string temporary = file + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("can't create " + temporary);
+
+    std::size_t written = 0;
+    while (written < data.size())
+    {
+        const ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0)
+        {
+            ::close(fd);
+            std::remove(temporary.c_str());
+            throw std::runtime_error("can't write " + temporary);
+        }
+        written += n;
+    }
+    const bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced || std::rename(temporary.c_str(), file.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("can't write " + file);
+    }
+
+    // Make the rename itself durable.
+    const std::string::size_type slash = file.rfind('/');
+    const std::string directory = slash == std::string::npos ? "." : file.substr(0, slash + 1);
+    const int dir = ::open(directory.c_str(), O_RDONLY);
+    if (dir >= 0)
+    {
+        ::fsync(dir);
+        ::close(dir);
+    }
+}
+
+}
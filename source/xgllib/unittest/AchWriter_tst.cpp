@@ -0,0 +1,249 @@
+/**
+ * \file AchWriter_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "accounting/payroll/AchWriter.h"
+#include "accounting/payroll/PayrollRun.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+using namespace accounting;
+using namespace accounting::payroll;
+
+namespace
+{
+    //! What the reference parser reads back out of an entry detail record.
+    struct ParsedEntry {
+        std::string transaction_code;
+        std::string routing;
+        std::string account;
+        long long cents;
+        long long id;
+        std::string name;
+        std::string trace;
+    };
+
+    long long number(const std::string &line, std::size_t position, std::size_t width)
+    {
+        const std::string field = line.substr(position - 1, width);
+        EXPECT_EQ(std::string::npos, field.find_first_not_of("0123456789")) << "'" << field << "' in\n" << line;
+        return std::stoll(field);
+    }
+
+    std::string field(const std::string &line, std::size_t position, std::size_t width)
+    {
+        return line.substr(position - 1, width);
+    }
+
+    //! A reference NACHA parser, written from the record layouts rather than
+    //! the writer: checks the structure and recomputes every control total.
+    std::vector<ParsedEntry> parse(const std::string &file)
+    {
+        std::vector<std::string> lines;
+        std::istringstream in(file);
+        for (std::string line; std::getline(in, line);)
+            lines.push_back(line);
+
+        std::vector<ParsedEntry> entries;
+        EXPECT_FALSE(lines.empty());
+        EXPECT_EQ(0u, lines.size() % 10);
+        for (const std::string &line : lines)
+            EXPECT_EQ(94u, line.size());
+        if (::testing::Test::HasFailure())
+            return entries;
+
+        std::size_t i = 0;
+        EXPECT_EQ('1', lines[i][0]);
+        EXPECT_EQ("094101", field(lines[i], 35, 6));
+        ++i;
+
+        long long batches = 0, fileEntries = 0, fileHash = 0, fileCredit = 0;
+        while (i < lines.size() && lines[i][0] == '5')
+        {
+            const std::string header = lines[i++];
+            ++batches;
+            EXPECT_EQ("220", field(header, 2, 3));
+            EXPECT_EQ("PPD", field(header, 51, 3));
+            EXPECT_EQ(batches, number(header, 88, 7));
+
+            long long count = 0, hash = 0, credit = 0;
+            for (; i < lines.size() && lines[i][0] == '6'; ++i)
+            {
+                const std::string &line = lines[i];
+                ParsedEntry e;
+                e.transaction_code = field(line, 2, 2);
+                EXPECT_TRUE(e.transaction_code == "22" || e.transaction_code == "32");
+                e.routing = field(line, 4, 9);
+                int sum = 0;
+                for (int d = 0; d < 9; ++d)
+                    sum += (e.routing[d] - '0') * (d % 3 == 0 ? 3 : d % 3 == 1 ? 7 : 1);
+                EXPECT_EQ(0, sum % 10) << e.routing;
+                e.account = field(line, 13, 17);
+                e.cents = number(line, 30, 10);
+                e.id = number(line, 40, 15);
+                e.name = field(line, 55, 22);
+                EXPECT_EQ('0', line[78]);
+                e.trace = field(line, 80, 15);
+                EXPECT_EQ(field(header, 80, 8), e.trace.substr(0, 8));
+                EXPECT_EQ(fileEntries + count + 1, number(line, 88, 7));
+
+                ++count;
+                hash += number(line, 4, 8);
+                credit += e.cents;
+                entries.push_back(e);
+            }
+
+            EXPECT_LT(i, lines.size());
+            const std::string control = lines[i++];
+            EXPECT_EQ('8', control[0]);
+            EXPECT_EQ("220", field(control, 2, 3));
+            EXPECT_EQ(count, number(control, 5, 6));
+            EXPECT_EQ(hash % 10000000000ll, number(control, 11, 10));
+            EXPECT_EQ(0, number(control, 21, 12));
+            EXPECT_EQ(credit, number(control, 33, 12));
+            EXPECT_EQ(field(header, 41, 10), field(control, 45, 10));
+            EXPECT_EQ(field(header, 80, 15), field(control, 80, 15));
+
+            fileEntries += count;
+            fileHash += hash;
+            fileCredit += credit;
+        }
+
+        EXPECT_LT(i, lines.size());
+        const std::string control = lines[i++];
+        EXPECT_EQ('9', control[0]);
+        EXPECT_EQ(batches, number(control, 2, 6));
+        EXPECT_EQ((long long)lines.size() / 10, number(control, 8, 6));
+        EXPECT_EQ(fileEntries, number(control, 14, 8));
+        EXPECT_EQ(fileHash % 10000000000ll, number(control, 22, 10));
+        EXPECT_EQ(0, number(control, 32, 12));
+        EXPECT_EQ(fileCredit, number(control, 44, 12));
+
+        for (; i < lines.size(); ++i)
+            EXPECT_EQ(std::string(94, '9'), lines[i]);
+
+        return entries;
+    }
+
+    AchOrigin origin()
+    {
+        return AchOrigin{ 91000019, "WELLS FARGO", "1123456789", "IO INDUSTRIAL", "IO INDUSTRIAL", "1123456789",
+                          121000248 };
+    }
+
+    const int PAY_DATE = toDays(2021, 7, 15);
+}
+
+TEST(AchWriter_tests, routing_check_digit)
+{
+    ASSERT_TRUE(DirectDeposit::validRouting(121000248));
+    ASSERT_TRUE(DirectDeposit::validRouting(11000015));
+    ASSERT_FALSE(DirectDeposit::validRouting(121000249));
+    ASSERT_FALSE(DirectDeposit::validRouting(0));
+    ASSERT_FALSE(DirectDeposit::validRouting(1210002480));
+}
+
+TEST(AchWriter_tests, records)
+{
+    std::ostringstream out;
+    AchWriter ach(out, origin(), toDays(2021, 7, 13), 14 * 60 + 5);
+    ach.beginBatch(PAY_DATE, "PAYROLL");
+    ach.credit(42, 123456, DirectDeposit::make(11000015, "000123456789", "JANE DOE"));
+    ach.credit(43, 1, DirectDeposit::make(121000248, "99", "JOHN Q PUBLIC", DirectDeposit::eAccountSavings));
+    ach.endBatch();
+    ach.finish();
+
+    const std::string file = out.str();
+    std::vector<ParsedEntry> entries = parse(file);
+    ASSERT_FALSE(::testing::Test::HasFailure());
+
+    ASSERT_EQ(10u * 95, file.size());
+    ASSERT_EQ("101 091000019112345678921071314" "05A094101WELLS FARGO            IO INDUSTRIAL                  ",
+              file.substr(0, 94));
+    ASSERT_EQ("5220IO INDUSTRIAL                       1123456789PPDPAYROLL         210715   1121000240000001",
+              file.substr(95, 94));
+    ASSERT_EQ("622011000015000123456789     0000123456000000000000042JANE DOE                0121000240000001",
+              file.substr(2 * 95, 94));
+
+    ASSERT_EQ(2u, entries.size());
+    ASSERT_EQ("32", entries[1].transaction_code);
+    ASSERT_EQ("121000248", entries[1].routing);
+    ASSERT_EQ(1, entries[1].cents);
+    ASSERT_EQ(43, entries[1].id);
+    ASSERT_EQ(2u, ach.entries());
+    ASSERT_EQ(123457, ach.totalCredit());
+}
+
+TEST(AchWriter_tests, rejects_bad_entries)
+{
+    std::ostringstream out;
+    AchWriter ach(out, origin(), PAY_DATE, 0);
+    ASSERT_THROW(ach.credit(1, 100, DirectDeposit::make(121000248, "1", "A")), std::logic_error);
+    ach.beginBatch(PAY_DATE, "PAYROLL");
+    ASSERT_THROW(ach.credit(1, 100, DirectDeposit::make(121000249, "1", "A")), std::invalid_argument);
+    ASSERT_THROW(ach.credit(1, 0, DirectDeposit::make(121000248, "1", "A")), std::invalid_argument);
+
+    AchOrigin bad = origin();
+    bad.odfi_routing = 12345;
+    ASSERT_THROW(AchWriter(out, bad, PAY_DATE, 0), std::invalid_argument);
+}
+
+// Test case: a 500,000 employee run streams out in one pass, and the
+// reference parser agrees with it.
+TEST(AchWriter_tests, payroll_run)
+{
+    const std::size_t employees = 500000;
+
+    EmployeeStore store;
+    store.reserve(employees);
+    std::vector<DirectDeposit> accounts;
+    accounts.reserve(employees);
+    for (std::size_t i = 0; i < employees; ++i)
+    {
+        store.add(Employee{ (long long)i + 1, 30000.0 + i % 90000, PayPeriod::ePayPeriodBiweekly });
+        // Every 100th employee is paid by check.
+        accounts.push_back(i % 100 ? DirectDeposit::make(i % 2 ? 121000248 : 11000015,
+                                                         std::to_string(1000000 + i), "EMPLOYEE " + std::to_string(i))
+                                   : DirectDeposit::make(0, "", ""));
+    }
+
+    PayrollRun run(2021, 7, 14, employees);
+    run.pay(store);
+
+    std::ostringstream out;
+    auto start = std::chrono::steady_clock::now();
+    AchWriter ach(out, origin(), PAY_DATE, 9 * 60);
+    ach.beginBatch(PAY_DATE, "PAYROLL");
+    const std::size_t written = ach.deposit(run.paychecks(), accounts);
+    ach.finish();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(employees - employees / 100, written);
+    // Timing is reported, not asserted; it depends on the machine.
+    RecordProperty("write_ms", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+
+    std::vector<ParsedEntry> entries = parse(out.str());
+    ASSERT_FALSE(::testing::Test::HasFailure());
+    ASSERT_EQ(written, entries.size());
+
+    long long total = 0;
+    for (std::size_t i = 0, e = 0; i < employees; ++i)
+    {
+        if (i % 100 == 0)
+            continue;
+        const Paycheck &check = run.paychecks()[i];
+        ASSERT_EQ(check.employee_id, entries[e].id);
+        ASSERT_EQ(std::llround(check.net_pay() * 100), entries[e].cents);
+        total += entries[e].cents;
+        ++e;
+    }
+    ASSERT_EQ(total, ach.totalCredit());
+}
@@ -0,0 +1,124 @@
+/**
+ * \file BalanceNotifier_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/ledger/BalanceNotifier.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+using namespace accounting::ledger;
+
+namespace
+{
+    //! Collects what a subscriber was sent.
+    struct Received {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int deliveries = 0;
+        Balances balances;
+
+        BalanceNotifier::Listener listener()
+        {
+            return [this](const Balances &b) {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++deliveries;
+                for (auto &entry : b)
+                    balances[entry.first] = entry.second;
+                cv.notify_all();
+            };
+        }
+
+        bool waitFor(int count)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return cv.wait_for(lock, std::chrono::seconds(5), [&] { return deliveries >= count; });
+        }
+    };
+}
+
+// Test case: a burst of changes seen by many subscribers costs one read.
+TEST(BalanceNotifier_tests, coalesces_into_one_read)
+{
+    std::atomic<int> reads(0);
+    BalanceNotifier notifier([&reads](long long, const std::vector<long long> &accounts) {
+        ++reads;
+        Balances b;
+        for (long long a : accounts)
+            b[a] = a * 10.0;
+        return b;
+    }, std::chrono::milliseconds(50));
+
+    Received first, second, other, otherCompany;
+    notifier.subscribe(7, { 1, 2 }, first.listener());
+    notifier.subscribe(7, { 2 }, second.listener());
+    notifier.subscribe(7, { 3 }, other.listener());
+    notifier.subscribe(8, { 1 }, otherCompany.listener());
+
+    for (int i = 0; i < 100; ++i)
+        notifier.changed(7, { 1, 2, 4 });
+
+    ASSERT_TRUE(first.waitFor(1));
+    ASSERT_TRUE(second.waitFor(1));
+
+    ASSERT_EQ(1, reads);
+    ASSERT_EQ(2u, first.balances.size());
+    ASSERT_DOUBLE_EQ(20.0, first.balances[2]);
+    ASSERT_EQ(1u, second.balances.size());
+    ASSERT_EQ(0, other.deliveries);
+    ASSERT_EQ(0, otherCompany.deliveries);
+}
+
+// Test case: nobody watching means no read at all.
+TEST(BalanceNotifier_tests, unsubscribe)
+{
+    std::atomic<int> reads(0);
+    Received received;
+    {
+        BalanceNotifier notifier([&reads](long long, const std::vector<long long> &) {
+            ++reads;
+            return Balances();
+        }, std::chrono::milliseconds(10));
+
+        std::size_t id = notifier.subscribe(7, { 1 }, received.listener());
+        notifier.unsubscribe(id);
+        notifier.changed(7, { 1 });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    ASSERT_EQ(0, reads);
+    ASSERT_EQ(0, received.deliveries);
+}
+
+// Test case: a failed read is retried, and a failing listener doesn't stop the rest.
+TEST(BalanceNotifier_tests, failures)
+{
+    std::atomic<int> reads(0);
+    BalanceNotifier notifier([&reads](long long, const std::vector<long long> &accounts) {
+        if (++reads == 1)
+            throw std::runtime_error("database is locked");
+        Balances b;
+        for (long long a : accounts)
+            b[a] = 1.0;
+        return b;
+    }, std::chrono::milliseconds(10));
+
+    Received received;
+    notifier.subscribe(7, { 1 }, [](const Balances &) { throw std::runtime_error("session is gone"); });
+    notifier.subscribe(7, { 1 }, received.listener());
+    notifier.changed(7, { 1 });
+
+    ASSERT_TRUE(received.waitFor(1));
+    ASSERT_EQ(2, reads);
+    ASSERT_DOUBLE_EQ(1.0, received.balances[1]);
+
+    // Still running
+    notifier.changed(7, { 1 });
+    ASSERT_TRUE(received.waitFor(2));
+}
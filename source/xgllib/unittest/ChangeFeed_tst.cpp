@@ -0,0 +1,186 @@
+/**
+ * \file ChangeFeed_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/ChangeFeed.h"
+#include "accounting/Date.h"
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+namespace
+{
+    JournalEntry rent()
+    {
+        JournalEntry e;
+        e.date = toDays(2021, 3, 9);
+        e.memo = "Rent \"March\"\n";
+        e.lines.push_back(JournalLine{ 6100, 1200, "chk 101" });
+        e.lines.push_back(JournalLine{ 1000, -1100, "" });
+        e.lines.push_back(JournalLine{ 1200, -100, "", Currency("EUR"), -90.5 });
+        return e;
+    }
+
+    payroll::Paycheck check()
+    {
+        payroll::Paycheck check = {};
+        check.employee_id = 7;
+        check.period = 5;
+        check.gross_wages = 2000;
+        check.oasdi_wages = 2000;
+        check.oasdi_employee = 124;
+        check.oasdi_employer = 124;
+        check.futa_wages = 0;
+        return check;
+    }
+
+    //! The changes of one entry, one paycheck and a close, numbered from 1
+    std::vector<Change> feed()
+    {
+        std::vector<Change> changes = Change::posted(42, rent());
+        changes.push_back(Change::paid(toDays(2021, 3, 15), check()));
+        changes.push_back(Change::closed(toDays(2020, 12, 31)));
+        for (std::size_t i = 0; i < changes.size(); ++i)
+            changes[i].sequence = i + 1;
+        return changes;
+    }
+}
+
+TEST(ChangeFeed_tests, posted)
+{
+    std::vector<Change> changes = Change::posted(42, rent());
+
+    // The entry, then the balances it moved in account order.
+    ASSERT_EQ(4u, changes.size());
+    ASSERT_EQ(Change::eJournalEntry, changes[0].kind);
+    ASSERT_EQ(42, changes[0].id);
+    ASSERT_EQ(3u, changes[0].entry.lines.size());
+    ASSERT_EQ(Change::eBalance, changes[1].kind);
+    ASSERT_EQ(1000, changes[1].account_id);
+    ASSERT_DOUBLE_EQ(-1100, changes[1].amount);
+    ASSERT_EQ(1200, changes[2].account_id);
+    ASSERT_EQ(6100, changes[3].account_id);
+    ASSERT_DOUBLE_EQ(1200, changes[3].amount);
+    for (const Change &change : changes)
+        ASSERT_EQ(toDays(2021, 3, 9), change.date);
+
+    // Lines that cancel out don't move the balance.
+    JournalEntry wash = rent();
+    wash.lines.push_back(JournalLine{ 6100, -1200, "" });
+    wash.lines.push_back(JournalLine{ 1000, 1200, "" });
+    changes = Change::posted(43, wash);
+    ASSERT_EQ(3u, changes.size());
+    ASSERT_EQ(1000, changes[1].account_id);
+    ASSERT_DOUBLE_EQ(100, changes[1].amount);
+}
+
+TEST(ChangeFeed_tests, encode)
+{
+    for (const Change &change : feed())
+    {
+        const Change decoded = Change::decode(change.sequence, change.encode());
+        ASSERT_EQ(change.sequence, decoded.sequence);
+        ASSERT_EQ(change.kind, decoded.kind);
+        ASSERT_EQ(change.date, decoded.date);
+        ASSERT_EQ(change.id, decoded.id);
+        ASSERT_EQ(change.entry.memo, decoded.entry.memo);
+        ASSERT_EQ(change.entry.lines.size(), decoded.entry.lines.size());
+        for (std::size_t i = 0; i < change.entry.lines.size(); ++i)
+        {
+            ASSERT_EQ(change.entry.lines[i].account_id, decoded.entry.lines[i].account_id);
+            ASSERT_DOUBLE_EQ(change.entry.lines[i].amount, decoded.entry.lines[i].amount);
+            ASSERT_EQ(change.entry.lines[i].reference, decoded.entry.lines[i].reference);
+            ASSERT_EQ(change.entry.lines[i].currency, decoded.entry.lines[i].currency);
+        }
+        ASSERT_EQ(change.account_id, decoded.account_id);
+        ASSERT_DOUBLE_EQ(change.amount, decoded.amount);
+        ASSERT_EQ(change.paycheck.employee_id, decoded.paycheck.employee_id);
+        ASSERT_DOUBLE_EQ(change.paycheck.oasdi_employee, decoded.paycheck.oasdi_employee);
+    }
+
+    const Change paid = Change::decode(5, Change::paid(toDays(2021, 3, 15), check()).encode());
+    ASSERT_EQ(2021, paid.paycheck.year);
+    ASSERT_EQ(3, paid.paycheck.month);
+    ASSERT_EQ(5, paid.paycheck.period);
+    ASSERT_DOUBLE_EQ(2000, paid.paycheck.gross_wages);
+
+    // Compact: a balance change is a handful of bytes.
+    ASSERT_LE(feed()[1].encode().size(), 10u);
+
+    ASSERT_THROW(Change::decode(1, ""), std::runtime_error);
+    ASSERT_THROW(Change::decode(1, std::string(1, '\x09')), std::runtime_error);
+    std::string truncated = feed()[0].encode();
+    truncated.pop_back();
+    ASSERT_THROW(Change::decode(1, truncated), std::runtime_error);
+    ASSERT_THROW(Change::decode(1, feed()[1].encode() + "x"), std::runtime_error);
+}
+
+TEST(ChangeFeed_tests, ndjson)
+{
+    std::ostringstream out;
+    ChangeWriter writer(out, ChangeWriter::eNdjson);
+    for (const Change &change : feed())
+        writer.write(change);
+    ASSERT_EQ(6u, writer.written());
+
+    std::istringstream in(out.str());
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(in, line))
+        lines.push_back(line);
+    ASSERT_EQ(6u, lines.size());
+
+    ASSERT_EQ("{\"seq\":1,\"kind\":\"journal_entry\",\"date\":\"2021-03-09\",\"id\":42,"
+              "\"memo\":\"Rent \\\"March\\\"\\n\",\"lines\":["
+              "{\"account\":6100,\"amount\":1200,\"reference\":\"chk 101\",\"currency\":\"USD\",\"currency_amount\":1200},"
+              "{\"account\":1000,\"amount\":-1100,\"reference\":\"\",\"currency\":\"USD\",\"currency_amount\":-1100},"
+              "{\"account\":1200,\"amount\":-100,\"reference\":\"\",\"currency\":\"EUR\",\"currency_amount\":-90.5}]}",
+              lines[0]);
+    ASSERT_EQ("{\"seq\":2,\"kind\":\"balance\",\"date\":\"2021-03-09\",\"id\":42,\"account\":1000,\"amount\":-1100}",
+              lines[1]);
+    ASSERT_EQ("{\"seq\":5,\"kind\":\"paycheck\",\"date\":\"2021-03-15\",\"employee\":7,\"period\":5,"
+              "\"gross_wages\":2000,\"oasdi_wages\":2000,\"oasdi_employee\":124,\"oasdi_employer\":124,"
+              "\"futa_wages\":0}",
+              lines[4]);
+    ASSERT_EQ("{\"seq\":6,\"kind\":\"period_closed\",\"date\":\"2020-12-31\"}", lines[5]);
+}
+
+TEST(ChangeFeed_tests, binary)
+{
+    std::vector<Change> changes = feed();
+    changes[5].sequence = 1000000;
+
+    std::stringstream stream;
+    ChangeWriter writer(stream, ChangeWriter::eBinary);
+    for (const Change &change : changes)
+        writer.write(change);
+
+    ChangeReader reader(stream);
+    Change change;
+    for (const Change &expected : changes)
+    {
+        ASSERT_TRUE(reader.read(change));
+        ASSERT_EQ(expected.sequence, change.sequence);
+        ASSERT_EQ(expected.kind, change.kind);
+        ASSERT_EQ(expected.date, change.date);
+    }
+    ASSERT_FALSE(reader.read(change));
+
+    // Cut short mid record
+    const std::string data = stream.str();
+    std::istringstream cut(data.substr(0, data.size() - 1));
+    ChangeReader damaged(cut);
+    for (std::size_t i = 0; i + 1 < changes.size(); ++i)
+        ASSERT_TRUE(damaged.read(change));
+    ASSERT_THROW(damaged.read(change), std::runtime_error);
+
+    std::istringstream notFeed("{\"seq\":1}\n");
+    ASSERT_THROW(ChangeReader{ notFeed }, std::runtime_error);
+}
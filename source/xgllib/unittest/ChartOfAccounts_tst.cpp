@@ -0,0 +1,118 @@
+/**
+ * \file ChartOfAccounts_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/ledger/ChartOfAccounts.h"
+#include <gtest/gtest.h>
+
+using namespace accounting::ledger;
+
+namespace
+{
+    //! Assets -> current assets -> cash -> two bank accounts, plus
+    //! receivables and a liabilities branch.  Deliberately out of order.
+    std::vector<Account> chart()
+    {
+        return {
+            { 1110, 1100, "1110", "Operating account" },
+            { 2000, 0, "2000", "Liabilities" },
+            { 1000, 0, "1000", "Assets" },
+            { 1100, 1010, "1100", "Cash" },
+            { 1010, 1000, "1010", "Current assets" },
+            { 1200, 1010, "1200", "Accounts receivable" },
+            { 1120, 1100, "1120", "Payroll account" },
+            { 2100, 2000, "2100", "Accounts payable" },
+        };
+    }
+}
+
+TEST(ChartOfAccounts_tests, preorder_intervals)
+{
+    ChartOfAccounts c(chart());
+
+    ASSERT_EQ(8u, c.size());
+    const long long order[] = { 1000, 1010, 1100, 1110, 1120, 1200, 2000, 2100 };
+    const int depth[] = { 0, 1, 2, 3, 3, 2, 0, 1 };
+    for (std::size_t p = 0; p < c.size(); ++p)
+    {
+        ASSERT_EQ(order[p], c.at(p).id);
+        ASSERT_EQ(depth[p], c.depth(p));
+        ASSERT_EQ(p, c.position(order[p]));
+    }
+
+    ASSERT_EQ(6u, c.end(c.position(1000)));
+    ASSERT_EQ(5u, c.end(c.position(1100)));
+    ASSERT_EQ(4u, c.end(c.position(1110)));
+
+    ASSERT_TRUE(c.contains(1000, 1120));
+    ASSERT_TRUE(c.contains(1100, 1100));
+    ASSERT_FALSE(c.contains(1100, 1200));
+    ASSERT_FALSE(c.contains(2000, 1110));
+    ASSERT_THROW(c.position(9999), std::out_of_range);
+}
+
+TEST(ChartOfAccounts_tests, bad_charts)
+{
+    std::vector<Account> unknownParent = { { 1, 0, "1", "" }, { 2, 3, "2", "" } };
+    ASSERT_THROW(ChartOfAccounts c(unknownParent), std::invalid_argument);
+
+    std::vector<Account> duplicate = { { 1, 0, "1", "" }, { 1, 0, "2", "" } };
+    ASSERT_THROW(ChartOfAccounts c(duplicate), std::invalid_argument);
+
+    std::vector<Account> cycle = { { 1, 0, "1", "" }, { 2, 3, "2", "" }, { 3, 2, "3", "" } };
+    ASSERT_THROW(ChartOfAccounts c(cycle), std::invalid_argument);
+}
+
+TEST(ChartOfAccounts_tests, rollups)
+{
+    ChartOfAccounts c(chart());
+    Balances balances = {
+        { 1110, 1500.10 },
+        { 1120, 250.20 },
+        { 1100, 0.01 },         // posted to the parent directly
+        { 1200, 900 },
+        { 2100, -1200.55 },
+        { 4000, 123 },          // not in the chart
+    };
+    Rollup r(c, balances);
+
+    ASSERT_DOUBLE_EQ(2650.31, r.total(1000));
+    ASSERT_DOUBLE_EQ(2650.31, r.total(1010));
+    ASSERT_DOUBLE_EQ(1750.31, r.total(1100));
+    ASSERT_DOUBLE_EQ(0.01, r.balanceAt(c.position(1100)));
+    ASSERT_DOUBLE_EQ(250.20, r.total(1120));
+    ASSERT_DOUBLE_EQ(-1200.55, r.total(2000));
+    ASSERT_DOUBLE_EQ(0, Rollup(c, Balances()).total(1000));
+}
+
+// Test case: a deep, wide chart; every rollup matches summing the subtree.
+TEST(ChartOfAccounts_tests, deep_chart)
+{
+    std::vector<Account> accounts;
+    Balances balances;
+    for (long long id = 1; id <= 20000; ++id)
+    {
+        // A long chain down the first 5000, then a bushy tree.
+        const long long parent = id == 1 ? 0 : id <= 5000 ? id - 1 : id / 4;
+        accounts.push_back(Account{ id, parent, std::to_string(id), "" });
+        balances[id] = (id % 7) * 1.01;
+    }
+
+    ChartOfAccounts c(accounts);
+    Rollup r(c, balances);
+
+    for (long long id : { 1LL, 2500LL, 5000LL, 5001LL, 12345LL })
+    {
+        double expected = 0;
+        for (const Account &a : accounts)
+        {
+            if (c.contains(id, a.id))
+                expected += balances[a.id];
+        }
+        ASSERT_NEAR(expected, r.total(id), 0.001);
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * \file EmployeeStore_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/payroll/EmployeeStore.h"
+#include "accounting/payroll/PayrollRun.h"
+#include <gtest/gtest.h>
+
+using namespace accounting::payroll;
+
+TEST(EmployeeStore_tests, add_and_read_back)
+{
+    EmployeeStore store;
+    std::size_t i = store.add(Employee{ 42, 65000, PayPeriod::ePayPeriodSemimonthly }, 1600, 100, 200);
+
+    ASSERT_EQ(0u, i);
+    ASSERT_EQ(1u, store.size());
+    ASSERT_EQ(42, store.employee(0).id);
+    ASSERT_DOUBLE_EQ(65000, store.employee(0).annual_wage);
+    ASSERT_EQ(PayPeriod::ePayPeriodSemimonthly, store.payPeriod(0));
+    ASSERT_DOUBLE_EQ(1600, store.ytdOasdiWages()[0]);
+    ASSERT_DOUBLE_EQ(100, store.ytdOasdi()[0]);
+    ASSERT_DOUBLE_EQ(200, store.ytdFutaWages()[0]);
+}
+
+// Test case: a million employees fit in a few tens of megabytes.
+TEST(EmployeeStore_tests, memory_per_employee)
+{
+    const std::size_t employees = 1000000;
+
+    EmployeeStore store;
+    store.reserve(employees);
+    for (std::size_t i = 0; i < employees; ++i)
+        store.add(Employee{ (long long)i, 50000, PayPeriod::ePayPeriodBiweekly });
+
+    ASSERT_EQ(41u * employees, store.memoryUsage());
+}
+
+// Test case: paying from the store matches paying from a roster, and
+// carries the year to date totals forward in place.
+TEST(EmployeeStore_tests, payroll_run_over_store)
+{
+    Roster roster;
+    EmployeeStore store;
+    for (long long i = 0; i < 50; ++i)
+    {
+        Employee e{ i, 40000.0 + 5000 * i, PayPeriod::ePayPeriodMonthly };
+        roster.push_back(e);
+        store.add(e);
+    }
+
+    std::vector<YearToDate> ytd(roster.size());
+    for (int period = 0; period < 12; ++period)
+    {
+        PayrollRun fromRoster(2020, period + 1, period, roster.size());
+        fromRoster.pay(roster, ytd);
+
+        PayrollRun fromStore(2020, period + 1, period, store.size());
+        fromStore.pay(store);
+
+        for (std::size_t i = 0; i < roster.size(); ++i)
+        {
+            ASSERT_DOUBLE_EQ(fromRoster.paychecks()[i].gross_wages, fromStore.paychecks()[i].gross_wages);
+            ASSERT_NEAR(fromRoster.paychecks()[i].oasdi_employee, fromStore.paychecks()[i].oasdi_employee, 1e-6);
+            ASSERT_NEAR(fromRoster.paychecks()[i].oasdi_employer, fromStore.paychecks()[i].oasdi_employer, 1e-6);
+            ASSERT_NEAR(fromRoster.paychecks()[i].futa_wages, fromStore.paychecks()[i].futa_wages, 1e-6);
+        }
+    }
+
+    for (std::size_t i = 0; i < roster.size(); ++i)
+    {
+        ASSERT_NEAR(ytd[i].oasdi_wages, store.ytdOasdiWages()[i], 1e-6);
+        ASSERT_NEAR(ytd[i].oasdi_employee, store.ytdOasdi()[i], 1e-6);
+        ASSERT_NEAR(ytd[i].futa_wages, store.ytdFutaWages()[i], 1e-6);
+    }
+}
+
+// Test case: the store carries the taxable wages themselves, so a high
+// earner stops at the wage base exactly, and a zero rate is no trouble.
+TEST(EmployeeStore_tests, oasdi_wage_base)
+{
+    PayrollTaxes taxes;
+    taxes.oasdi.fy2020();
+
+    EmployeeStore store;
+    store.add(Employee{ 1, 260000, PayPeriod::ePayPeriodMonthly });
+
+    for (int period = 0; period < 12; ++period)
+    {
+        PayrollRun run(2020, period + 1, period, store.size(), taxes);
+        run.pay(store);
+    }
+    ASSERT_DOUBLE_EQ(137700, store.ytdOasdiWages()[0]);
+
+    taxes.oasdi.employee_tax_rate = 0;
+    EmployeeStore untaxed;
+    untaxed.add(Employee{ 2, 60000, PayPeriod::ePayPeriodMonthly });
+    for (int period = 0; period < 2; ++period)
+    {
+        PayrollRun run(2020, period + 1, period, untaxed.size(), taxes);
+        run.pay(untaxed);
+    }
+    ASSERT_DOUBLE_EQ(10000, untaxed.ytdOasdiWages()[0]);
+    ASSERT_DOUBLE_EQ(0, untaxed.ytdOasdi()[0]);
+}
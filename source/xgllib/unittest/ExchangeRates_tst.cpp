@@ -0,0 +1,75 @@
+/**
+ * \file ExchangeRates_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Currency.h"
+#include "accounting/Date.h"
+#include "accounting/ledger/ExchangeRates.h"
+#include <gtest/gtest.h>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+namespace
+{
+    const Currency EUR("EUR");
+    const Currency GBP("GBP");
+}
+
+TEST(Currency_tests, codes)
+{
+    ASSERT_EQ("EUR", EUR.code());
+    ASSERT_EQ(Currency("EUR"), EUR);
+    ASSERT_NE(EUR, GBP);
+    ASSERT_NE(std::hash<Currency>()(EUR), std::hash<Currency>()(GBP));
+    ASSERT_THROW(Currency("eur"), std::invalid_argument);
+    ASSERT_THROW(Currency("EURO"), std::invalid_argument);
+}
+
+// Test case: days without a rate carry the last published one.
+TEST(ExchangeRates_tests, carry_forward)
+{
+    const int fri = toDays(2021, 1, 8);
+
+    ExchangeRates rates;
+    rates.set(EUR, fri, 1.22);
+    rates.set(EUR, fri + 3, 1.21);
+
+    ASSERT_DOUBLE_EQ(1.22, rates.rate(EUR, fri));
+    ASSERT_DOUBLE_EQ(1.22, rates.rate(EUR, fri + 2));
+    ASSERT_DOUBLE_EQ(1.21, rates.rate(EUR, fri + 3));
+    ASSERT_DOUBLE_EQ(1.21, rates.rate(EUR, fri + 30));
+    ASSERT_THROW(rates.rate(EUR, fri - 1), std::out_of_range);
+    ASSERT_THROW(rates.rate(GBP, fri), std::out_of_range);
+    ASSERT_DOUBLE_EQ(1, rates.rate(USD, fri));
+
+    // A late correction carries up to the next published day only.
+    rates.set(EUR, fri + 1, 1.25);
+    ASSERT_DOUBLE_EQ(1.22, rates.rate(EUR, fri));
+    ASSERT_DOUBLE_EQ(1.25, rates.rate(EUR, fri + 2));
+    ASSERT_DOUBLE_EQ(1.21, rates.rate(EUR, fri + 3));
+
+    // As does an earlier rate.
+    rates.set(EUR, fri - 7, 1.20);
+    ASSERT_DOUBLE_EQ(1.20, rates.rate(EUR, fri - 1));
+    ASSERT_DOUBLE_EQ(1.22, rates.rate(EUR, fri));
+}
+
+TEST(ExchangeRates_tests, cross_rates)
+{
+    const int day = toDays(2021, 3, 31);
+
+    ExchangeRates rates;
+    rates.set(EUR, day, 1.2);
+    rates.set(GBP, day, 1.5);
+
+    ASSERT_DOUBLE_EQ(1.25, rates.rate(GBP, EUR, day));
+    Money converted = rates.convert(Money{ 100, EUR }, GBP, day);
+    ASSERT_DOUBLE_EQ(80, converted.amount);
+    ASSERT_EQ(GBP, converted.currency);
+    ASSERT_DOUBLE_EQ(120, rates.convert(Money{ 100, EUR }, USD, day).amount);
+}
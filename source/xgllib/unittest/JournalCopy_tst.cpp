@@ -0,0 +1,64 @@
+/**
+ * \file JournalCopy_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "db/JournalCopy.h"
+#include <gtest/gtest.h>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+TEST(JournalCopy_tests, entry_row)
+{
+    JournalEntry e;
+    e.date = toDays(2021, 3, 9);
+    e.memo = "Rent";
+
+    std::string rows;
+    db::JournalCopy::entryRow(rows, 42, e);
+    ASSERT_EQ("42\t0\t2021-03-09\tRent\n", rows);
+
+    // Rows append.
+    e.memo = "";
+    db::JournalCopy::entryRow(rows, 43, e);
+    ASSERT_EQ("42\t0\t2021-03-09\tRent\n43\t0\t2021-03-09\t\n", rows);
+}
+
+TEST(JournalCopy_tests, escaping)
+{
+    JournalEntry e;
+    e.date = toDays(2021, 3, 9);
+    e.memo = "a\\b\tc\nd\re";
+
+    std::string rows;
+    db::JournalCopy::entryRow(rows, 1, e);
+    ASSERT_EQ("1\t0\t2021-03-09\ta\\\\b\\tc\\nd\\re\n", rows);
+}
+
+TEST(JournalCopy_tests, line_row)
+{
+    std::string rows;
+    db::JournalCopy::lineRow(rows, 7, 42, JournalLine{ 1000, -1234.5, "chk\t101" });
+    ASSERT_EQ("7\t0\t42\t1000\t-1234.5\tchk\\t101\tUSD\t-1234.5\n", rows);
+
+    // Foreign lines keep the transaction amount; USD lines repeat the amount.
+    rows.clear();
+    db::JournalCopy::lineRow(rows, 8, 42, JournalLine{ 1200, 110.25, "", Currency("EUR"), 100 });
+    ASSERT_EQ("8\t0\t42\t1200\t110.25\t\tEUR\t100\n", rows);
+
+    rows.clear();
+    db::JournalCopy::lineRow(rows, 9, 42, JournalLine{ 1200, 0.1, "", USD, 99 });
+    ASSERT_EQ("9\t0\t42\t1200\t0.1\t\tUSD\t0.1\n", rows);
+}
+
+TEST(JournalCopy_tests, change_row)
+{
+    std::string rows;
+    db::JournalCopy::changeRow(rows, 12, std::string("\x01\xff\\", 3));
+    ASSERT_EQ("12\t0\t\\\\x01ff5c\n", rows);
+}
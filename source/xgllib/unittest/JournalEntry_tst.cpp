@@ -0,0 +1,42 @@
+/**
+ * \file JournalEntry_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "accounting/ledger/JournalEntry.h"
+#include <gtest/gtest.h>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+TEST(Date_tests, day_numbers)
+{
+    ASSERT_EQ(0, toDays(1970, 1, 1));
+    ASSERT_EQ(18262, toDays(2020, 1, 1));
+    ASSERT_EQ(toDays(2020, 2, 28) + 2, toDays(2020, 3, 1));
+
+    int y, m, d;
+    for (int days = toDays(1999, 12, 1); days < toDays(2001, 3, 1); ++days)
+    {
+        fromDays(days, y, m, d);
+        ASSERT_EQ(days, toDays(y, m, d));
+    }
+}
+
+TEST(JournalEntry_tests, balanced)
+{
+    JournalEntry e;
+    e.date = toDays(2020, 6, 30);
+    ASSERT_FALSE(e.balanced());
+
+    e.lines.push_back(JournalLine{ 1000, 250.00, "" });
+    ASSERT_FALSE(e.balanced());
+
+    e.lines.push_back(JournalLine{ 4000, -200.00, "" });
+    e.lines.push_back(JournalLine{ 2100, -50.00, "" });
+    ASSERT_TRUE(e.balanced());
+}
@@ -0,0 +1,181 @@
+/**
+ * \file LedgerState_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/LedgerState.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+using namespace accounting;
+
+namespace
+{
+    std::string tempFile(const char *name)
+    {
+        return ::testing::TempDir() + name;
+    }
+
+    //! A paycheck; \p wages are both its OASDI and its FUTA taxable wages
+    payroll::Paycheck check(long long employee, int year, double oasdi, double wages)
+    {
+        payroll::Paycheck check = {};
+        check.employee_id = employee;
+        check.year = year;
+        check.month = 1;
+        check.oasdi_employee = oasdi;
+        check.oasdi_wages = wages;
+        check.futa_wages = wages;
+        return check;
+    }
+}
+
+TEST(LedgerState_tests, running_totals)
+{
+    LedgerState state;
+    ASSERT_EQ(0, state.lastLine());
+    ASSERT_EQ(0, state.lastPaycheck());
+    ASSERT_EQ(INT_MIN, state.closedThrough());
+
+    state.post(1, 1000, 100.10);
+    state.post(2, 4000, -100.10);
+    state.post(5, 1000, 0.20);
+    state.post(4, 4000, -0.20);
+    ASSERT_EQ(5, state.lastLine());
+    ASSERT_EQ(2u, state.accounts());
+    ASSERT_DOUBLE_EQ(100.30, state.balance(1000));
+    ASSERT_DOUBLE_EQ(-100.30, state.balance(4000));
+    ASSERT_DOUBLE_EQ(0, state.balance(2100));
+
+    ledger::Balances balances = state.balances({ 1000, 2100 });
+    ASSERT_EQ(2u, balances.size());
+    ASSERT_DOUBLE_EQ(100.30, balances[1000]);
+    ASSERT_DOUBLE_EQ(0, balances[2100]);
+
+    state.pay(7, check(1, 2021, 62, 1000));
+    state.pay(8, check(1, 2021, 62, 1000));
+    state.pay(9, check(1, 2022, 62, 1000));
+    state.pay(3, check(2, 2021, 31, 500));
+    ASSERT_EQ(9, state.lastPaycheck());
+    ASSERT_DOUBLE_EQ(2000, state.yearToDate(1, 2021).oasdi_wages);
+    ASSERT_DOUBLE_EQ(124, state.yearToDate(1, 2021).oasdi_employee);
+    ASSERT_DOUBLE_EQ(2000, state.yearToDate(1, 2021).futa_wages);
+    ASSERT_DOUBLE_EQ(62, state.yearToDate(1, 2022).oasdi_employee);
+    ASSERT_DOUBLE_EQ(0, state.yearToDate(3, 2021).oasdi_employee);
+
+    state.clearYear(2021);
+    ASSERT_DOUBLE_EQ(0, state.yearToDate(1, 2021).oasdi_employee);
+    ASSERT_DOUBLE_EQ(0, state.yearToDate(2, 2021).futa_wages);
+    ASSERT_DOUBLE_EQ(62, state.yearToDate(1, 2022).oasdi_employee);
+    ASSERT_EQ(9, state.lastPaycheck());
+}
+
+TEST(LedgerState_tests, checkpoint)
+{
+    const std::string file = tempFile("state.checkpoint");
+
+    LedgerState state;
+    long long id = 0;
+    for (long long account = 1; account <= 2000; ++account)
+    {
+        state.post(++id, account, account * 1.01);
+        state.post(++id, 9999, -account * 1.01);
+    }
+    for (long long employee = 1; employee <= 500; ++employee)
+        state.pay(employee, check(employee, 2021, employee * 0.5, employee));
+    state.closedThrough(18627);
+    state.checkpoint(file);
+
+    const LedgerState read(file);
+    ASSERT_EQ(state.lastLine(), read.lastLine());
+    ASSERT_EQ(state.lastPaycheck(), read.lastPaycheck());
+    ASSERT_EQ(18627, read.closedThrough());
+    ASSERT_EQ(state.accounts(), read.accounts());
+    for (long long account = 1; account <= 2000; ++account)
+        ASSERT_DOUBLE_EQ(state.balance(account), read.balance(account));
+    ASSERT_DOUBLE_EQ(state.balance(9999), read.balance(9999));
+    for (long long employee = 1; employee <= 500; ++employee)
+    {
+        ASSERT_DOUBLE_EQ(employee, read.yearToDate(employee, 2021).oasdi_wages);
+        ASSERT_DOUBLE_EQ(employee * 0.5, read.yearToDate(employee, 2021).oasdi_employee);
+        ASSERT_DOUBLE_EQ(employee, read.yearToDate(employee, 2021).futa_wages);
+    }
+
+    // An empty state checkpoints too.
+    LedgerState().checkpoint(file);
+    const LedgerState empty(file);
+    ASSERT_EQ(0u, empty.accounts());
+    ASSERT_EQ(INT_MIN, empty.closedThrough());
+
+    std::remove(file.c_str());
+}
+
+TEST(LedgerState_tests, damaged)
+{
+    const std::string file = tempFile("damaged.checkpoint");
+    ASSERT_THROW(LedgerState(tempFile("missing.checkpoint")), std::runtime_error);
+
+    LedgerState state;
+    state.post(1, 1000, 12.34);
+    state.checkpoint(file);
+
+    std::string data;
+    {
+        std::ifstream in(file, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // A flipped bit in a balance
+    std::string flipped = data;
+    flipped[flipped.size() - 1] ^= 1;
+    std::ofstream(file, std::ios::binary) << flipped;
+    ASSERT_THROW(LedgerState{ file }, std::runtime_error);
+
+    // A flipped bit in the header: the last line taken in
+    flipped = data;
+    flipped[8] ^= 1;
+    std::ofstream(file, std::ios::binary) << flipped;
+    ASSERT_THROW(LedgerState{ file }, std::runtime_error);
+
+    // Cut short
+    std::ofstream(file, std::ios::binary) << data.substr(0, data.size() - 4);
+    ASSERT_THROW(LedgerState{ file }, std::runtime_error);
+
+    // Not a checkpoint
+    std::ofstream(file, std::ios::binary) << "XGLA";
+    ASSERT_THROW(LedgerState{ file }, std::runtime_error);
+
+    std::remove(file.c_str());
+}
+
+TEST(LedgerState_tests, load_time)
+{
+    // Loading a checkpoint costs the size of the state, not of the
+    // history behind it: a million postings to a thousand accounts.
+    const std::string file = tempFile("history.checkpoint");
+
+    LedgerState state;
+    for (long long id = 1; id <= 1000000; ++id)
+        state.post(id, 1000 + id % 1000, 1.25);
+    state.checkpoint(file);
+
+    const auto start = std::chrono::steady_clock::now();
+    const LedgerState read(file);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(1000000, read.lastLine());
+    ASSERT_DOUBLE_EQ(1250, read.balance(1000));
+
+    // Timing is reported, not asserted; it depends on the machine.
+    RecordProperty("load_us", static_cast<int>(elapsed.count() * 1e6));
+
+    std::remove(file.c_str());
+}
@@ -0,0 +1,68 @@
+/**
+ * \file MpscQueue_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "util/MpscQueue.h"
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace util;
+
+TEST(MpscQueue_tests, fifo_single_producer)
+{
+    MpscQueue<int> q;
+    ASSERT_TRUE(q.empty());
+
+    for (int i = 0; i < 10; ++i)
+        q.push(i);
+
+    int value;
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(q.pop(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_FALSE(q.pop(value));
+    ASSERT_TRUE(q.empty());
+}
+
+// Test case: every item from every producer arrives exactly once, and each
+// producer's items arrive in the order it pushed them.
+TEST(MpscQueue_tests, many_producers)
+{
+    const int producers = 8;
+    const int items = 20000;
+
+    MpscQueue<std::pair<int, int>> q;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&q, p]() {
+            for (int i = 0; i < items; ++i)
+                q.push(std::make_pair(p, i));
+        });
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    std::pair<int, int> item;
+    while (received < producers * items)
+    {
+        if (!q.pop(item))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(next[item.first], item.second);
+        ++next[item.first];
+        ++received;
+    }
+
+    for (auto &t : threads)
+        t.join();
+    ASSERT_TRUE(q.empty());
+}
@@ -0,0 +1,41 @@
+/**
+ * \file PayrollRun_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/payroll/PayrollRun.h"
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+using namespace accounting::payroll;
+
+namespace
+{
+    Roster roster(std::size_t employees)
+    {
+        Roster r;
+        for (std::size_t i = 0; i < employees; ++i)
+            r.push_back(Employee{ (long long)i, 30000.0 + i, PayPeriod::ePayPeriodBiweekly });
+        return r;
+    }
+}
+
+TEST(PayrollRun_tests, pay_roster)
+{
+    Roster r = roster(10);
+    std::vector<YearToDate> ytd(r.size());
+
+    PayrollRun run(2020, 1, 0, r.size());
+    run.pay(r, ytd);
+
+    ASSERT_EQ(10u, run.paychecks().size());
+    ASSERT_EQ(3, run.paychecks()[3].employee_id);
+    ASSERT_DOUBLE_EQ(30003.0 / 26, run.paychecks()[3].gross_wages);
+    ASSERT_DOUBLE_EQ(30003.0 / 26, ytd[3].gross_wages);
+    ASSERT_DOUBLE_EQ(30003.0 / 26 * 0.062, run.paychecks()[3].oasdi_employee);
+}
+
@@ -0,0 +1,251 @@
+/**
+ * \file PeriodArchive_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "accounting/PeriodArchive.h"
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+using namespace accounting;
+
+namespace
+{
+    const Currency EUR("EUR");
+
+    std::string tempFile(const char *name)
+    {
+        return ::testing::TempDir() + name;
+    }
+
+    std::string slurp(const std::string &file)
+    {
+        std::ifstream in(file, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    //! A year of books: daily entries between four accounts, one in euros,
+    //! and biweekly paychecks for a small staff.  Added out of order.
+    PeriodArchive year2020()
+    {
+        PeriodArchive archive(toDays(2020, 1, 1), toDays(2020, 12, 31));
+
+        long long lineId = 1000;
+        for (int d = 365; d >= 0; --d)
+        {
+            const long long entryId = 500 + d;
+            const int date = toDays(2020, 1, 1) + d;
+            archive.add(ArchivedEntry{ entryId, date, "Sales " + std::to_string(d) });
+
+            const double amount = 10 + d * 0.37;
+            archive.add(ArchivedLine{ lineId++, entryId, date, { 1110, amount, d % 7 ? "" : "DEP" + std::to_string(d) } });
+            archive.add(ArchivedLine{ lineId++, entryId, date, { 4000, -amount, "" } });
+            if (d % 30 == 0)
+            {
+                archive.add(ArchivedLine{ lineId++, entryId, date, { 1150, 110.00, "", EUR, 100.00 } });
+                archive.add(ArchivedLine{ lineId++, entryId, date, { 1110, -110.00, "" } });
+            }
+        }
+
+        for (long long employee = 1; employee <= 20; ++employee)
+        {
+            for (int period = 0; period < 26; ++period)
+            {
+                const int payDate = toDays(2020, 1, 10) + 14 * period;
+                payroll::Paycheck check{};
+                int day;
+                fromDays(payDate, check.year, check.month, day);
+                check.employee_id = employee * 3;
+                check.period = period;
+                check.gross_wages = 1000 + employee * 12.34;
+                check.oasdi_wages = check.gross_wages;
+                check.oasdi_employee = std::round(check.gross_wages * 6.2) / 100;
+                check.oasdi_employer = check.oasdi_employee;
+                check.futa_wages = period < 3 ? check.gross_wages : 0;
+                archive.add(ArchivedPaycheck{ payDate, check });
+            }
+        }
+        return archive;
+    }
+}
+
+TEST(PeriodArchive_tests, round_trip)
+{
+    PeriodArchive original = year2020();
+    const std::string file = tempFile("round_trip.xgla");
+    original.write(file);
+    PeriodArchive archive(file);
+
+    ASSERT_EQ(original.first(), archive.first());
+    ASSERT_EQ(original.last(), archive.last());
+    ASSERT_EQ(original.entries(), archive.entries());
+    ASSERT_EQ(original.lines(), archive.lines());
+    ASSERT_EQ(original.paychecks(), archive.paychecks());
+
+    // Read back in date order; every row is there, unchanged.
+    for (std::size_t i = 0; i < archive.entries(); ++i)
+    {
+        const ArchivedEntry e = archive.entry(i);
+        ASSERT_EQ(500 + i, e.id);
+        ASSERT_EQ(toDays(2020, 1, 1) + (int)i, e.date);
+        ASSERT_EQ("Sales " + std::to_string(i), e.memo);
+    }
+
+    std::map<long long, ArchivedLine> lines;
+    for (std::size_t i = 0; i < original.lines(); ++i)
+        lines.emplace(original.line(i).id, original.line(i));
+    for (std::size_t i = 0; i < archive.lines(); ++i)
+    {
+        const ArchivedLine l = archive.line(i);
+        if (i > 0)
+        {
+            ASSERT_LE(archive.line(i - 1).date, l.date);
+        }
+        const ArchivedLine &o = lines.at(l.id);
+        ASSERT_EQ(o.entry_id, l.entry_id);
+        ASSERT_EQ(o.date, l.date);
+        ASSERT_EQ(o.line.account_id, l.line.account_id);
+        ASSERT_DOUBLE_EQ(o.line.amount, l.line.amount);
+        ASSERT_EQ(o.line.reference, l.line.reference);
+        ASSERT_EQ(o.line.currency, l.line.currency);
+        if (l.line.currency != USD)
+        {
+            ASSERT_DOUBLE_EQ(o.line.currency_amount, l.line.currency_amount);
+        }
+    }
+
+    std::map<std::pair<long long, int>, ArchivedPaycheck> checks;
+    for (std::size_t i = 0; i < original.paychecks(); ++i)
+        checks.emplace(std::make_pair(original.paycheck(i).check.employee_id, original.paycheck(i).pay_date),
+                       original.paycheck(i));
+    for (std::size_t i = 0; i < archive.paychecks(); ++i)
+    {
+        const ArchivedPaycheck &p = archive.paycheck(i);
+        const ArchivedPaycheck &o = checks.at(std::make_pair(p.check.employee_id, p.pay_date));
+        ASSERT_EQ(o.check.year, p.check.year);
+        ASSERT_EQ(o.check.month, p.check.month);
+        ASSERT_EQ(o.check.period, p.check.period);
+        ASSERT_DOUBLE_EQ(o.check.gross_wages, p.check.gross_wages);
+        ASSERT_DOUBLE_EQ(o.check.oasdi_wages, p.check.oasdi_wages);
+        ASSERT_DOUBLE_EQ(o.check.oasdi_employee, p.check.oasdi_employee);
+        ASSERT_DOUBLE_EQ(o.check.oasdi_employer, p.check.oasdi_employer);
+        ASSERT_DOUBLE_EQ(o.check.futa_wages, p.check.futa_wages);
+    }
+
+    std::remove(file.c_str());
+}
+
+// Test case: the columns encode small.  A paycheck that repeats the last
+// one takes about a byte a field, and a journal line about a byte a field
+// plus its amount and reference; a fifth of their size in fixed width
+// fields.
+TEST(PeriodArchive_tests, compact)
+{
+    PeriodArchive archive = year2020();
+    const std::string file = tempFile("compact.xgla");
+    archive.write(file);
+
+    std::size_t text = 0;
+    for (std::size_t i = 0; i < archive.entries(); ++i)
+        text += archive.entry(i).memo.size();
+    for (std::size_t i = 0; i < archive.lines(); ++i)
+        text += archive.line(i).line.reference.size();
+
+    const std::size_t size = slurp(file).size();
+    ASSERT_LT(size, text + archive.entries() * 3 + archive.lines() * 10 + archive.paychecks() * 10);
+
+    std::remove(file.c_str());
+}
+
+TEST(PeriodArchive_tests, queries)
+{
+    PeriodArchive built = year2020();
+    const std::string file = tempFile("queries.xgla");
+    built.write(file);
+    PeriodArchive archive(file);
+
+    // Balances as of a day agree with adding up the lines.
+    for (int date : { toDays(2019, 12, 31), toDays(2020, 1, 1), toDays(2020, 6, 30), toDays(2020, 12, 31),
+                      toDays(2021, 3, 1) })
+    {
+        ledger::Balances expected;
+        for (std::size_t i = 0; i < archive.lines(); ++i)
+        {
+            if (archive.line(i).date <= date)
+                expected[archive.line(i).line.account_id] += archive.line(i).line.amount;
+        }
+
+        ledger::Balances balances;
+        archive.addBalances(balances, date);
+        ASSERT_EQ(expected.size(), balances.size());
+        for (const auto &b : expected)
+            ASSERT_NEAR(b.second, balances.at(b.first), 0.005);
+    }
+
+    // Added to what's there already.
+    ledger::Balances balances{ { 1110, 1.00 }, { 9999, 5.00 } };
+    archive.addBalances(balances, std::vector<long long>{ 1110, 4000, 9999, 7777 });
+    ledger::Balances all;
+    archive.addBalances(all, archive.last());
+    ASSERT_NEAR(all[1110] + 1.00, balances[1110], 0.005);
+    ASSERT_NEAR(all[4000], balances[4000], 0.005);
+    ASSERT_EQ(5.00, balances[9999]);
+    ASSERT_EQ(0u, balances.count(7777));
+
+    std::vector<ledger::CashLine> lines;
+    archive.addAccountLines(lines, 1110, toDays(2020, 1, 1), toDays(2020, 1, 31));
+    ASSERT_EQ(31u + 2, lines.size());
+    ASSERT_EQ(toDays(2020, 1, 1), lines.front().date);
+    ASSERT_EQ("DEP0", lines.front().reference);
+    ASSERT_DOUBLE_EQ(-110.00, lines[1].amount);
+    for (std::size_t i = 1; i < lines.size(); ++i)
+        ASSERT_TRUE(lines[i - 1].date < lines[i].date ||
+                    (lines[i - 1].date == lines[i].date && lines[i - 1].id < lines[i].id));
+    lines.clear();
+    archive.addAccountLines(lines, 1110, toDays(2021, 1, 1), toDays(2021, 12, 31));
+    ASSERT_TRUE(lines.empty());
+
+    std::vector<ledger::ForeignBalance> foreign = archive.foreignBalances(toDays(2020, 2, 15));
+    ASSERT_EQ(1u, foreign.size());
+    ASSERT_EQ(1150, foreign[0].account_id);
+    ASSERT_EQ(EUR, foreign[0].currency);
+    ASSERT_DOUBLE_EQ(200.00, foreign[0].currency_balance);
+    ASSERT_DOUBLE_EQ(220.00, foreign[0].book_balance);
+
+    std::vector<payroll::Paycheck> history;
+    archive.addPaychecks(history, 2020);
+    ASSERT_EQ(20u * 26, history.size());
+    archive.addPaychecks(history, 2019);
+    ASSERT_EQ(20u * 26, history.size());
+
+    std::remove(file.c_str());
+}
+
+TEST(PeriodArchive_tests, damaged)
+{
+    const std::string file = tempFile("damaged.xgla");
+    year2020().write(file);
+    std::string data = slurp(file);
+
+    ASSERT_THROW(PeriodArchive(tempFile("missing.xgla")), std::runtime_error);
+
+    std::string flipped = data;
+    flipped[data.size() / 2] ^= 0x10;
+    std::ofstream(file, std::ios::binary | std::ios::trunc) << flipped;
+    ASSERT_THROW(PeriodArchive{ file }, std::runtime_error);
+
+    std::ofstream(file, std::ios::binary | std::ios::trunc) << data.substr(0, data.size() - 20);
+    ASSERT_THROW(PeriodArchive{ file }, std::runtime_error);
+
+    std::ofstream(file, std::ios::binary | std::ios::trunc) << "not an archive at all";
+    ASSERT_THROW(PeriodArchive{ file }, std::runtime_error);
+
+    std::remove(file.c_str());
+}
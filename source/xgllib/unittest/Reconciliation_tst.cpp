@@ -0,0 +1,192 @@
+/**
+ * \file Reconciliation_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "accounting/ledger/Reconciliation.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+namespace
+{
+    const int JAN1 = toDays(2020, 1, 1);
+
+    CashLine line(long long id, int date, double amount, const std::string &reference = std::string())
+    {
+        return CashLine{ id, date, amount, reference };
+    }
+
+    //! A year of statement lines, cleared by the bank up to two days after
+    //! posting, against the ledger.  Every 50th ledger line is cleared
+    //! with a different reference.
+    void year(std::size_t perDay, std::vector<CashLine> &statement, std::vector<CashLine> &ledger)
+    {
+        long long id = 0;
+        for (int day = 0; day < 365; ++day)
+        {
+            for (std::size_t i = 0; i < perDay; ++i, ++id)
+            {
+                const double amount = ((id * 7919) % 100000) / 100.0 + 1;
+                const std::string reference = "REF" + std::to_string(id);
+                ledger.push_back(line(id, JAN1 + day, amount, reference));
+                statement.push_back(line(id + 1, JAN1 + day + id % 3, amount, id % 50 ? reference : "X"));
+            }
+        }
+    }
+}
+
+TEST(Reconciliation_tests, exact_and_amount_date)
+{
+    std::vector<CashLine> statement = {
+        line(1, JAN1, 100, "CHK1001"),
+        line(2, JAN1, 100, "CHK1002"),
+        line(3, JAN1 + 1, -25.5, "BANK"),
+    };
+    std::vector<CashLine> ledger = {
+        line(10, JAN1, 100, "CHK1002"),
+        line(11, JAN1, 100, "CHK1001"),
+        line(12, JAN1 + 1, -25.5),
+    };
+
+    Reconciliation r;
+    r.reconcile(statement, ledger, 1);
+
+    ASSERT_EQ(2u, r.count(ReconciliationMatch::eMatchExact));
+    ASSERT_EQ(1u, r.count(ReconciliationMatch::eMatchAmountDate));
+    ASSERT_EQ(11, r.matches()[0].ledger[0]);
+    ASSERT_EQ(10, r.matches()[1].ledger[0]);
+    ASSERT_EQ(3, r.matches()[2].statement[0]);
+    ASSERT_TRUE(r.unmatchedStatement().empty());
+    ASSERT_TRUE(r.unmatchedLedger().empty());
+}
+
+// Test case: nearest date within the tolerance, and no further.
+TEST(Reconciliation_tests, date_window)
+{
+    std::vector<CashLine> statement = {
+        line(1, JAN1 + 3, 50),
+        line(2, JAN1 + 20, 75),
+    };
+    std::vector<CashLine> ledger = {
+        line(10, JAN1, 50),
+        line(11, JAN1 + 2, 50),
+        line(12, JAN1 + 16, 75),
+    };
+
+    Reconciliation r;
+    r.reconcile(statement, ledger, 1);
+
+    ASSERT_EQ(1u, r.matches().size());
+    ASSERT_EQ(ReconciliationMatch::eMatchDateWindow, r.matches()[0].kind);
+    ASSERT_EQ(11, r.matches()[0].ledger[0]);
+    ASSERT_EQ(std::vector<long long>({ 2 }), r.unmatchedStatement());
+    ASSERT_EQ(std::vector<long long>({ 10, 12 }), r.unmatchedLedger());
+}
+
+// Test case: a batched deposit against its receipts, and a payment cleared
+// in two parts.
+TEST(Reconciliation_tests, splits)
+{
+    std::vector<CashLine> statement = {
+        line(1, JAN1 + 1, 350.25, "DEPOSIT"),
+        line(2, JAN1 + 5, -60),
+        line(3, JAN1 + 6, -40),
+    };
+    std::vector<CashLine> ledger = {
+        line(10, JAN1, 100),
+        line(11, JAN1, 200.2),
+        line(12, JAN1, 999),
+        line(13, JAN1, 50.05),
+        line(14, JAN1 + 5, -100),
+    };
+
+    Reconciliation r;
+    r.reconcile(statement, ledger, 1);
+
+    ASSERT_EQ(2u, r.count(ReconciliationMatch::eMatchSplit));
+    ASSERT_EQ(std::vector<long long>({ 1 }), r.matches()[0].statement);
+    ASSERT_EQ(std::vector<long long>({ 10, 11, 13 }), r.matches()[0].ledger);
+    ASSERT_EQ(std::vector<long long>({ 2, 3 }), r.matches()[1].statement);
+    ASSERT_EQ(std::vector<long long>({ 14 }), r.matches()[1].ledger);
+    ASSERT_TRUE(r.unmatchedStatement().empty());
+    ASSERT_EQ(std::vector<long long>({ 12 }), r.unmatchedLedger());
+}
+
+TEST(Reconciliation_tests, split_parts_bounded)
+{
+    std::vector<CashLine> statement = { line(1, JAN1, 40) };
+    std::vector<CashLine> ledger = { line(10, JAN1, 10), line(11, JAN1, 10), line(12, JAN1, 10), line(13, JAN1, 10) };
+
+    Reconciliation r;
+    r.reconcile(statement, ledger, 1);
+    ASSERT_TRUE(r.matches().empty());
+
+    ReconciliationOptions options;
+    options.max_split_parts = 4;
+    Reconciliation four(options);
+    four.reconcile(statement, ledger, 1);
+    ASSERT_EQ(1u, four.count(ReconciliationMatch::eMatchSplit));
+}
+
+// Test case: a year of high volume statements reconciles in seconds, and
+// the same way on any number of threads.
+TEST(Reconciliation_tests, high_volume_year)
+{
+    std::vector<CashLine> statement, ledger;
+    year(500, statement, ledger);
+
+    Reconciliation serial;
+    serial.reconcile(statement, ledger, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    Reconciliation parallel;
+    parallel.reconcile(statement, ledger, 4);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(parallel.unmatchedStatement().empty());
+    ASSERT_TRUE(parallel.unmatchedLedger().empty());
+    std::size_t sameDay = 0;
+    for (std::size_t i = 0; i < statement.size(); ++i)
+        sameDay += statement[i].date == ledger[i].date && statement[i].reference != "X";
+    ASSERT_EQ(sameDay, parallel.count(ReconciliationMatch::eMatchExact));
+    // Timing is reported, not asserted; it depends on the machine.
+    RecordProperty("parallel_ms", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+
+    ASSERT_EQ(serial.matches().size(), parallel.matches().size());
+    for (std::size_t i = 0; i < serial.matches().size(); ++i)
+    {
+        ASSERT_EQ(serial.matches()[i].kind, parallel.matches()[i].kind);
+        ASSERT_EQ(serial.matches()[i].statement, parallel.matches()[i].statement);
+        ASSERT_EQ(serial.matches()[i].ledger, parallel.matches()[i].ledger);
+    }
+}
+
+TEST(Reconciliation_tests, read_statement)
+{
+    std::istringstream csv("date,amount,reference\r\n"
+                           "2020-01-02,-12.34,\"CHK 1001\"\r\n"
+                           "\n"
+                           "2020-01-03, 500\n");
+
+    std::vector<CashLine> statement = readStatement(csv);
+    ASSERT_EQ(2u, statement.size());
+    ASSERT_EQ(2, statement[0].id);
+    ASSERT_EQ(toDays(2020, 1, 2), statement[0].date);
+    ASSERT_DOUBLE_EQ(-12.34, statement[0].amount);
+    ASSERT_EQ("CHK 1001", statement[0].reference);
+    ASSERT_EQ(4, statement[1].id);
+    ASSERT_DOUBLE_EQ(500, statement[1].amount);
+    ASSERT_EQ("", statement[1].reference);
+
+    std::istringstream bad("2020-01-02,12\n2020-01-03,abc\n");
+    ASSERT_THROW(readStatement(bad), std::invalid_argument);
+}
@@ -0,0 +1,103 @@
+/**
+ * \file RetroAdjustment_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/payroll/RetroAdjustment.h"
+#include <gtest/gtest.h>
+
+using namespace accounting::payroll;
+
+namespace
+{
+    //! Issue a year of monthly paychecks at a fixed gross wage.
+    void issue(std::vector<Paycheck> &history, long long employee, double gross)
+    {
+        PayrollTaxes taxes;
+        YearToDate ytd;
+        for (int period = 0; period < 12; ++period)
+        {
+            Paycheck check = Paycheck();
+            check.employee_id = employee;
+            check.year = 2020;
+            check.month = period + 1;
+            check.period = period;
+            check.gross_wages = gross;
+            taxes.calculate(check, ytd);
+            history.push_back(check);
+        }
+    }
+}
+
+// Test case: unknown employee or a period past the last check changes nothing.
+TEST(RetroAdjustment_tests, nothing_dirty)
+{
+    std::vector<Paycheck> history;
+    issue(history, 1, 5000);
+
+    RetroAdjustment retro;
+    retro.load(history);
+
+    ASSERT_TRUE(retro.apply(PayChange{ 2, 0, 6000 }).empty());
+    ASSERT_TRUE(retro.apply(PayChange{ 1, 12, 6000 }).empty());
+    ASSERT_EQ(nullptr, retro.paychecks(2));
+}
+
+// Test case: a raise from July on; only the suffix gets deltas.
+TEST(RetroAdjustment_tests, raise_dirties_suffix)
+{
+    std::vector<Paycheck> history;
+    issue(history, 1, 5000);
+    issue(history, 2, 5000);
+
+    RetroAdjustment retro;
+    retro.load(history);
+
+    std::vector<PayrollDelta> deltas = retro.apply(PayChange{ 1, 6, 6000 });
+    ASSERT_EQ(6u, deltas.size());
+    for (const PayrollDelta &d : deltas)
+    {
+        ASSERT_EQ(1, d.employee_id);
+        ASSERT_GE(d.period, 6);
+        ASSERT_DOUBLE_EQ(1000, d.gross_wages);
+        ASSERT_NEAR(62, d.oasdi_employee, 1e-9);
+        ASSERT_NEAR(62, d.oasdi_employer, 1e-9);
+        ASSERT_DOUBLE_EQ(0, d.futa_wages);      // FUTA cap was hit in February
+    }
+
+    // The other employee's chain is untouched.
+    ASSERT_DOUBLE_EQ(5000, (*retro.paychecks(2))[11].gross_wages);
+}
+
+// Test case: a raise that pushes the employee over the social security
+// wage limit earlier in the year matches recomputing the year from scratch.
+TEST(RetroAdjustment_tests, matches_full_recompute_across_cap)
+{
+    std::vector<Paycheck> history;
+    issue(history, 1, 11000);
+
+    RetroAdjustment retro;
+    retro.load(history);
+    retro.apply(PayChange{ 1, 4, 15000 });
+    retro.apply(PayChange{ 1, 9, 16000 });
+
+    PayrollTaxes taxes;
+    YearToDate ytd;
+    const std::vector<Paycheck> &checks = *retro.paychecks(1);
+    ASSERT_EQ(12u, checks.size());
+    for (const Paycheck &adjusted : checks)
+    {
+        Paycheck expected = adjusted;
+        expected.gross_wages = adjusted.period < 4 ? 11000 : adjusted.period < 9 ? 15000 : 16000;
+        taxes.calculate(expected, ytd);
+
+        ASSERT_DOUBLE_EQ(expected.gross_wages, adjusted.gross_wages);
+        ASSERT_NEAR(expected.oasdi_wages, adjusted.oasdi_wages, 1e-6);
+        ASSERT_NEAR(expected.oasdi_employee, adjusted.oasdi_employee, 1e-6);
+        ASSERT_NEAR(expected.oasdi_employer, adjusted.oasdi_employer, 1e-6);
+    }
+    ASSERT_NEAR(taxes.oasdi.max_contribution(), ytd.oasdi_employee, 1e-6);
+}
@@ -0,0 +1,91 @@
+/**
+ * \file Revaluation_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/Date.h"
+#include "accounting/ledger/Revaluation.h"
+#include <gtest/gtest.h>
+
+using namespace accounting;
+using namespace accounting::ledger;
+
+namespace
+{
+    const Currency EUR("EUR");
+    const Currency MXN("MXN");
+    const long long FX_GAIN_LOSS = 7900;
+}
+
+TEST(Revaluation_tests, gains_and_losses)
+{
+    const int jun30 = toDays(2021, 6, 30);
+
+    ExchangeRates rates;
+    rates.set(EUR, jun30, 1.19);
+    rates.set(MXN, jun30 - 1, 0.05);
+
+    Revaluation r(FX_GAIN_LOSS);
+    r.add(ForeignBalance{ 1010, EUR, 10000, 12000 });       // cash, loses 100
+    r.add(ForeignBalance{ 2010, EUR, -5000, -6000 });       // payable, gains 50
+    r.add(ForeignBalance{ 1210, MXN, 200000, 10000 });      // unchanged
+
+    JournalEntry entry = r.revalue(rates, jun30);
+
+    ASSERT_DOUBLE_EQ(-100, r.adjustment(0));
+    ASSERT_DOUBLE_EQ(50, r.adjustment(1));
+    ASSERT_DOUBLE_EQ(0, r.adjustment(2));
+    ASSERT_DOUBLE_EQ(-50, r.gain());
+
+    ASSERT_EQ(jun30, entry.date);
+    ASSERT_TRUE(entry.balanced());
+    ASSERT_EQ(3u, entry.lines.size());
+    ASSERT_EQ(1010, entry.lines[0].account_id);
+    ASSERT_EQ(EUR, entry.lines[0].currency);
+    ASSERT_DOUBLE_EQ(0, entry.lines[0].currency_amount);
+    ASSERT_EQ(FX_GAIN_LOSS, entry.lines[2].account_id);
+    ASSERT_DOUBLE_EQ(50, entry.lines[2].amount);
+    ASSERT_EQ(USD, entry.lines[2].currency);
+}
+
+TEST(Revaluation_tests, nothing_moved)
+{
+    ExchangeRates rates;
+    rates.set(EUR, 0, 1.2);
+
+    Revaluation r(FX_GAIN_LOSS);
+    r.add(ForeignBalance{ 1010, EUR, 100, 120 });
+    ASSERT_TRUE(r.revalue(rates, 10).lines.empty());
+
+    Revaluation none(FX_GAIN_LOSS);
+    ASSERT_TRUE(none.revalue(rates, 10).lines.empty());
+}
+
+// Test case: many balances in a few currencies; the entry always balances.
+TEST(Revaluation_tests, many_balances)
+{
+    const int day = toDays(2021, 12, 31);
+    const Currency currencies[] = { EUR, MXN, Currency("JPY"), Currency("CAD") };
+
+    ExchangeRates rates;
+    rates.set(currencies[0], day, 1.13);
+    rates.set(currencies[1], day, 0.049);
+    rates.set(currencies[2], day, 0.0087);
+    rates.set(currencies[3], day, 0.79);
+
+    Revaluation r(FX_GAIN_LOSS);
+    r.reserve(100000);
+    for (int i = 0; i < 100000; ++i)
+        r.add(ForeignBalance{ 10000 + i, currencies[i % 4], 1000.0 + i, 900.0 + i * 0.5 });
+
+    JournalEntry entry = r.revalue(rates, day);
+    ASSERT_TRUE(entry.balanced());
+
+    double total = 0;
+    for (std::size_t i = 0; i < r.size(); ++i)
+        total += r.adjustment(i);
+    ASSERT_NEAR(total, r.gain(), 0.005);
+}
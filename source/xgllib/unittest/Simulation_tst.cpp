@@ -0,0 +1,78 @@
+/**
+ * \file Simulation_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/payroll/Simulation.h"
+#include <gtest/gtest.h>
+
+using namespace accounting::payroll;
+
+namespace
+{
+    std::shared_ptr<const EmployeeStore> roster()
+    {
+        auto r = std::make_shared<EmployeeStore>();
+        r->add(Employee{ 1, 52000, PayPeriod::ePayPeriodWeekly });
+        r->add(Employee{ 2, 60000, PayPeriod::ePayPeriodMonthly });
+        r->add(Employee{ 3, 200000, PayPeriod::ePayPeriodBiweekly });
+        return r;
+    }
+}
+
+// Test case: the baseline scenario pays the roster as is.
+TEST(Simulation_tests, baseline)
+{
+    Simulation sim(roster());
+    ScenarioResult r = sim.evaluate(Scenario());
+
+    ASSERT_EQ(3u, r.headcount);
+    ASSERT_NEAR(312000, r.gross_wages, 1e-6);
+    // 6.2% of the first two salaries, the third is capped.
+    ASSERT_NEAR((52000 + 60000) * 0.062 + 8537.40, r.oasdi_employee, 1e-6);
+    ASSERT_NEAR(r.oasdi_employee, r.oasdi_employer, 1e-6);
+    ASSERT_NEAR(21000, r.futa_wages, 1e-6);
+    ASSERT_NEAR(1260, r.futa_tax, 1e-6);
+}
+
+// Test case: overlays change only what they name.
+TEST(Simulation_tests, overlay)
+{
+    Simulation sim(roster());
+
+    Scenario s;
+    s.raise = 0.10;
+    s.terminations.insert(3);
+    s.changes[2] = Employee{ 2, 70000, PayPeriod::ePayPeriodMonthly };
+    s.hires.push_back(Employee{ 4, 40000, PayPeriod::ePayPeriodSemimonthly });
+
+    ScenarioResult r = sim.evaluate(s);
+    ASSERT_EQ(3u, r.headcount);
+    ASSERT_NEAR(52000 * 1.1 + 70000 * 1.1 + 40000, r.gross_wages, 1e-6);
+}
+
+// Test case: parallel evaluation returns results in scenario order.
+TEST(Simulation_tests, run_parallel)
+{
+    Simulation sim(roster());
+
+    std::vector<Scenario> scenarios(24);
+    for (std::size_t i = 0; i < scenarios.size(); ++i)
+    {
+        scenarios[i].name = std::to_string(i);
+        scenarios[i].raise = i * 0.01;
+    }
+
+    std::vector<ScenarioResult> results = sim.run(scenarios, 4);
+    ASSERT_EQ(scenarios.size(), results.size());
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        ScenarioResult expected = sim.evaluate(scenarios[i]);
+        ASSERT_EQ(scenarios[i].name, results[i].name);
+        ASSERT_DOUBLE_EQ(expected.gross_wages, results[i].gross_wages);
+        ASSERT_DOUBLE_EQ(expected.employerCost(), results[i].employerCost());
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * \file TaxReport_tst.cpp
+ *
+ * This file is part of the Payroll C++ Library
+ *
+ * Copyright (c) 2020 Joe Turner.  All rights reserved.
+ * Unauthorized copying prohibited.
+ */
+#include "accounting/payroll/TaxReport.h"
+#include <gtest/gtest.h>
+
+using namespace accounting::payroll;
+
+namespace
+{
+    Paycheck check(long long employee, int year, int month, double gross)
+    {
+        Paycheck p = Paycheck();
+        p.employee_id = employee;
+        p.year = year;
+        p.month = month;
+        p.period = month - 1;
+        p.gross_wages = gross;
+        p.oasdi_wages = gross;
+        p.oasdi_employee = gross * 0.062;
+        p.oasdi_employer = gross * 0.062;
+        return p;
+    }
+
+    //! A roster paid monthly for a year; employee i earns 1000 * (i % 5 + 1) a month.
+    std::vector<Paycheck> history(int employees)
+    {
+        std::vector<Paycheck> h;
+        for (int month = 1; month <= 12; ++month)
+            for (int e = 0; e < employees; ++e)
+                h.push_back(check(e, 2020, month, 1000.0 * (e % 5 + 1)));
+        return h;
+    }
+}
+
+TEST(TaxReport_tests, quarterly_941_totals)
+{
+    std::vector<Paycheck> h;
+    h.push_back(check(1, 2020, 1, 1000));
+    h.push_back(check(1, 2020, 4, 2000));
+    h.push_back(check(2, 2020, 5, 500));
+    h.push_back(check(2, 2019, 5, 99999));      // wrong year, ignored
+
+    TaxReport r(2020);
+    r.generate(h, 1);
+
+    ASSERT_EQ(1u, r.form941(1).employees);
+    ASSERT_DOUBLE_EQ(1000, r.form941(1).wages);
+    ASSERT_EQ(2u, r.form941(2).employees);
+    ASSERT_DOUBLE_EQ(2500, r.form941(2).wages);
+    ASSERT_DOUBLE_EQ(2500, r.form941(2).social_security_wages);
+    ASSERT_DOUBLE_EQ(2500 * 0.124, r.form941(2).social_security_tax);
+    ASSERT_EQ(0u, r.form941(3).employees);
+}
+
+// Test case: FUTA wage cap applies per employee, in quarter order.
+TEST(TaxReport_tests, annual_940_wage_cap)
+{
+    std::vector<Paycheck> h;
+    h.push_back(check(1, 2020, 2, 5000));
+    h.push_back(check(1, 2020, 5, 5000));       // 2000 over the cap
+    h.push_back(check(2, 2020, 8, 3000));
+
+    TaxReport r(2020);
+    r.generate(h, 1);
+
+    const Form940Summary &f = r.form940();
+    ASSERT_EQ(2u, f.employees);
+    ASSERT_DOUBLE_EQ(13000, f.total_payments);
+    ASSERT_DOUBLE_EQ(3000, f.excess_payments);
+    ASSERT_DOUBLE_EQ(10000, f.taxable_futa_wages);
+    ASSERT_DOUBLE_EQ(600, f.futa_tax);
+    ASSERT_DOUBLE_EQ(300, f.quarterly_liability[0]);
+    ASSERT_DOUBLE_EQ(120, f.quarterly_liability[1]);
+    ASSERT_DOUBLE_EQ(180, f.quarterly_liability[2]);
+    ASSERT_DOUBLE_EQ(0, f.quarterly_liability[3]);
+}
+
+// Test case: the partitioned parallel reduction matches a single thread.
+TEST(TaxReport_tests, parallel_matches_serial)
+{
+    std::vector<Paycheck> h = history(20000);
+
+    TaxReport serial(2020);
+    serial.generate(h, 1);
+    TaxReport parallel(2020);
+    parallel.generate(h, 8);
+
+    for (int q = 1; q <= 4; ++q)
+    {
+        ASSERT_EQ(serial.form941(q).employees, parallel.form941(q).employees);
+        ASSERT_NEAR(serial.form941(q).wages, parallel.form941(q).wages, 0.01);
+        ASSERT_NEAR(serial.form941(q).social_security_tax, parallel.form941(q).social_security_tax, 0.01);
+    }
+    ASSERT_EQ(20000u, parallel.form940().employees);
+    ASSERT_NEAR(serial.form940().excess_payments, parallel.form940().excess_payments, 0.01);
+    ASSERT_NEAR(serial.form940().futa_tax, parallel.form940().futa_tax, 0.01);
+}